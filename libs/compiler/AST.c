@@ -34,6 +34,25 @@ static inline void node_set_child(const node *const parent, const node *const ch
 	node_remove(&temp);
 }
 
+static void node_set_children(const node *const parent, const node_vector *const children, const size_t from)
+{
+	const size_t offset = node_get_amount(parent);
+	const size_t amount = node_vector_size(children);
+	for (size_t i = from; i < amount; i++)
+	{
+		node_add_child(parent, OP_NOP);
+	}
+
+	// Children are moved from the last one, so removed placeholders do not shift the rest of them
+	for (size_t i = amount; i > from; i--)
+	{
+		node child = node_vector_get(children, i - 1);
+		node temp = node_get_child(parent, offset + i - 1 - from);
+		node_swap(&child, &temp);
+		node_remove(&temp);
+	}
+}
+
 
 /*
  *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
@@ -248,12 +267,7 @@ node expression_call(const item_t type, node *const callee, node_vector *const a
 
 	if (node_vector_is_correct(args))
 	{
-		const size_t amount = node_vector_size(args);
-		for (size_t i = 0; i < amount; i++)
-		{
-			node arg = node_vector_get(args, i);
-			node_set_child(&nd, &arg);				// i-ый аргумент вызова
-		}
+		node_set_children(&nd, args, 0);			// Аргументы вызова
 	}
 
 	node_set_arg(&nd, 0, type);						// Тип значения выражения
@@ -478,12 +492,7 @@ node expression_initializer(node_vector *const exprs, const location loc)
 	node_set_arg(&nd, 2, (item_t)loc.begin);		// Начальная позиция выражения
 	node_set_arg(&nd, 3, (item_t)loc.end);			// Конечная позиция выражения
 
-	const size_t amount = node_vector_size(exprs);
-	for (size_t i = 1; i < amount; i++)
-	{
-		node subexpr = node_vector_get(exprs, i);
-		node_set_child(&nd, &subexpr);				// i-ое подвыражение списка
-	}
+	node_set_children(&nd, exprs, 1);				// Подвыражения списка
 
 	return nd;
 }
@@ -514,12 +523,7 @@ node expression_inline(const item_t type, node_vector *const args, const locatio
 	
 	if (node_vector_is_correct(args))
 	{
-		const size_t amount = node_vector_size(args);
-		for (size_t i = 0; i < amount; i++)
-		{
-			node subexpr = node_vector_get(args, i);
-			node_set_child(&nd, &subexpr);				// i-ое подвыражение списка
-		}
+		node_set_children(&nd, args, 0);			// Подвыражения списка
 	}
 
 	node_set_arg(&nd, 0, type);						// Тип значения выражения
@@ -647,12 +651,7 @@ node statement_compound(node *const context, node_vector *const stmts, const loc
 
 	if (node_vector_is_correct(stmts))
 	{
-		const size_t amount = node_vector_size(stmts);
-		for (size_t i = 0; i < amount; i++)
-		{
-			node item = node_vector_get(stmts, i);
-			node_set_child(&nd, &item);
-		}
+		node_set_children(&nd, stmts, 0);
 	}
 
 	return nd;
@@ -210,10 +210,15 @@ static int print_table(const encoder *const enc, const vector *const table)
 			return -1;
 		}
 
-		uni_printf(enc->sx->io, "%" PRIitem " ", item);
+#if ITEM >= 0
+		uni_print_uint(enc->sx->io, (uint64_t)item);
+#else
+		uni_print_int(enc->sx->io, (int64_t)item);
+#endif
+		uni_print_char(enc->sx->io, ' ');
 	}
 
-	uni_printf(enc->sx->io, "\n");
+	uni_print_char(enc->sx->io, '\n');
 	return 0;
 }
 
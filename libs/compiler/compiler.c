@@ -26,6 +26,7 @@
 #include "uniio.h"
 
 #ifndef _WIN32
+	#include <pthread.h>
 	#include <sys/stat.h>
 	#include <sys/types.h>
 #endif
@@ -40,6 +41,14 @@ static const char *const DEFAULT_MIPS = "out.s";
 
 typedef int (*encoder)(const workspace *const ws, syntax *const sx);
 
+/** Preprocessing, which runs on its own thread */
+typedef struct macro_task
+{
+	workspace *ws;				/**< Workspace */
+	channel *ch;				/**< Channel of preprocessed text */
+	comment_map *cmts;			/**< Comments of preprocessed text */
+} macro_task;
+
 
 /** Make executable actually executable on best-effort basis (if possible) */
 static inline void make_executable(const char *const path)
@@ -75,8 +84,54 @@ static inline bool skip_linker(const workspace *const ws)
 	}
 }
 
+/** Lex whole input before parsing */
+static inline bool pretokenize(const workspace *const ws)
+{
+	for (size_t i = 0; ; i++)
+	{
+		const char *flag = ws_get_flag(ws, i);
+		if (flag == NULL)
+		{
+			return false;
+		}
+		else if (strcmp(flag, "--pretokenize") == 0)
+		{
+			return true;
+		}
+	}
+}
+
+/** Preprocess concurrently with parsing */
+static inline bool pipeline(const workspace *const ws)
+{
+	for (size_t i = 0; ; i++)
+	{
+		const char *flag = ws_get_flag(ws, i);
+		if (flag == NULL)
+		{
+			return false;
+		}
+		else if (strcmp(flag, "-pipe") == 0)
+		{
+			return true;
+		}
+	}
+}
+
+
+static status_t compile_from_syntax(const workspace *const ws, syntax *const sx, const encoder enc)
+{
+	if (!skip_linker(ws) && !sx_is_correct(sx))
+	{
+		return sts_link_error;
+	}
+
+	return enc(ws, sx) ? sts_codegen_error : sts_success;
+}
+
 
-static status_t compile_from_io(const workspace *const ws, universal_io *const io, const encoder enc)
+static status_t compile_from_io(const workspace *const ws, universal_io *const io, const comment_map *const cmts
+	, const encoder enc)
 {
 	if (!in_is_correct(io) || !out_is_correct(io))
 	{
@@ -85,26 +140,67 @@ static status_t compile_from_io(const workspace *const ws, universal_io *const i
 		return sts_system_error;
 	}
 
-	syntax sx = sx_create(ws, io);
-	int ret = parse(&sx);
-	status_t sts = sts_parse_error;
+	syntax sx = sx_create(ws, io, cmts);
+	const int ret = pretokenize(ws) ? parse_tokenized(&sx) : parse(&sx);
+	const status_t sts = ret ? sts_parse_error : compile_from_syntax(ws, &sx, enc);
 
-	if (!ret && !skip_linker(ws))
+	sx_clear(&sx);
+	io_erase(io);
+	return sts;
+}
+
+#ifndef _WIN32
+static void *preprocess(void *const arg)
+{
+	macro_task *const task = arg;
+	macro_to_channel(task->ws, task->ch, task->cmts);
+	return NULL;
+}
+
+static status_t compile_from_channel(workspace *const ws, channel *const ch, comment_map *const cmts
+	, const encoder enc)
+{
+	universal_io io = io_create();
+	in_set_channel(&io, ch);
+
+	// Препроцессор добавляет файлы в рабочее пространство, поэтому оно читается до запуска и после завершения потока
+	syntax sx = sx_create(ws, &io, cmts);
+	const bool is_tokenized = pretokenize(ws);
+
+	macro_task task = { ws, ch, cmts };
+	pthread_t thread;
+	if (pthread_create(&thread, NULL, &preprocess, &task))
 	{
-		ret = !sx_is_correct(&sx);
-		sts = sts_link_error;
+		error_msg("некорректные параметры ввода/вывода");
+		sx_clear(&sx);
+		io_erase(&io);
+		return sts_system_error;
 	}
 
-	if (!ret)
+	// Разбор может закончиться раньше текста, поэтому остаток принимается, чтобы препроцессор не ждал
+	const int ret = is_tokenized ? parse_tokenized(&sx) : parse(&sx);
+	const int ret_macro = channel_wait(ch);
+	pthread_join(thread, NULL);
+
+	status_t sts = sts_macro_error;
+	if (!ret_macro)
 	{
-		ret = enc(ws, &sx);
-		sts = sts_codegen_error;
+		if (out_set_file(&io, ws_get_output(ws)))
+		{
+			error_msg("некорректные параметры ввода/вывода");
+			sts = sts_system_error;
+		}
+		else
+		{
+			sts = ret ? sts_parse_error : compile_from_syntax(ws, &sx, enc);
+		}
 	}
 
 	sx_clear(&sx);
-	io_erase(io);
-	return ret ? sts : sts_success;
+	io_erase(&io);
+	return sts;
 }
+#endif
 
 static status_t compile_from_ws(workspace *const ws, const encoder enc)
 {
@@ -114,17 +210,38 @@ static status_t compile_from_ws(workspace *const ws, const encoder enc)
 		return sts_system_error;
 	}
 
+#if !defined(GENERATE_MACRO) && !defined(_WIN32)
+	// Препроцессинг в отдельном потоке, текст передаётся по частям через канал
+	if (pipeline(ws))
+	{
+		comment_map cmts = cmt_map_create();
+		channel *const ch = channel_create(&cmts);
+		if (ch != NULL)
+		{
+			const status_t sts = compile_from_channel(ws, ch, &cmts, enc);
+			channel_clear(ch);
+			cmt_map_clear(&cmts);
+			return sts;
+		}
+
+		cmt_map_clear(&cmts);
+	}
+#endif
+
 	universal_io io = io_create();
 
 #ifndef GENERATE_MACRO
-	// Препроцессинг в массив
-	char *const preprocessing = macro(ws); // макрогенерация
+	// Препроцессинг в массив, комментарии о строках хранятся отдельно
+	comment_map cmts = cmt_map_create();
+	char *const preprocessing = macro_with_comments(ws, &cmts); // макрогенерация
 	if (preprocessing == NULL)
 	{
+		cmt_map_clear(&cmts);
 		return sts_macro_error;
 	}
 
 	in_set_buffer(&io, preprocessing);
+	const comment_map *const comments = &cmts;
 #else
 	int ret_macro = macro_to_file(ws, DEFAULT_MACRO);
 	if (ret_macro)
@@ -133,13 +250,15 @@ static status_t compile_from_ws(workspace *const ws, const encoder enc)
 	}
 
 	in_set_file(&io, DEFAULT_MACRO);
+	const comment_map *const comments = NULL;
 #endif
 
 	out_set_file(&io, ws_get_output(ws));
-	const status_t sts = compile_from_io(ws, &io, enc);
+	const status_t sts = compile_from_io(ws, &io, comments, enc);
 
 #ifndef GENERATE_MACRO
 	free(preprocessing);
+	cmt_map_clear(&cmts);
 #endif
 	return sts;
 }
@@ -235,7 +354,7 @@ int no_macro_compile_to_vm(const char *const path)
 	ws_set_output(&ws, DEFAULT_VM);
 	out_set_file(&io, ws_get_output(&ws));
 
-	const int ret = compile_from_io(&ws, &io, &encode_to_vm);
+	const int ret = compile_from_io(&ws, &io, NULL, &encode_to_vm);
 	if (!ret)
 	{
 		make_executable(ws_get_output(&ws));
@@ -255,7 +374,7 @@ int no_macro_compile_to_llvm(const char *const path)
 	ws_set_output(&ws, DEFAULT_LLVM);
 	out_set_file(&io, ws_get_output(&ws));
 
-	const int ret = compile_from_io(&ws, &io, &encode_to_llvm);
+	const int ret = compile_from_io(&ws, &io, NULL, &encode_to_llvm);
 	ws_clear(&ws);
 	return ret;
 }
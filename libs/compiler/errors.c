@@ -422,12 +422,19 @@ static void get_warning(const warning_t num, char *const msg, va_list args)
 }
 
 
-static void output(const universal_io *const io, const char *const msg, const logger system_func
+static void output(const universal_io *const io, const comment_map *const cmts, const char *const msg
+	, const logger system_func
 	, void (*func)(const char *const, const char *const, const char *const, const size_t))
 {
 	char tag[MAX_TAG_SIZE] = TAG_RUC;
 
 	const char *code = in_get_buffer(io);
+	if (code == NULL && in_is_channel(io))
+	{
+		// Preprocessing of input channel is failed, so its errors are already reported
+		return;
+	}
+
 	if (code == NULL)
 	{
 		in_get_path(io, tag);
@@ -443,7 +450,7 @@ static void output(const universal_io *const io, const char *const msg, const lo
 		position--;
 	}
 
-	comment cmt = cmt_search(code, position);
+	comment cmt = cmts != NULL ? cmt_map_search(cmts, code, position) : cmt_search(code, position);
 	cmt_get_tag(&cmt, tag);
 
 	char line[MAX_LINE_SIZE];
@@ -462,39 +469,39 @@ static void output(const universal_io *const io, const char *const msg, const lo
  */
 
 
-void error(const universal_io *const io, err_t num, ...)
+void error(const universal_io *const io, const comment_map *const cmts, err_t num, ...)
 {
 	va_list args;
 	va_start(args, num);
 
-	verror(io, num, args);
+	verror(io, cmts, num, args);
 
 	va_end(args);
 }
 
-void warning(const universal_io *const io, warning_t num, ...)
+void warning(const universal_io *const io, const comment_map *const cmts, warning_t num, ...)
 {
 	va_list args;
 	va_start(args, num);
 
-	vwarning(io, num, args);
+	vwarning(io, cmts, num, args);
 
 	va_end(args);
 }
 
 
-void verror(const universal_io *const io, const err_t num, va_list args)
+void verror(const universal_io *const io, const comment_map *const cmts, const err_t num, va_list args)
 {
 	char msg[MAX_MSG_SIZE];
 	get_error(num, msg, args);
-	output(io, msg, &log_system_error, &log_error);
+	output(io, cmts, msg, &log_system_error, &log_error);
 }
 
-void vwarning(const universal_io *const io, const warning_t num, va_list args)
+void vwarning(const universal_io *const io, const comment_map *const cmts, const warning_t num, va_list args)
 {
 	char msg[MAX_MSG_SIZE];
 	get_warning(num, msg, args);
-	output(io, msg, &log_system_warning, &log_warning);
+	output(io, cmts, msg, &log_system_warning, &log_warning);
 }
 
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "commenter.h"
 #include "uniio.h"
 
 
@@ -163,36 +164,40 @@ typedef enum WARNING
  *	Emit an error for some problem
  *
  *	@param	io			Universal io
+ *	@param	cmts		Comments of input, @c NULL if they are in input
  *	@param	num			Error number
  */
-void error(const universal_io *const io, err_t num, ...);
+void error(const universal_io *const io, const comment_map *const cmts, err_t num, ...);
 
 /**
  *	Emit a warning for some problem
  *
  *	@param	io			Universal io
+ *	@param	cmts		Comments of input, @c NULL if they are in input
  *	@param	num			Warning number
  */
-void warning(const universal_io *const io, warning_t num, ...);
+void warning(const universal_io *const io, const comment_map *const cmts, warning_t num, ...);
 
 
 /**
  *	Emit an error (embedded version)
  *
  *	@param	io			Universal io
+ *	@param	cmts		Comments of input, @c NULL if they are in input
  *	@param	num			Error number
  *	@param	args		Variable list
  */
-void verror(const universal_io *const io, const err_t num, va_list args);
+void verror(const universal_io *const io, const comment_map *const cmts, const err_t num, va_list args);
 
 /**
  *	Emit a warning (embedded version)
  *
  *	@param	io			Universal io
+ *	@param	cmts		Comments of input, @c NULL if they are in input
  *	@param	num			Warning number
  *	@param	args		Variable list
  */
-void vwarning(const universal_io *const io, const warning_t num, va_list args);
+void vwarning(const universal_io *const io, const comment_map *const cmts, const warning_t num, va_list args);
 
 
 /**
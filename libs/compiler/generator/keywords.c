@@ -0,0 +1,264 @@
+/*
+ *	Copyright 2024 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+/*
+ *	Build-time generator of perfect hash table for keywords from keywords.h
+ *
+ *	Spellings are distributed between buckets by keyword_hash with zero seed.
+ *	For every bucket, starting from the largest one, the seed is searched,
+ *	which puts all its spellings to free slots of the table.
+ *	So lexer needs two hash calculations and one comparison to classify a word.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "keywords.h"
+#include "utf8.h"
+
+
+#define KEYWORDS_BUCKETS	64
+#define KEYWORDS_TABLE_SIZE	256
+#define MAX_SPELLING_SIZE	64
+#define MAX_SEED			(1u << 24)
+
+
+typedef struct spelling
+{
+	char bytes[MAX_SPELLING_SIZE];	/**< UTF-8 spelling */
+	size_t size;					/**< Size of spelling in bytes */
+	const char *token;				/**< Name of keyword token */
+} spelling;
+
+typedef struct bucket
+{
+	size_t spellings[KEYWORDS_TABLE_SIZE];	/**< Indices of bucket spellings */
+	size_t size;							/**< Number of bucket spellings */
+	uint32_t seed;							/**< Seed of bucket */
+} bucket;
+
+
+static spelling spellings[KEYWORDS_TABLE_SIZE];
+static size_t spellings_size = 0;
+
+static bucket buckets[KEYWORDS_BUCKETS];
+static size_t table[KEYWORDS_TABLE_SIZE];
+
+
+static void add_spelling(const char32_t *const word, const bool upper, const char *const token)
+{
+	if (spellings_size == KEYWORDS_TABLE_SIZE)
+	{
+		fprintf(stderr, "keywords: too many keywords\n");
+		exit(EXIT_FAILURE);
+	}
+
+	spelling *const sp = &spellings[spellings_size];
+	sp->size = 0;
+	sp->token = token;
+	for (size_t i = 0; word[i] != '\0'; i++)
+	{
+		sp->size += utf8_to_string(&sp->bytes[sp->size], upper ? utf8_to_upper(word[i]) : word[i]);
+	}
+
+	for (size_t i = 0; i < spellings_size; i++)
+	{
+		if (spellings[i].size == sp->size && memcmp(spellings[i].bytes, sp->bytes, sp->size) == 0)
+		{
+			fprintf(stderr, "keywords: duplicate spelling \"%.*s\"\n", (int)sp->size, sp->bytes);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	spellings_size++;
+}
+
+static void add_keyword(const char32_t *const eng, const char32_t *const rus, const token_t token
+	, const char *const name)
+{
+	// Ключевые слова с неотрицательным значением лексер считает идентификаторами
+	if (token >= 0)
+	{
+		return;
+	}
+
+	add_spelling(eng, false, name);
+	add_spelling(eng, true, name);
+	add_spelling(rus, false, name);
+	add_spelling(rus, true, name);
+}
+
+static bool try_seed(const bucket *const bk, const uint32_t seed)
+{
+	size_t slots[KEYWORDS_TABLE_SIZE];
+	for (size_t i = 0; i < bk->size; i++)
+	{
+		const spelling *const sp = &spellings[bk->spellings[i]];
+		slots[i] = keyword_hash(seed, sp->bytes, sp->size) % KEYWORDS_TABLE_SIZE;
+
+		if (table[slots[i]] != SIZE_MAX)
+		{
+			return false;
+		}
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (slots[j] == slots[i])
+			{
+				return false;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < bk->size; i++)
+	{
+		table[slots[i]] = bk->spellings[i];
+	}
+
+	return true;
+}
+
+static int compare_buckets(const void *const first, const void *const second)
+{
+	const size_t first_size = buckets[*(const size_t *)first].size;
+	const size_t second_size = buckets[*(const size_t *)second].size;
+	return first_size < second_size ? 1 : first_size > second_size ? -1 : 0;
+}
+
+static void build_table(void)
+{
+	for (size_t i = 0; i < KEYWORDS_TABLE_SIZE; i++)
+	{
+		table[i] = SIZE_MAX;
+	}
+
+	size_t order[KEYWORDS_BUCKETS];
+	for (size_t i = 0; i < KEYWORDS_BUCKETS; i++)
+	{
+		order[i] = i;
+	}
+
+	for (size_t i = 0; i < spellings_size; i++)
+	{
+		bucket *const bk = &buckets[keyword_hash(0, spellings[i].bytes, spellings[i].size) % KEYWORDS_BUCKETS];
+		bk->spellings[bk->size++] = i;
+	}
+
+	qsort(order, KEYWORDS_BUCKETS, sizeof(size_t), &compare_buckets);
+	for (size_t i = 0; i < KEYWORDS_BUCKETS && buckets[order[i]].size != 0; i++)
+	{
+		bucket *const bk = &buckets[order[i]];
+		for (bk->seed = 1; !try_seed(bk, bk->seed); bk->seed++)
+		{
+			if (bk->seed == MAX_SEED)
+			{
+				fprintf(stderr, "keywords: failed to build perfect hash table\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+	}
+}
+
+static void print_spelling(FILE *const file, const spelling *const sp)
+{
+	bool escaped = false;
+	fputc('"', file);
+	for (size_t i = 0; i < sp->size; i++)
+	{
+		const unsigned char byte = (unsigned char)sp->bytes[i];
+		if (byte >= 0x80)
+		{
+			fprintf(file, "\\x%02x", byte);
+			escaped = true;
+			continue;
+		}
+
+		if (escaped && utf8_is_hexa_digit(byte))
+		{
+			// Иначе символ продолжит шестнадцатеричную escape-последовательность
+			fputs("\" \"", file);
+		}
+		fputc(byte, file);
+		escaped = false;
+	}
+	fputc('"', file);
+}
+
+static int print_table(const char *const path)
+{
+	FILE *const file = fopen(path, "w");
+	if (file == NULL)
+	{
+		fprintf(stderr, "keywords: failed to open \"%s\"\n", path);
+		return EXIT_FAILURE;
+	}
+
+	size_t max_size = 0;
+	for (size_t i = 0; i < spellings_size; i++)
+	{
+		max_size = spellings[i].size > max_size ? spellings[i].size : max_size;
+	}
+
+	fprintf(file, "/* Generated from keywords.h by keywords generator, do not edit */\n\n");
+	fprintf(file, "#pragma once\n\n#include \"keywords.h\"\n\n\n");
+	fprintf(file, "#define KEYWORDS_MAX_SIZE %zu\n", max_size);
+	fprintf(file, "#define KEYWORDS_BUCKETS %d\n", KEYWORDS_BUCKETS);
+	fprintf(file, "#define KEYWORDS_TABLE_SIZE %d\n\n\n", KEYWORDS_TABLE_SIZE);
+
+	fprintf(file, "static const uint32_t keywords_seeds[KEYWORDS_BUCKETS] =\n{\n");
+	for (size_t i = 0; i < KEYWORDS_BUCKETS; i++)
+	{
+		fprintf(file, "\t%" PRIu32 "u,\n", buckets[i].seed);
+	}
+	fprintf(file, "};\n\n");
+
+	fprintf(file, "static const keyword keywords_table[KEYWORDS_TABLE_SIZE] =\n{\n");
+	for (size_t i = 0; i < KEYWORDS_TABLE_SIZE; i++)
+	{
+		if (table[i] == SIZE_MAX)
+		{
+			fprintf(file, "\t{ \"\", 0, TK_EOF },\n");
+			continue;
+		}
+
+		const spelling *const sp = &spellings[table[i]];
+		fprintf(file, "\t{ ");
+		print_spelling(file, sp);
+		fprintf(file, ", %zu, %s },\n", sp->size, sp->token);
+	}
+	fprintf(file, "};\n");
+
+	return fclose(file) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int main(int argc, const char *argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <output header>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+#define KEYWORD(eng, rus, token) add_keyword(eng, rus, token, #token);
+	KEYWORDS(KEYWORD)
+#undef KEYWORD
+
+	build_table();
+	return print_table(argv[1]);
+}
@@ -0,0 +1,226 @@
+/*
+ *	Copyright 2026 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+/*
+ *	Build-time generator of 128-bit powers of five for conversion of floating literals
+ *
+ *	Every power 5^q is scaled by power of two, so that the most significant bit is set.
+ *	Non-negative powers are truncated, negative ones are reciprocals rounded up,
+ *	as Eisel-Lemire algorithm requires.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#define POWERS_MIN_EXPONENT	-342
+#define POWERS_MAX_EXPONENT	308
+#define NUMBER_SIZE			64
+#define EXACT_EXPONENT		-27
+
+
+/** Unsigned big number, limbs are stored from the least significant one */
+typedef struct number
+{
+	uint32_t limbs[NUMBER_SIZE];	/**< Limbs of number */
+} number;
+
+
+static void number_set(number *const nm, const uint32_t value)
+{
+	for (size_t i = 0; i < NUMBER_SIZE; i++)
+	{
+		nm->limbs[i] = 0;
+	}
+	nm->limbs[0] = value;
+}
+
+static size_t number_bits(const number *const nm)
+{
+	for (size_t i = NUMBER_SIZE; i > 0; i--)
+	{
+		for (size_t j = 32; j > 0; j--)
+		{
+			if ((nm->limbs[i - 1] >> (j - 1)) & 1)
+			{
+				return (i - 1) * 32 + j;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static void number_multiply(number *const nm, const uint32_t factor)
+{
+	uint64_t carry = 0;
+	for (size_t i = 0; i < NUMBER_SIZE; i++)
+	{
+		carry += (uint64_t)nm->limbs[i] * factor;
+		nm->limbs[i] = (uint32_t)carry;
+		carry >>= 32;
+	}
+
+	if (carry != 0)
+	{
+		fprintf(stderr, "powers: number overflow\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void number_shift(number *const nm, const size_t bits, const bool is_left)
+{
+	for (size_t i = 0; i < bits; i++)
+	{
+		if (is_left)
+		{
+			number_multiply(nm, 2);
+			continue;
+		}
+
+		for (size_t j = 0; j < NUMBER_SIZE; j++)
+		{
+			const uint32_t next = j + 1 < NUMBER_SIZE ? nm->limbs[j + 1] : 0;
+			nm->limbs[j] = (nm->limbs[j] >> 1) | (next << 31);
+		}
+	}
+}
+
+static bool number_is_less(const number *const first, const number *const second)
+{
+	for (size_t i = NUMBER_SIZE; i > 0; i--)
+	{
+		if (first->limbs[i - 1] != second->limbs[i - 1])
+		{
+			return first->limbs[i - 1] < second->limbs[i - 1];
+		}
+	}
+
+	return false;
+}
+
+static void number_subtract(number *const nm, const number *const subtrahend)
+{
+	uint64_t borrow = 0;
+	for (size_t i = 0; i < NUMBER_SIZE; i++)
+	{
+		const uint64_t difference = (uint64_t)nm->limbs[i] - subtrahend->limbs[i] - borrow;
+		nm->limbs[i] = (uint32_t)difference;
+		borrow = difference >> 63;
+	}
+}
+
+static void number_increment(number *const nm)
+{
+	for (size_t i = 0; i < NUMBER_SIZE && ++nm->limbs[i] == 0; i++)
+	{
+		continue;
+	}
+}
+
+/** Calculate 2^power / divisor rounded down by long division */
+static void number_reciprocal(number *const quotient, const size_t power, const number *const divisor)
+{
+	if (power >= NUMBER_SIZE * 32)
+	{
+		fprintf(stderr, "powers: number overflow\n");
+		exit(EXIT_FAILURE);
+	}
+
+	number remainder;
+	number_set(&remainder, 0);
+	number_set(quotient, 0);
+	for (size_t i = power + 1; i > 0; i--)
+	{
+		number_multiply(&remainder, 2);
+		remainder.limbs[0] |= i - 1 == power ? 1 : 0;
+
+		if (!number_is_less(&remainder, divisor))
+		{
+			number_subtract(&remainder, divisor);
+			quotient->limbs[(i - 1) / 32] |= (uint32_t)1 << ((i - 1) % 32);
+		}
+	}
+}
+
+static void number_normalize(number *const nm)
+{
+	const size_t bits = number_bits(nm);
+	number_shift(nm, bits < 128 ? 128 - bits : bits - 128, bits < 128);
+}
+
+static void print_number(FILE *const file, const number *const nm)
+{
+	const uint64_t high = (uint64_t)nm->limbs[3] << 32 | nm->limbs[2];
+	const uint64_t low = (uint64_t)nm->limbs[1] << 32 | nm->limbs[0];
+	fprintf(file, "\t{ 0x%016" PRIx64 "u, 0x%016" PRIx64 "u },\n", high, low);
+}
+
+static int print_table(const char *const path)
+{
+	FILE *const file = fopen(path, "w");
+	if (file == NULL)
+	{
+		fprintf(stderr, "powers: failed to open \"%s\"\n", path);
+		return EXIT_FAILURE;
+	}
+
+	fprintf(file, "/* Generated by powers generator, do not edit */\n\n");
+	fprintf(file, "#pragma once\n\n#include <stdint.h>\n\n\n");
+	fprintf(file, "#define POWERS_MIN_EXPONENT %d\n", POWERS_MIN_EXPONENT);
+	fprintf(file, "#define POWERS_MAX_EXPONENT %d\n\n\n", POWERS_MAX_EXPONENT);
+
+	fprintf(file, "static const uint64_t powers_table[POWERS_MAX_EXPONENT - POWERS_MIN_EXPONENT + 1][2] =\n{\n");
+	for (int q = POWERS_MIN_EXPONENT; q <= POWERS_MAX_EXPONENT; q++)
+	{
+		number power;
+		number_set(&power, 1);
+		for (int i = 0; i < (q < 0 ? -q : q); i++)
+		{
+			number_multiply(&power, 5);
+		}
+
+		if (q < 0)
+		{
+			// Степень пяти не является степенью двойки, поэтому 2^bits > 5^-q
+			const size_t bits = number_bits(&power);
+			number reciprocal;
+			number_reciprocal(&reciprocal, q >= EXACT_EXPONENT ? bits + 127 : 2 * bits + 128, &power);
+			number_increment(&reciprocal);
+			power = reciprocal;
+		}
+
+		number_normalize(&power);
+		print_number(file, &power);
+	}
+	fprintf(file, "};\n");
+
+	return fclose(file) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int main(int argc, const char *argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <output header>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	return print_table(argv[1]);
+}
@@ -0,0 +1,97 @@
+/*
+ *	Copyright 2024 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "token.h"
+
+
+/**
+ *	List of keywords in English and Russian
+ *	@note	Each keyword is also recognized in upper case.
+ *			The order of keywords defines their representations in syntax structure.
+ *			Keywords table for lexer is generated from this list during build.
+ */
+#define KEYWORDS(KEYWORD) \
+	KEYWORD(U"main", U"главная", TK_MAIN) \
+	KEYWORD(U"char", U"литера", TK_CHAR) \
+	KEYWORD(U"double", U"двойной", TK_DOUBLE) \
+	KEYWORD(U"float", U"вещ", TK_FLOAT) \
+	KEYWORD(U"int", U"цел", TK_INT) \
+	KEYWORD(U"long", U"длин", TK_LONG) \
+	KEYWORD(U"struct", U"структура", TK_STRUCT) \
+	KEYWORD(U"enum", U"перечисление", TK_ENUM) \
+	KEYWORD(U"void", U"пусто", TK_VOID) \
+	KEYWORD(U"file", U"файл", TK_FILE) \
+	KEYWORD(U"typedef", U"типопр", TK_TYPEDEF) \
+	KEYWORD(U"if", U"если", TK_IF) \
+	KEYWORD(U"else", U"иначе", TK_ELSE) \
+	KEYWORD(U"do", U"цикл", TK_DO) \
+	KEYWORD(U"while", U"пока", TK_WHILE) \
+	KEYWORD(U"for", U"для", TK_FOR) \
+	KEYWORD(U"switch", U"выбор", TK_SWITCH) \
+	KEYWORD(U"case", U"случай", TK_CASE) \
+	KEYWORD(U"default", U"умолчание", TK_DEFAULT) \
+	KEYWORD(U"break", U"выход", TK_BREAK) \
+	KEYWORD(U"continue", U"продолжить", TK_CONTINUE) \
+	KEYWORD(U"return", U"возврат", TK_RETURN) \
+	KEYWORD(U"null", U"ничто", TK_NULL) \
+	KEYWORD(U"abs", U"абс", TK_ABS) \
+	KEYWORD(U"upb", U"кол_во", TK_UPB) \
+	KEYWORD(U"bool", U"булево", TK_BOOL) \
+	KEYWORD(U"true", U"истина", TK_TRUE) \
+	KEYWORD(U"false", U"ложь", TK_FALSE)
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Record of generated keywords table */
+typedef struct keyword
+{
+	const char *spelling;		/**< UTF-8 spelling */
+	size_t size;				/**< Size of spelling in bytes */
+	token_t token;				/**< Keyword token */
+} keyword;
+
+
+/**
+ *	Get hash of keyword spelling
+ *
+ *	@param	seed		Hash seed
+ *	@param	spelling	UTF-8 spelling
+ *	@param	size		Size of spelling in bytes
+ *
+ *	@return	Hash value
+ */
+static inline uint32_t keyword_hash(const uint32_t seed, const char *const spelling, const size_t size)
+{
+	// FNV-1a with seeded offset basis
+	uint32_t hash = 2166136261u ^ (seed * 2654435761u);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ (uint8_t)spelling[i]) * 16777619u;
+	}
+
+	return hash ^ (hash >> 15);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
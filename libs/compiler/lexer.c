@@ -15,20 +15,34 @@
  */
 
 #include "lexer.h"
+#include <inttypes.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "keywords_table.h"
+#include "powers_table.h"
 #include "uniscanner.h"
 
 
+static const size_t TOKEN_STREAM_SIZE = 4096;
+static const size_t TOKEN_NOTES_SIZE = 16;
+static const size_t MAX_DECIMAL_DIGITS = 19;
+static const int64_t MAX_DECIMAL_EXPONENT = 100000;
+
+/** Number of digits after mantissa, which are enough to round any double correctly */
+#define MAX_DECIMAL_TAIL 769
+
+
 /**
- *	Emit an error from lexer
+ *	Report an error from lexer
  *
  *	@param	lxr			Lexer
+ *	@param	position	Position of error
  *	@param	num			Error code
  */
-static void lexer_error(lexer *const lxr, err_t num, ...)
+static void lexer_report_error(lexer *const lxr, const size_t position, err_t num, ...)
 {
-	const size_t position = in_get_position(lxr->sx->io);
 	const location loc = { position, position + 1 };
 
 	va_list args;
@@ -39,6 +53,86 @@ static void lexer_error(lexer *const lxr, err_t num, ...)
 	va_end(args);
 }
 
+/**
+ *	Report a warning from lexer
+ *
+ *	@param	lxr			Lexer
+ *	@param	position	Position of warning
+ *	@param	num			Warning code
+ */
+static void lexer_report_warning(lexer *const lxr, const size_t position, const warning_t num)
+{
+	const size_t prev_position = in_get_position(lxr->sx->io);
+	in_set_position(lxr->sx->io, position);
+
+	warning(lxr->sx->io, lxr->sx->rprt.comments, num);
+
+	in_set_position(lxr->sx->io, prev_position);
+}
+
+/**
+ *	Delay diagnostic of lexer until its token is reached in token stream
+ *
+ *	@param	lxr			Lexer
+ *	@param	code		Error or warning code
+ *	@param	is_warning	Set, if diagnostic is warning
+ *
+ *	@return	@c 0 on success, @c -1 if diagnostic is not delayed
+ */
+static int lexer_delay(lexer *const lxr, const int code, const bool is_warning)
+{
+	token_stream *const stream = lxr->building;
+	if (stream == NULL)
+	{
+		return -1;
+	}
+
+	if (stream->notes_size == stream->notes_alloc)
+	{
+		const size_t alloc = stream->notes_alloc == 0 ? TOKEN_NOTES_SIZE : 2 * stream->notes_alloc;
+		token_note *const notes = realloc(stream->notes, alloc * sizeof(token_note));
+		if (notes == NULL)
+		{
+			return -1;
+		}
+
+		stream->notes = notes;
+		stream->notes_alloc = alloc;
+	}
+
+	const token_note note = { stream->size, in_get_position(lxr->sx->io), code, is_warning };
+	stream->notes[stream->notes_size++] = note;
+	return 0;
+}
+
+/**
+ *	Emit an error from lexer
+ *
+ *	@param	lxr			Lexer
+ *	@param	num			Error code
+ */
+static void lexer_error(lexer *const lxr, const err_t num)
+{
+	if (lexer_delay(lxr, num, false))
+	{
+		lexer_report_error(lxr, in_get_position(lxr->sx->io), num);
+	}
+}
+
+/**
+ *	Emit a warning from lexer
+ *
+ *	@param	lxr			Lexer
+ *	@param	num			Warning code
+ */
+static void lexer_warning(lexer *const lxr, const warning_t num)
+{
+	if (lexer_delay(lxr, num, true))
+	{
+		lexer_report_warning(lxr, in_get_position(lxr->sx->io), num);
+	}
+}
+
 /**
  *	Scan next character from io
  *
@@ -48,7 +142,7 @@ static void lexer_error(lexer *const lxr, err_t num, ...)
  */
 static inline char32_t scan(lexer *const lxr)
 {
-	lxr->character = uni_scan_char(lxr->sx->io);
+	lxr->character = in_get_char(lxr->sx->io);
 	return lxr->character;
 }
 
@@ -61,10 +155,52 @@ static inline char32_t scan(lexer *const lxr)
  */
 static inline char32_t lookahead(lexer *const lxr)
 {
-	const size_t position = in_get_position(lxr->sx->io);
-	const char32_t result = uni_scan_char(lxr->sx->io);
-	in_set_position(lxr->sx->io, position);
-	return result;
+	return in_peek_char(lxr->sx->io);
+}
+
+/**
+ *	Check if byte is whitespace
+ *
+ *	@param	byte		Byte of input
+ *
+ *	@return	@c true on whitespace byte, @c false on otherwise
+ */
+static inline bool is_space_byte(const char byte)
+{
+	return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r';
+}
+
+/**
+ *	Skip loaded input bytes until ASCII character
+ *	@note	Input position is left on the character or on the last character of loaded input
+ *
+ *	@param	lxr			Lexer
+ *	@param	character	ASCII character to find
+ */
+static inline void skip_until(lexer *const lxr, const char character)
+{
+	size_t available = 0;
+	const char *const cursor = in_get_cursor(lxr->sx->io, &available);
+	if (available == 0)
+	{
+		return;
+	}
+
+	const char *const found = memchr(cursor, character, available);
+	if (found != NULL)
+	{
+		in_skip(lxr->sx->io, (size_t)(found - cursor));
+		return;
+	}
+
+	// Последний символ может быть загружен не полностью, поэтому он читается отдельно
+	size_t size = available - 1;
+	while (size > 0 && (cursor[size] & 0xC0) == 0x80)
+	{
+		size--;
+	}
+
+	in_skip(lxr->sx->io, size);
 }
 
 /**
@@ -77,6 +213,17 @@ static inline void skip_whitespace(lexer *const lxr)
 	while (lxr->character == '\n' || lxr->character == '\r'
 		|| lxr->character == '\t' || lxr->character == ' ')
 	{
+		// Пропускаем всю серию пробельных байтов прямо во входном буфере
+		size_t available = 0;
+		const char *const cursor = in_get_cursor(lxr->sx->io, &available);
+
+		size_t size = 0;
+		while (size < available && is_space_byte(cursor[size]))
+		{
+			size++;
+		}
+
+		in_skip(lxr->sx->io, size);
 		scan(lxr);
 	}
 }
@@ -90,6 +237,7 @@ static inline void skip_line_comment(lexer *const lxr)
 {
 	while (lxr->character != '\n' && lxr->character != (char32_t)EOF)
 	{
+		skip_until(lxr, '\n');
 		scan(lxr);
 	}
 }
@@ -109,12 +257,67 @@ static inline void skip_block_comment(lexer *const lxr)
 			return;
 		}
 
+		skip_until(lxr, '*');
 		scan(lxr);
 	}
 
 	scan(lxr);
 }
 
+/**
+ *	Check if byte may continue a word
+ *	@note	All non-ASCII bytes are accepted, so that keyword is never matched by word prefix
+ *
+ *	@param	byte		Byte of input
+ *
+ *	@return	@c true on word byte, @c false on otherwise
+ */
+static inline bool is_word_byte(const char byte)
+{
+	return (byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z')
+		|| (byte >= '0' && byte <= '9') || byte == '_' || (unsigned char)byte >= 0x80;
+}
+
+/**
+ *	Recognize keyword directly from input by generated perfect hash table
+ *	@note	Input position is moved after keyword only on success
+ *
+ *	@param	lxr			Lexer
+ *
+ *	@return	Keyword token, @c TK_IDENTIFIER if input is not a keyword or is not loaded
+ */
+static token_t lex_keyword(lexer *const lxr)
+{
+	const size_t position = in_get_position(lxr->sx->io);
+	const char *const word = in_get_slice(lxr->sx->io, position, KEYWORDS_MAX_SIZE + 1);
+	if (word == NULL)
+	{
+		return TK_IDENTIFIER;
+	}
+
+	size_t size = 0;
+	while (size <= KEYWORDS_MAX_SIZE && is_word_byte(word[size]))
+	{
+		size++;
+	}
+
+	if (size == 0 || size > KEYWORDS_MAX_SIZE)
+	{
+		return TK_IDENTIFIER;
+	}
+
+	const uint32_t seed = keywords_seeds[keyword_hash(0, word, size) % KEYWORDS_BUCKETS];
+	const keyword *const kw = &keywords_table[keyword_hash(seed, word, size) % KEYWORDS_TABLE_SIZE];
+	if (kw->size != size || memcmp(kw->spelling, word, size) != 0)
+	{
+		return TK_IDENTIFIER;
+	}
+
+	in_set_position(lxr->sx->io, position + size);
+	scan(lxr);
+	return kw->token;
+}
+
 /**
  *	Lex identifier or keyword
  *
@@ -127,6 +330,13 @@ static token lex_identifier_or_keyword(lexer *const lxr)
 	const size_t loc_begin = in_get_position(lxr->sx->io);
 	uni_unscan_char(lxr->sx->io, lxr->character);
 
+	const token_t keyword_kind = lex_keyword(lxr);
+	if (keyword_kind != TK_IDENTIFIER)
+	{
+		const size_t loc_end = in_get_position(lxr->sx->io);
+		return token_keyword((location){ loc_begin, loc_end }, keyword_kind);
+	}
+
 	const size_t repr = repr_reserve(lxr->sx, &lxr->character);
 	const size_t loc_end = in_get_position(lxr->sx->io);
 
@@ -141,6 +351,250 @@ static token lex_identifier_or_keyword(lexer *const lxr)
 	}
 }
 
+/** Decimal form of floating literal */
+typedef struct decimal
+{
+	uint64_t mantissa;				/**< Leading significant digits */
+	size_t digits;					/**< Number of significant digits in mantissa */
+	int64_t exponent;				/**< Decimal exponent of mantissa */
+	bool is_truncated;				/**< Set, if non-zero digits were dropped from mantissa */
+
+	char tail[MAX_DECIMAL_TAIL];	/**< Digits dropped from mantissa */
+	size_t length;					/**< Number of digits in tail */
+	bool is_inexact;				/**< Set, if non-zero digits were dropped from tail */
+} decimal;
+
+/**
+ *	Add digit to decimal form of floating literal
+ *
+ *	@param	dec			Decimal form
+ *	@param	digit		Decimal digit
+ *	@param	is_fraction	Set, if digit is from fractional part
+ */
+static inline void decimal_add_digit(decimal *const dec, const uint8_t digit, const bool is_fraction)
+{
+	if (dec->digits < MAX_DECIMAL_DIGITS)
+	{
+		dec->mantissa = dec->mantissa * 10 + digit;
+		dec->digits += dec->mantissa != 0 ? 1 : 0;
+		dec->exponent -= is_fraction ? 1 : 0;
+	}
+	else
+	{
+		dec->exponent += is_fraction ? 0 : 1;
+		dec->is_truncated = dec->is_truncated || digit != 0;
+
+		if (dec->length < MAX_DECIMAL_TAIL)
+		{
+			dec->tail[dec->length++] = (char)('0' + digit);
+		}
+		else
+		{
+			dec->is_inexact = dec->is_inexact || digit != 0;
+		}
+	}
+}
+
+/**
+ *	Multiply two 64-bit numbers
+ *
+ *	@param	first		First factor
+ *	@param	second		Second factor
+ *	@param	high		High half of product
+ *
+ *	@return	Low half of product
+ */
+static inline uint64_t multiply_full(const uint64_t first, const uint64_t second, uint64_t *const high)
+{
+	const uint64_t low_low = (first & UINT32_MAX) * (second & UINT32_MAX);
+	const uint64_t high_low = (first >> 32) * (second & UINT32_MAX);
+	const uint64_t low_high = (first & UINT32_MAX) * (second >> 32);
+	const uint64_t high_high = (first >> 32) * (second >> 32);
+
+	const uint64_t middle = (low_low >> 32) + (high_low & UINT32_MAX) + low_high;
+	*high = high_high + (high_low >> 32) + (middle >> 32);
+	return (middle << 32) | (low_low & UINT32_MAX);
+}
+
+/**
+ *	Compose double from its fields
+ *
+ *	@param	fraction	Fraction with hidden bit for normal numbers
+ *	@param	exponent	Biased exponent
+ *
+ *	@return	Floating value
+ */
+static inline double compose_double(const uint64_t fraction, const int64_t exponent)
+{
+	const uint64_t bits = fraction | (uint64_t)exponent << 52;
+	double value;
+	memcpy(&value, &bits, sizeof(double));
+	return value;
+}
+
+/**
+ *	Convert decimal mantissa and exponent to double by Eisel-Lemire algorithm
+ *	@note	Product with 128-bit power of five is rounded once, so the result is correctly rounded,
+ *			unless the product is too close to halfway between two doubles
+ *
+ *	@param	mantissa	Non-zero mantissa
+ *	@param	exponent	Decimal exponent from powers table range
+ *	@param	value		Correctly rounded value
+ *
+ *	@return	@c true on success, @c false if rounding is ambiguous
+ */
+static bool eisel_lemire(uint64_t mantissa, const int64_t exponent, double *const value)
+{
+	int64_t zeros = 0;
+	for (int64_t shift = 32; shift > 0; shift /= 2)
+	{
+		if (mantissa >> (64 - shift) == 0)
+		{
+			mantissa <<= shift;
+			zeros += shift;
+		}
+	}
+
+	// Второе слово степени нужно, только если отброшенные биты произведения могут дать перенос
+	const uint64_t *const power = powers_table[exponent - POWERS_MIN_EXPONENT];
+	uint64_t high;
+	uint64_t low = multiply_full(mantissa, power[0], &high);
+	if ((high & (UINT64_MAX >> 55)) == UINT64_MAX >> 55)
+	{
+		uint64_t carry;
+		multiply_full(mantissa, power[1], &carry);
+		low += carry;
+		high += carry > low ? 1 : 0;
+	}
+
+	// Степени пяти от 5^-27 до 5^55 точны, для остальных перенос может быть потерян
+	if (low == UINT64_MAX && (exponent < -27 || exponent > 55))
+	{
+		return false;
+	}
+
+	// Двоичный порядок равен floor(exponent * log2(10)) + 63
+	const int64_t product = (152170 + 65536) * exponent;
+	const int64_t upper = (int64_t)(high >> 63);
+	const int64_t shift = upper + 64 - 52 - 3;
+	uint64_t fraction = high >> shift;
+	int64_t biased = (product >= 0 ? product >> 16 : -((-product + 65535) >> 16)) + 63 + upper - zeros + 1023;
+
+	if (biased <= 0)
+	{
+		// Денормализованное число, округление до четного здесь невозможно
+		if (-biased + 1 >= 64)
+		{
+			*value = 0.0;
+			return true;
+		}
+
+		fraction >>= -biased + 1;
+		fraction += fraction & 1;
+		fraction >>= 1;
+		*value = compose_double(fraction, fraction < (uint64_t)1 << 52 ? 0 : 1);
+		return true;
+	}
+
+	// Ровно посередине можно оказаться, только если 5^exponent помещается в 64 бита
+	if (low <= 1 && exponent >= -4 && exponent <= 23 && (fraction & 3) == 1 && fraction << shift == high)
+	{
+		fraction &= ~(uint64_t)1;
+	}
+
+	fraction += fraction & 1;
+	fraction >>= 1;
+	if (fraction >= (uint64_t)2 << 52)
+	{
+		fraction = (uint64_t)1 << 52;
+		biased++;
+	}
+
+	*value = biased >= 0x7FF ? HUGE_VAL : compose_double(fraction & ~((uint64_t)1 << 52), biased);
+	return true;
+}
+
+/**
+ *	Convert all digits of decimal form to double by C library
+ *	@note	Digits are printed without decimal point, so the result does not depend on locale
+ *
+ *	@param	dec			Decimal form
+ *
+ *	@return	Correctly rounded value
+ */
+static double decimal_to_double_by_digits(const decimal *const dec)
+{
+	// Отброшенные ненулевые цифры заменяются одной единицей
+	const int64_t exponent = dec->exponent - (int64_t)dec->length - (dec->is_inexact ? 1 : 0);
+	char buffer[MAX_DECIMAL_TAIL + 64];
+	snprintf(buffer, sizeof(buffer), "%" PRIu64 "%.*s%se%" PRId64
+		, dec->mantissa, (int)dec->length, dec->tail, dec->is_inexact ? "1" : "", exponent);
+
+	return strtod(buffer, NULL);
+}
+
+/**
+ *	Convert decimal form of floating literal to double
+ *	@note	Exact fast path is used, when mantissa and power of ten are representable in double,
+ *			then Eisel-Lemire algorithm, and only ambiguous values are converted by C library
+ *
+ *	@param	dec			Decimal form
+ *
+ *	@return	Floating value
+ */
+static double decimal_to_double(const decimal *const dec)
+{
+	static const double powers_of_ten[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	static const int64_t max_exact_power = 22;
+	static const uint64_t max_exact_mantissa = (uint64_t)1 << 53;
+
+	if (dec->mantissa == 0 || dec->exponent < POWERS_MIN_EXPONENT)
+	{
+		return 0.0;
+	}
+
+	if (dec->exponent > POWERS_MAX_EXPONENT)
+	{
+		return HUGE_VAL;
+	}
+
+	if (!dec->is_truncated && dec->mantissa <= max_exact_mantissa && dec->exponent >= -max_exact_power)
+	{
+		// Оба операнда точны, поэтому результат округляется один раз
+		uint64_t mantissa = dec->mantissa;
+		int64_t exponent = dec->exponent;
+		while (exponent > max_exact_power && mantissa <= max_exact_mantissa / 10)
+		{
+			mantissa *= 10;
+			exponent--;
+		}
+
+		if (exponent < 0)
+		{
+			return (double)mantissa / powers_of_ten[-exponent];
+		}
+		else if (exponent <= max_exact_power)
+		{
+			return (double)mantissa * powers_of_ten[exponent];
+		}
+	}
+
+	// Значение с отброшенными цифрами лежит между mantissa и mantissa + 1
+	double value;
+	double upper;
+	if (eisel_lemire(dec->mantissa, dec->exponent, &value)
+		&& (!dec->is_truncated || (eisel_lemire(dec->mantissa + 1, dec->exponent, &upper) && value == upper)))
+	{
+		return value;
+	}
+
+	return decimal_to_double_by_digits(dec);
+}
+
 /**
  *	Lex numeric literal
  *
@@ -196,6 +650,13 @@ static token lex_numeric_literal(lexer *const lxr)
 	double float_value = 0.0;
 	bool is_in_range = true;
 	bool is_integer = true;
+	decimal dec;
+	dec.mantissa = 0;
+	dec.digits = 0;
+	dec.exponent = 0;
+	dec.is_truncated = false;
+	dec.length = 0;
+	dec.is_inexact = false;
 
 	while (utf8_is_hexa_digit(lxr->character))
 	{
@@ -239,6 +700,7 @@ static token lex_numeric_literal(lexer *const lxr)
 			float_value = float_value * base + digit;
 		}
 
+		decimal_add_digit(&dec, digit, false);
 		scan(lxr);
 	}
 
@@ -251,13 +713,11 @@ static token lex_numeric_literal(lexer *const lxr)
 		}
 
 		is_integer = false;
-		double position_mult = 0.1;
 		// Читаем только десятичные цифры
 		// Все остальное относится к следюущим токенам
 		while (utf8_is_digit(scan(lxr)))
 		{
-			float_value += utf8_to_number(lxr->character) * position_mult;
-			position_mult *= 0.1;
+			decimal_add_digit(&dec, utf8_to_number(lxr->character), true);
 		}
 	}
 
@@ -301,7 +761,7 @@ static token lex_numeric_literal(lexer *const lxr)
 
 		while (utf8_is_digit(lxr->character))
 		{
-			power = power * 10 + utf8_to_number(lxr->character);
+			power = power < MAX_DECIMAL_EXPONENT ? power * 10 + utf8_to_number(lxr->character) : power;
 			scan(lxr);
 		}
 
@@ -313,11 +773,16 @@ static token lex_numeric_literal(lexer *const lxr)
 			}
 		}
 
-		float_value *= pow(10.0, sign * (double)power);
+		dec.exponent += sign * power;
 	}
 
 	// Формируем результат
 	const size_t loc_end = in_get_position(lxr->sx->io);
+	if (!is_integer && !was_modifier)
+	{
+		// Литерал без спецификатора десятичный
+		float_value = decimal_to_double(&dec);
+	}
 	if (is_integer)
 	{
 		return token_int_literal((location){ loc_begin, loc_end }, int_value);
@@ -327,7 +792,7 @@ static token lex_numeric_literal(lexer *const lxr)
 		if (!is_in_range)
 		{
 			// Вышли за пределы целого - конвертируем в double
-			warning(lxr->sx->io, too_long_int);
+			lexer_warning(lxr, too_long_int);
 		}
 
 		return token_float_literal((location){ loc_begin, loc_end }, float_value);
@@ -443,40 +908,15 @@ static token lex_string_literal(lexer *const lxr)
 }
 
 
-/*
- *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
- *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
- *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
- *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
- *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+/**
+ *	Lex next token from io
+ *
+ *	@param	lxr			Lexer
+ *
+ *	@return	Lexed token
  */
-
-
-lexer lexer_create(syntax *const sx)
-{
-	lexer lxr;
-	lxr.sx = sx;
-
-	lxr.lexstr = vector_create(MAX_STRING_LENGTH);
-
-	scan(&lxr);
-
-	return lxr;
-}
-
-int lexer_clear(lexer *const lxr)
+static token lex_token(lexer *const lxr)
 {
-	return vector_clear(&lxr->lexstr);
-}
-
-
-token lex(lexer *const lxr)
-{
-	if (lxr == NULL)
-	{
-		return token_eof();
-	}
-
 	while (true)
 	{
 		skip_whitespace(lxr);
@@ -499,7 +939,7 @@ token lex(lexer *const lxr)
 					lexer_error(lxr, bad_character);
 					// Pretending the character didn't exist
 					scan(lxr);
-					return lex(lxr);
+					return lex_token(lxr);
 				}
 
 				// Integer and floating literals
@@ -802,12 +1242,283 @@ token lex(lexer *const lxr)
 	}
 }
 
-token_t peek(lexer *const lxr)
+/**
+ *	Get token from lookahead buffer, lexing missing tokens from io
+ *
+ *	@param	lxr			Lexer
+ *	@param	n			Number of token ahead, starting from @c 0
+ *
+ *	@return	Pointer to buffered token
+ */
+static inline const token *lookahead_token(lexer *const lxr, const size_t n)
+{
+	while (lxr->tokens_size <= n)
+	{
+		lxr->tokens[(lxr->tokens_begin + lxr->tokens_size) % LEXER_LOOKAHEAD] = lex_token(lxr);
+		lxr->tokens_size++;
+	}
+
+	return &lxr->tokens[(lxr->tokens_begin + n) % LEXER_LOOKAHEAD];
+}
+
+/**
+ *	Add token to the end of token stream
+ *
+ *	@param	stream		Token stream
+ *	@param	tk			Token
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+static int stream_add(token_stream *const stream, const token *const tk)
 {
+	if (stream->size == stream->alloc)
+	{
+		const size_t alloc = stream->alloc == 0 ? TOKEN_STREAM_SIZE : 2 * stream->alloc;
+
+		token_t *const kinds = realloc(stream->kinds, alloc * sizeof(token_t));
+		stream->kinds = kinds != NULL ? kinds : stream->kinds;
+		size_t *const begins = realloc(stream->begins, alloc * sizeof(size_t));
+		stream->begins = begins != NULL ? begins : stream->begins;
+		size_t *const ends = realloc(stream->ends, alloc * sizeof(size_t));
+		stream->ends = ends != NULL ? ends : stream->ends;
+		uint64_t *const values = realloc(stream->values, alloc * sizeof(uint64_t));
+		stream->values = values != NULL ? values : stream->values;
+
+		if (kinds == NULL || begins == NULL || ends == NULL || values == NULL)
+		{
+			return -1;
+		}
+
+		stream->alloc = alloc;
+	}
+
+	uint64_t value = 0;
+	switch (tk->kind)
+	{
+		case TK_IDENTIFIER:
+			value = token_get_ident_name(tk);
+			break;
+		case TK_CHAR_LITERAL:
+			value = token_get_char_value(tk);
+			break;
+		case TK_INT_LITERAL:
+			value = token_get_int_value(tk);
+			break;
+		case TK_FLOAT_LITERAL:
+		{
+			const double float_value = token_get_float_value(tk);
+			memcpy(&value, &float_value, sizeof(double));
+		}
+		break;
+		case TK_STRING_LITERAL:
+			value = token_get_string_num(tk);
+			break;
+		default:
+			break;
+	}
+
+	const location loc = token_get_location(tk);
+	stream->kinds[stream->size] = token_get_kind(tk);
+	stream->begins[stream->size] = loc.begin;
+	stream->ends[stream->size] = loc.end;
+	stream->values[stream->size] = value;
+	stream->size++;
+	return 0;
+}
+
+/**
+ *	Report delayed diagnostics up to token in token stream
+ *
+ *	@param	lxr			Lexer
+ *	@param	index		Index of reached token
+ */
+static void stream_report(lexer *const lxr, const size_t index)
+{
+	token_stream *const stream = &lxr->stream;
+	while (stream->notes_next < stream->notes_size && stream->notes[stream->notes_next].token <= index)
+	{
+		const token_note *const note = &stream->notes[stream->notes_next++];
+		if (note->is_warning)
+		{
+			lexer_report_warning(lxr, note->position, (warning_t)note->code);
+		}
+		else
+		{
+			lexer_report_error(lxr, note->position, (err_t)note->code);
+		}
+	}
+}
+
+/**
+ *	Free allocated memory of token stream
+ *
+ *	@param	stream		Token stream
+ */
+static void stream_clear(token_stream *const stream)
+{
+	free(stream->kinds);
+	free(stream->begins);
+	free(stream->ends);
+	free(stream->values);
+	free(stream->notes);
+	*stream = (token_stream){ NULL, NULL, NULL, NULL, 0, 0, 0, NULL, 0, 0, 0 };
+}
+
+/**
+ *	Get token from token stream
+ *
+ *	@param	stream		Token stream
+ *	@param	index		Index of token
+ *
+ *	@return	Token
+ */
+static token stream_get(const token_stream *const stream, const size_t index)
+{
+	const location loc = { stream->begins[index], stream->ends[index] };
+	const uint64_t value = stream->values[index];
+
+	switch (stream->kinds[index])
+	{
+		case TK_EOF:
+			return token_eof();
+		case TK_IDENTIFIER:
+			return token_identifier(loc, (size_t)value);
+		case TK_CHAR_LITERAL:
+			return token_char_literal(loc, (char32_t)value);
+		case TK_INT_LITERAL:
+			return token_int_literal(loc, value);
+		case TK_FLOAT_LITERAL:
+		{
+			double float_value;
+			memcpy(&float_value, &value, sizeof(double));
+			return token_float_literal(loc, float_value);
+		}
+		case TK_STRING_LITERAL:
+			return token_string_literal(loc, (size_t)value);
+		default:
+			return stream->kinds[index] < TK_IDENTIFIER
+				? token_keyword(loc, stream->kinds[index])
+				: token_punctuator(loc, stream->kinds[index]);
+	}
+}
+
+
+/*
+ *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
+ *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
+ *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
+ *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
+ *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+ */
+
+
+lexer lexer_create(syntax *const sx)
+{
+	lexer lxr;
+	lxr.sx = sx;
+
+	lxr.lexstr = vector_create(MAX_STRING_LENGTH);
+	lxr.tokens_begin = 0;
+	lxr.tokens_size = 0;
+	lxr.stream = (token_stream){ NULL, NULL, NULL, NULL, 0, 0, 0, NULL, 0, 0, 0 };
+	lxr.building = NULL;
+
+	scan(&lxr);
+
+	return lxr;
+}
+
+int lexer_clear(lexer *const lxr)
+{
+	stream_clear(&lxr->stream);
+	return vector_clear(&lxr->lexstr);
+}
+
+
+int lexer_tokenize(lexer *const lxr)
+{
+	if (lxr == NULL || lxr->stream.size != 0)
+	{
+		return -1;
+	}
+
 	const size_t position = in_get_position(lxr->sx->io);
 	const char32_t character = lxr->character;
-	const token peek_token = lex(lxr);
-	lxr->character = character;
-	in_set_position(lxr->sx->io, position);
-	return token_get_kind(&peek_token);
+
+	token_stream stream = { NULL, NULL, NULL, NULL, 0, 0, 0, NULL, 0, 0, 0 };
+	lxr->building = &stream;
+
+	token tk;
+	do
+	{
+		tk = lex(lxr);
+		if (stream_add(&stream, &tk))
+		{
+			// Без памяти под поток ввод разбирается заново по запросу, диагностики будут выданы при этом
+			lxr->building = NULL;
+			stream_clear(&stream);
+
+			in_set_position(lxr->sx->io, position);
+			lxr->character = character;
+			return -1;
+		}
+	} while (token_is_not(&tk, TK_EOF));
+
+	lxr->building = NULL;
+
+	// Для конца файла запоминается позиция конца ввода
+	stream.ends[stream.size - 1] = in_get_position(lxr->sx->io);
+	lxr->stream = stream;
+	return 0;
+}
+
+token lex(lexer *const lxr)
+{
+	if (lxr == NULL)
+	{
+		return token_eof();
+	}
+
+	if (lxr->stream.size != 0)
+	{
+		// Позиция во входном потоке нужна для диагностик, как и при лексическом анализе по запросу
+		const size_t index = lxr->stream.next;
+		in_set_position(lxr->sx->io, lxr->stream.ends[index]);
+
+		// Поток всегда заканчивается токеном конца файла, который не потребляется
+		lxr->stream.next += index + 1 < lxr->stream.size ? 1 : 0;
+		stream_report(lxr, index);
+		return stream_get(&lxr->stream, index);
+	}
+
+	if (lxr->tokens_size == 0)
+	{
+		return lex_token(lxr);
+	}
+
+	const token tk = lxr->tokens[lxr->tokens_begin];
+	lxr->tokens_begin = (lxr->tokens_begin + 1) % LEXER_LOOKAHEAD;
+	lxr->tokens_size--;
+	return tk;
+}
+
+token_t peek(lexer *const lxr)
+{
+	return peek_nth(lxr, 1);
+}
+
+token_t peek_nth(lexer *const lxr, const size_t n)
+{
+	if (lxr->stream.size != 0)
+	{
+		const size_t next = lxr->stream.next + n - 1;
+		const size_t index = next < lxr->stream.size ? next : lxr->stream.size - 1;
+
+		// Диагностики выдаются при просмотре токена, как и при лексическом анализе по запросу
+		stream_report(lxr, index);
+		return lxr->stream.kinds[index];
+	}
+
+	assert(n > 0 && n <= LEXER_LOOKAHEAD);
+	return token_get_kind(lookahead_token(lxr, n - 1));
 }
@@ -24,10 +24,40 @@
 #include "workspace.h"
 
 
+#define LEXER_LOOKAHEAD 4
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Diagnostic of lexer, which is reported when its token is reached in token stream */
+typedef struct token_note
+{
+	size_t token;							/**< Index of token, which was lexed on diagnostic */
+	size_t position;						/**< Position of diagnostic */
+	int code;								/**< Error or warning code */
+	bool is_warning;						/**< Set, if diagnostic is warning */
+} token_note;
+
+/** Stream of lexed tokens in struct-of-arrays form */
+typedef struct token_stream
+{
+	token_t *kinds;							/**< Kinds of tokens */
+	size_t *begins;							/**< Begin positions of tokens */
+	size_t *ends;							/**< End positions of tokens */
+	uint64_t *values;						/**< Payloads of tokens */
+
+	size_t size;							/**< Number of tokens */
+	size_t alloc;							/**< Allocated number of tokens */
+	size_t next;							/**< Index of the next token to consume */
+
+	token_note *notes;						/**< Diagnostics of lexer in order of tokens */
+	size_t notes_size;						/**< Number of diagnostics */
+	size_t notes_alloc;						/**< Allocated number of diagnostics */
+	size_t notes_next;						/**< Index of the next diagnostic to report */
+} token_stream;
+
 /** Lexer structure */
 typedef struct lexer
 {
@@ -35,6 +65,13 @@ typedef struct lexer
 
 	char32_t character;						/**< Current character */
 	vector lexstr;							/**< Representation of the read string literal */
+
+	token tokens[LEXER_LOOKAHEAD];			/**< Ring buffer of already lexed tokens */
+	size_t tokens_begin;					/**< Index of the first buffered token */
+	size_t tokens_size;						/**< Number of buffered tokens */
+
+	token_stream stream;					/**< Tokens of whole input, empty if input is lexed on demand */
+	token_stream *building;					/**< Token stream, which is being built, @c NULL otherwise */
 } lexer;
 
 /**
@@ -46,6 +83,18 @@ typedef struct lexer
  */
 lexer lexer_create(syntax *const sx);
 
+/**
+ *	Lex whole input into token stream
+ *	@note	Afterwards tokens are consumed from the stream by index.
+ *			Lexer diagnostics are reported when their tokens are consumed or peeked,
+ *			so they are ordered with parser diagnostics as on demand
+ *
+ *	@param	lxr		Lexer
+ *
+ *	@return	@c 0 on success, @c -1 on failure, then input is lexed on demand
+ */
+int lexer_tokenize(lexer *const lxr);
+
 /**
  *	Lex next token from io
  *
@@ -64,6 +113,17 @@ token lex(lexer *const lxr);
  */
 token_t peek(lexer *const lxr);
 
+/**
+ *	Peek n-th token ahead without consuming it
+ *	@note	Peeked tokens are buffered, so they are lexed only once
+ *
+ *	@param	lxr		Lexer
+ *	@param	n		Number of token ahead, from @c 1 to @c LEXER_LOOKAHEAD, unlimited for token stream
+ *
+ *	@return	Peeked token kind
+ */
+token_t peek_nth(lexer *const lxr, const size_t n);
+
 /**
  *	Free allocated memory
  *
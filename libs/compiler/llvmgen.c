@@ -134,13 +134,13 @@ static void func_name_to_io(information *const info, const size_t func_ref)
 	const char *name = ident_get_spelling(info->sx, func_ref);
 	if (func_ref < BEGIN_USER_FUNC)
 	{
-		uni_printf(info->sx->io, "%s", name);
+		uni_print_string(info->sx->io, name);
 		return;
 	}
 
 	char modified_name[MAX_NAME];
 	utf8_transliteration(name, modified_name);
-	uni_printf(info->sx->io, "%s", modified_name);
+	uni_print_string(info->sx->io, modified_name);
 }
 
 static void type_to_io(information *const info, const item_t type)
@@ -149,51 +149,52 @@ static void type_to_io(information *const info, const item_t type)
 	switch (type_class)
 	{
 		case TYPE_VARARG:
-			uni_printf(info->sx->io, "...");
+			uni_print_string(info->sx->io, "...");
 			break;
 
 		case TYPE_BOOLEAN:
-			uni_printf(info->sx->io, "i1");
+			uni_print_string(info->sx->io, "i1");
 			break;
 
 		case TYPE_CHARACTER:
-			uni_printf(info->sx->io, "i8");
+			uni_print_string(info->sx->io, "i8");
 			break;
 
 		case TYPE_INTEGER:
 		case TYPE_ENUM:
-			uni_printf(info->sx->io, "i32");
+			uni_print_string(info->sx->io, "i32");
 			break;
 
 		case TYPE_FLOATING:
-			uni_printf(info->sx->io, "double");
+			uni_print_string(info->sx->io, "double");
 			break;
 
 		case TYPE_VOID:
-			uni_printf(info->sx->io, "void");
+			uni_print_string(info->sx->io, "void");
 			break;
 
 		case TYPE_STRUCTURE:
-			uni_printf(info->sx->io, "%%struct_opt.%" PRIitem, type);
+			uni_print_string(info->sx->io, "%struct_opt.");
+			uni_print_int(info->sx->io, type);
 			break;
 
 		case TYPE_POINTER:
 		{
 			type_to_io(info, type_pointer_get_element_type(info->sx, type));
-			uni_printf(info->sx->io, "*");
+			uni_print_string(info->sx->io, "*");
 		}
 		break;
 
 		case TYPE_ARRAY:
 		{
 			type_to_io(info, type_array_get_element_type(info->sx, type));
-			uni_printf(info->sx->io, "*");
+			uni_print_string(info->sx->io, "*");
 		}
 		break;
 
 		case TYPE_FILE:
 		{
-			uni_printf(info->sx->io, "%%struct._IO_FILE");
+			uni_print_string(info->sx->io, "%struct._IO_FILE");
 			info->was_file = true;
 		}
 		break;
@@ -201,7 +202,7 @@ static void type_to_io(information *const info, const item_t type)
 		case TYPE_FUNCTION:
 		{
 			type_to_io(info, type_function_get_return_type(info->sx, type));
-			uni_printf(info->sx->io, " (");
+			uni_print_string(info->sx->io, " (");
 
 			const size_t parameter_amount = type_function_get_parameter_amount(info->sx, type);
 			for (size_t i = 0; i < parameter_amount; i++)
@@ -219,19 +220,19 @@ static void type_to_io(information *const info, const item_t type)
 
 				if (type_is_function(info->sx, type_parameter))
 				{
-					uni_printf(info->sx->io, "*");
+					uni_print_string(info->sx->io, "*");
 				}
 
 				if (i != parameter_amount - 1)
 				{
-					uni_printf(info->sx->io, ", ");
+					uni_print_string(info->sx->io, ", ");
 				}
 			}
-			uni_printf(info->sx->io, ")");
+			uni_print_string(info->sx->io, ")");
 
 			if (!info->is_call)
 			{
-				uni_printf(info->sx->io, "*");
+				uni_print_string(info->sx->io, "*");
 			}
 		}
 		break;
@@ -247,71 +248,71 @@ static void operation_to_io(information *const info, const binary_t operation_ty
 	{
 		case BIN_ADD_ASSIGN:
 		case BIN_ADD:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "add nsw" : "fadd");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "add nsw" : "fadd");
 			break;
 
 		case BIN_SUB_ASSIGN:
 		case BIN_SUB:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "sub nsw" : "fsub");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "sub nsw" : "fsub");
 			break;
 
 		case BIN_MUL_ASSIGN:
 		case BIN_MUL:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "mul nsw" : "fmul");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "mul nsw" : "fmul");
 			break;
 
 		case BIN_DIV_ASSIGN:
 		case BIN_DIV:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "sdiv" : "fdiv");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "sdiv" : "fdiv");
 			break;
 
 		case BIN_REM_ASSIGN:
 		case BIN_REM:
-			uni_printf(info->sx->io, "srem");
+			uni_print_string(info->sx->io, "srem");
 			break;
 
 		case BIN_SHL_ASSIGN:
 		case BIN_SHL:
-			uni_printf(info->sx->io, "shl");
+			uni_print_string(info->sx->io, "shl");
 			break;
 
 		case BIN_SHR_ASSIGN:
 		case BIN_SHR:
-			uni_printf(info->sx->io, "ashr");
+			uni_print_string(info->sx->io, "ashr");
 			break;
 
 		case BIN_AND_ASSIGN:
 		case BIN_AND:
-			uni_printf(info->sx->io, "and");
+			uni_print_string(info->sx->io, "and");
 			break;
 
 		case BIN_XOR_ASSIGN:
 		case BIN_XOR:
-			uni_printf(info->sx->io, "xor");
+			uni_print_string(info->sx->io, "xor");
 			break;
 
 		case BIN_OR_ASSIGN:
 		case BIN_OR:
-			uni_printf(info->sx->io, "or");
+			uni_print_string(info->sx->io, "or");
 			break;
 
 		case BIN_EQ:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "icmp eq" : "fcmp oeq");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "icmp eq" : "fcmp oeq");
 			break;
 		case BIN_NE:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "icmp ne" : "fcmp one");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "icmp ne" : "fcmp one");
 			break;
 		case BIN_LT:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "icmp slt" : "fcmp olt");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "icmp slt" : "fcmp olt");
 			break;
 		case BIN_GT:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "icmp sgt" : "fcmp ogt");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "icmp sgt" : "fcmp ogt");
 			break;
 		case BIN_LE:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "icmp sle" : "fcmp ole");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "icmp sle" : "fcmp ole");
 			break;
 		case BIN_GE:
-			uni_printf(info->sx->io, type_is_integer(info->sx, type) ? "icmp sge" : "fcmp oge");
+			uni_print_string(info->sx->io, type_is_integer(info->sx, type) ? "icmp sge" : "fcmp oge");
 			break;
 		default:
 			break;
@@ -321,162 +322,260 @@ static void operation_to_io(information *const info, const binary_t operation_ty
 static void to_code_operation_reg_reg(information *const info, const binary_t operation
 	, const size_t fst, const size_t snd, const item_t type)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, type);
-	uni_printf(info->sx->io, " ");
+	uni_print_string(info->sx->io, " ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %%.%zu, %%.%zu\n", fst, snd);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, fst);
+	uni_print_string(info->sx->io, ", %.");
+	uni_print_uint(info->sx->io, snd);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_operation_reg_const_integer(information *const info, const binary_t operation
 	, const size_t fst, const item_t snd, const item_t type)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_INTEGER);
-	uni_printf(info->sx->io, " ");
+	uni_print_string(info->sx->io, " ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %%.%zu, %" PRIitem "\n", fst, snd);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, fst);
+	uni_print_string(info->sx->io, ", ");
+	uni_print_int(info->sx->io, snd);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_operation_reg_const_bool(information *const info, const binary_t operation
 	, const size_t fst, const bool snd, const item_t type)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_INTEGER);
-	uni_printf(info->sx->io, " ");
+	uni_print_string(info->sx->io, " ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %%.%zu, %s\n", fst, snd ? "true" : "false");
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, fst);
+	uni_print_string(info->sx->io, ", ");
+	uni_print_string(info->sx->io, snd ? "true" : "false");
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_operation_reg_const_double(information *const info, const binary_t operation
 	, const size_t fst, const double snd)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_FLOATING);
-	uni_printf(info->sx->io, " double %%.%zu, %f\n", fst, snd);
+	uni_print_string(info->sx->io, " double %.");
+	uni_print_uint(info->sx->io, fst);
+	uni_print_string(info->sx->io, ", ");
+	uni_printf(info->sx->io, "%f", snd);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_operation_const_reg_integer(information *const info, const binary_t operation
 	, const item_t fst, const size_t snd, const item_t type)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_INTEGER);
-	uni_printf(info->sx->io, " ");
+	uni_print_string(info->sx->io, " ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %" PRIitem ", %%.%zu\n", fst, snd);
+	uni_print_string(info->sx->io, " ");
+	uni_print_int(info->sx->io, fst);
+	uni_print_string(info->sx->io, ", %.");
+	uni_print_uint(info->sx->io, snd);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_operation_const_reg_double(information *const info, const binary_t operation
 	, const double fst, const size_t snd)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_FLOATING);
-	uni_printf(info->sx->io, " double %f, %%.%zu\n", fst, snd);
+	uni_print_string(info->sx->io, " double ");
+	uni_printf(info->sx->io, "%f", fst);
+	uni_print_string(info->sx->io, ", %.");
+	uni_print_uint(info->sx->io, snd);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_operation_reg_null(information *const info, const binary_t operation
 	, const size_t fst, const item_t type)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_INTEGER);
-	uni_printf(info->sx->io, " ");
+	uni_print_string(info->sx->io, " ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %%.%zu, null\n", fst);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, fst);
+	uni_print_string(info->sx->io, ", null\n");
 }
 
 static void to_code_operation_null_reg(information *const info, const binary_t operation
 	, const size_t snd, const item_t type)
 {
-	uni_printf(info->sx->io, " %%.%zu = ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = ");
 	operation_to_io(info, operation, TYPE_INTEGER);
-	uni_printf(info->sx->io, " ");
+	uni_print_string(info->sx->io, " ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " null, %%.%zu\n", snd);
+	uni_print_string(info->sx->io, " null, %.");
+	uni_print_uint(info->sx->io, snd);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_load(information *const info, const size_t result, const size_t id, const item_t type
 	, const bool is_array, const bool is_local)
 {
-	uni_printf(info->sx->io, " %%.%zu = load ", result);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, result);
+	uni_print_string(info->sx->io, " = load ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, ", ");
+	uni_print_string(info->sx->io, ", ");
 	type_to_io(info, type);
 	if (type_get_class(info->sx, type) == TYPE_FUNCTION && !is_local)
 	{
-		uni_printf(info->sx->io, "* @");
+		uni_print_string(info->sx->io, "* @");
 		func_name_to_io(info, info->func_ref);
-		uni_printf(info->sx->io, ", align 4\n");
+		uni_print_string(info->sx->io, ", align 4\n");
 		return;
 	}
-	uni_printf(info->sx->io, "* %s%s.%zu, align 4\n", is_local ? "%" : "@", is_array ? "" : "var", id);
+	uni_print_string(info->sx->io, "* ");
+	uni_print_string(info->sx->io, is_local ? "%" : "@");
+	uni_print_string(info->sx->io, is_array ? "" : "var");
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, id);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static void to_code_store_reg(information *const info, const size_t reg, const size_t id, const item_t type
 	, const bool is_array, const bool is_pointer, const bool is_local)
 {
-	uni_printf(info->sx->io, " store ");
+	uni_print_string(info->sx->io, " store ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %s%s.%zu, ", /*ident_is_local(info->sx, reg)*/true ? "%" : "@", is_pointer ? "var" : "", reg);
+	uni_print_string(info->sx->io, " ");
+	uni_print_string(info->sx->io, /*ident_is_local(info->sx, reg)*/true ? "%" : "@");
+	uni_print_string(info->sx->io, is_pointer ? "var" : "");
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, reg);
+	uni_print_string(info->sx->io, ", ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, "* %s%s.%zu, align 4\n", is_local ? "%" : "@", is_array ? "" : "var", id);
+	uni_print_string(info->sx->io, "* ");
+	uni_print_string(info->sx->io, is_local ? "%" : "@");
+	uni_print_string(info->sx->io, is_array ? "" : "var");
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, id);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static inline void to_code_store_const_integer(information *const info, const item_t arg, const size_t id
 	, const bool is_array, const bool is_local, const item_t type)
 {
-	uni_printf(info->sx->io, " store ");
+	uni_print_string(info->sx->io, " store ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " %" PRIitem ", ", arg);
+	uni_print_string(info->sx->io, " ");
+	uni_print_int(info->sx->io, arg);
+	uni_print_string(info->sx->io, ", ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, "* %s%s.%zu, align 4\n", is_local ? "%" : "@", is_array ? "" : "var", id);
+	uni_print_string(info->sx->io, "* ");
+	uni_print_string(info->sx->io, is_local ? "%" : "@");
+	uni_print_string(info->sx->io, is_array ? "" : "var");
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, id);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static inline void to_code_store_const_bool(information *const info, const bool arg, const size_t id
 	, const bool is_array, const bool is_local)
 {
-	uni_printf(info->sx->io, " store i1 %s, i1* %s%s.%zu, align 4\n"
-		, arg ? "true" : "false", is_local ? "%" : "@", is_array ? "" : "var", id);
+	uni_print_string(info->sx->io, " store i1 ");
+	uni_print_string(info->sx->io, arg ? "true" : "false");
+	uni_print_string(info->sx->io, ", i1* ");
+	uni_print_string(info->sx->io, is_local ? "%" : "@");
+	uni_print_string(info->sx->io, is_array ? "" : "var");
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, id);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static inline void to_code_store_const_double(information *const info, const double arg, const size_t id
 	, const bool is_array, const bool is_local)
 {
-	uni_printf(info->sx->io, " store double %f, double* %s%s.%zu, align 4\n"
-		, arg, is_local ? "%" : "@", is_array ? "" : "var", id);
+	uni_print_string(info->sx->io, " store double ");
+	uni_printf(info->sx->io, "%f", arg);
+	uni_print_string(info->sx->io, ", double* ");
+	uni_print_string(info->sx->io, is_local ? "%" : "@");
+	uni_print_string(info->sx->io, is_array ? "" : "var");
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, id);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static void to_code_store_null(information *const info, const size_t id, const item_t type)
 {
-	uni_printf(info->sx->io, " store ");
+	uni_print_string(info->sx->io, " store ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, " null, ");
+	uni_print_string(info->sx->io, " null, ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, "* %%var.%zu, align 4\n", id);
+	uni_print_string(info->sx->io, "* %var.");
+	uni_print_uint(info->sx->io, id);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static inline void to_code_label(information *const info, const size_t label_num)
 {
-	uni_printf(info->sx->io, " label%zu:\n", label_num);
+	uni_print_string(info->sx->io, " label");
+	uni_print_uint(info->sx->io, label_num);
+	uni_print_string(info->sx->io, ":\n");
 }
 
 static inline void to_code_unconditional_branch(information *const info, const size_t label_num)
 {
-	uni_printf(info->sx->io, " br label %%label%zu\n", label_num);
+	uni_print_string(info->sx->io, " br label %label");
+	uni_print_uint(info->sx->io, label_num);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static inline void to_code_conditional_branch(information *const info)
 {
-	uni_printf(info->sx->io, " br i1 %%.%zu, label %%label%zu, label %%label%zu\n"
-		, info->answer_reg, info->label_true, info->label_false);
+	uni_print_string(info->sx->io, " br i1 %.");
+	uni_print_uint(info->sx->io, info->answer_reg);
+	uni_print_string(info->sx->io, ", label %label");
+	uni_print_uint(info->sx->io, info->label_true);
+	uni_print_string(info->sx->io, ", label %label");
+	uni_print_uint(info->sx->io, info->label_false);
+	uni_print_string(info->sx->io, "\n");
 }
 
 static void to_code_stack_save(information *const info, const item_t index)
 {
 	// команды сохранения состояния стека
-	uni_printf(info->sx->io, " %%dyn.%" PRIitem " = alloca i8*, align 4\n", index);
-	uni_printf(info->sx->io, " %%.%zu = call i8* @llvm.stacksave()\n", info->register_num);
-	uni_printf(info->sx->io, " store i8* %%.%zu, i8** %%dyn.%" PRIitem ", align 4\n"
-		, info->register_num, index);
+	uni_print_string(info->sx->io, " %dyn.");
+	uni_print_int(info->sx->io, index);
+	uni_print_string(info->sx->io, " = alloca i8*, align 4\n");
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = call i8* @llvm.stacksave()\n");
+	uni_print_string(info->sx->io, " store i8* %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, ", i8** %dyn.");
+	uni_print_int(info->sx->io, index);
+	uni_print_string(info->sx->io, ", align 4\n");
 	info->register_num++;
 
 	info->was_stack_functions = true;
@@ -485,9 +584,14 @@ static void to_code_stack_save(information *const info, const item_t index)
 static void to_code_stack_load(information *const info, const item_t index)
 {
 	// команды восстановления состояния стека
-	uni_printf(info->sx->io, " %%.%zu = load i8*, i8** %%dyn.%" PRIitem ", align 4\n"
-		, info->register_num, index);
-	uni_printf(info->sx->io, " call void @llvm.stackrestore(i8* %%.%zu)\n", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = load i8*, i8** %dyn.");
+	uni_print_int(info->sx->io, index);
+	uni_print_string(info->sx->io, ", align 4\n");
+	uni_print_string(info->sx->io, " call void @llvm.stackrestore(i8* %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, ")\n");
 	info->register_num++;
 
 	info->was_stack_functions = true;
@@ -497,11 +601,15 @@ static void to_code_alloc_array_static(information *const info, const size_t ind
 {
 	if (is_local)
 	{
-		uni_printf(info->sx->io, " %%arr.%" PRIitem " = alloca ", hash_get_key(&info->arrays, index));
+		uni_print_string(info->sx->io, " %arr.");
+		uni_print_int(info->sx->io, hash_get_key(&info->arrays, index));
+		uni_print_string(info->sx->io, " = alloca ");
 	}
 	else
 	{
-		uni_printf(info->sx->io, "@arr.%" PRIitem " = common global ", hash_get_key(&info->arrays, index));
+		uni_print_string(info->sx->io, "@arr.");
+		uni_print_int(info->sx->io, hash_get_key(&info->arrays, index));
+		uni_print_string(info->sx->io, " = common global ");
 	}
 
 	const size_t dim = hash_get_amount_by_index(&info->arrays, index) - 1;
@@ -513,15 +621,18 @@ static void to_code_alloc_array_static(information *const info, const size_t ind
 
 	for (size_t i = 1; i <= dim; i++)
 	{
-		uni_printf(info->sx->io, "[%" PRIitem " x ", hash_get_by_index(&info->arrays, index, i));
+		uni_print_string(info->sx->io, "[");
+		uni_print_int(info->sx->io, hash_get_by_index(&info->arrays, index, i));
+		uni_print_string(info->sx->io, " x ");
 	}
 	type_to_io(info, type);
 
 	for (size_t i = 1; i <= dim; i++)
 	{
-		uni_printf(info->sx->io, "]");
+		uni_print_string(info->sx->io, "]");
 	}
-	uni_printf(info->sx->io, "%s, align 4\n", is_local ? "" : " zeroinitializer");
+	uni_print_string(info->sx->io, is_local ? "" : " zeroinitializer");
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static void to_code_alloc_array_dynamic(information *const info, const size_t index, const item_t type)
@@ -538,19 +649,30 @@ static void to_code_alloc_array_dynamic(information *const info, const size_t in
 
 	for (size_t i = 2; i <= dim; i++)
 	{
-		uni_printf(info->sx->io, " %%.%zu = mul nuw i32 %%.%" PRIitem ", %%.%" PRIitem "\n"
-			, info->register_num, to_alloc, hash_get_by_index(&info->arrays, index, i));
+		uni_print_string(info->sx->io, " %.");
+		uni_print_uint(info->sx->io, info->register_num);
+		uni_print_string(info->sx->io, " = mul nuw i32 %.");
+		uni_print_int(info->sx->io, to_alloc);
+		uni_print_string(info->sx->io, ", %.");
+		uni_print_int(info->sx->io, hash_get_by_index(&info->arrays, index, i));
+		uni_print_string(info->sx->io, "\n");
 		to_alloc = info->register_num++;
 	}
-	uni_printf(info->sx->io, " %%dynarr.%" PRIitem " = alloca ", hash_get_key(&info->arrays, index));
+	uni_print_string(info->sx->io, " %dynarr.");
+	uni_print_int(info->sx->io, hash_get_key(&info->arrays, index));
+	uni_print_string(info->sx->io, " = alloca ");
 	type_to_io(info, type);
-	uni_printf(info->sx->io, ", i32 %%.%" PRIitem ", align 4\n", to_alloc);
+	uni_print_string(info->sx->io, ", i32 %.");
+	uni_print_int(info->sx->io, to_alloc);
+	uni_print_string(info->sx->io, ", align 4\n");
 }
 
 static void to_code_slice(information *const info, const item_t id, const size_t cur_dimension
 	, const item_t prev_slice, const item_t type, const bool is_local)
 {
-	uni_printf(info->sx->io, " %%.%zu = getelementptr inbounds ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = getelementptr inbounds ");
 	const size_t dimensions = hash_get_amount(&info->arrays, id) - 1;
 
 	if (dimensions == SIZE_MAX)
@@ -562,58 +684,74 @@ static void to_code_slice(information *const info, const item_t id, const size_t
 	{
 		for (size_t i = dimensions - cur_dimension; i <= dimensions; i++)
 		{
-			uni_printf(info->sx->io, "[%" PRIitem " x ", hash_get(&info->arrays, id, i));
+			uni_print_string(info->sx->io, "[");
+			uni_print_int(info->sx->io, hash_get(&info->arrays, id, i));
+			uni_print_string(info->sx->io, " x ");
 		}
 		type_to_io(info, type);
 
 		for (size_t i = dimensions - cur_dimension; i <= dimensions; i++)
 		{
-			uni_printf(info->sx->io, "]");
+			uni_print_string(info->sx->io, "]");
 		}
-		uni_printf(info->sx->io, ", ");
+		uni_print_string(info->sx->io, ", ");
 
 		for (size_t i = dimensions - cur_dimension; i <= dimensions; i++)
 		{
-			uni_printf(info->sx->io, "[%" PRIitem " x ", hash_get(&info->arrays, id, i));
+			uni_print_string(info->sx->io, "[");
+			uni_print_int(info->sx->io, hash_get(&info->arrays, id, i));
+			uni_print_string(info->sx->io, " x ");
 		}
 		type_to_io(info, type);
 
 		for (size_t i = dimensions - cur_dimension; i <= dimensions; i++)
 		{
-			uni_printf(info->sx->io, "]");
+			uni_print_string(info->sx->io, "]");
 		}
 
 		if (cur_dimension == dimensions - 1)
 		{
-			uni_printf(info->sx->io, "* %sarr.%" PRIitem ", i32 0", is_local ? "%" : "@", id);
+			uni_print_string(info->sx->io, "* ");
+			uni_print_string(info->sx->io, is_local ? "%" : "@");
+			uni_print_string(info->sx->io, "arr.");
+			uni_print_int(info->sx->io, id);
+			uni_print_string(info->sx->io, ", i32 0");
 		}
 		else
 		{
-			uni_printf(info->sx->io, "* %%.%" PRIitem ", i32 0", prev_slice);
+			uni_print_string(info->sx->io, "* %.");
+			uni_print_int(info->sx->io, prev_slice);
+			uni_print_string(info->sx->io, ", i32 0");
 		}
 	}
 	else if (cur_dimension == dimensions - 1)
 	{
 		type_to_io(info, type);
-		uni_printf(info->sx->io, ", ");
+		uni_print_string(info->sx->io, ", ");
 		type_to_io(info, type);
-		uni_printf(info->sx->io, "* %%dynarr.%" PRIitem, id);
+		uni_print_string(info->sx->io, "* %dynarr.");
+		uni_print_int(info->sx->io, id);
 	}
 	else
 	{
 		type_to_io(info, type);
-		uni_printf(info->sx->io, ", ");
+		uni_print_string(info->sx->io, ", ");
 		type_to_io(info, type);
-		uni_printf(info->sx->io, "* %%.%" PRIitem, prev_slice);
+		uni_print_string(info->sx->io, "* %.");
+		uni_print_int(info->sx->io, prev_slice);
 	}
 
 	if (info->answer_kind == AREG)
 	{
-		uni_printf(info->sx->io, ", i32 %%.%zu\n", info->answer_reg);
+		uni_print_string(info->sx->io, ", i32 %.");
+		uni_print_uint(info->sx->io, info->answer_reg);
+		uni_print_string(info->sx->io, "\n");
 	}
 	else // if (info->answer_kind == ACONST)
 	{
-		uni_printf(info->sx->io, ", i32 %" PRIitem "\n", info->answer_const);
+		uni_print_string(info->sx->io, ", i32 ");
+		uni_print_int(info->sx->io, info->answer_const);
+		uni_print_string(info->sx->io, "\n");
 	}
 
 	info->register_num++;
@@ -621,13 +759,21 @@ static void to_code_slice(information *const info, const item_t id, const size_t
 
 static void to_code_int_to_char(information *const info, const size_t reg)
 {
-	uni_printf(info->sx->io, " %%.%zu = trunc i32 %%.%zu to i8\n", info->register_num, reg);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = trunc i32 %.");
+	uni_print_uint(info->sx->io, reg);
+	uni_print_string(info->sx->io, " to i8\n");
 	info->register_num++;
 }
 
 static void to_code_char_to_int(information *const info, const size_t reg)
 {
-	uni_printf(info->sx->io, " %%.%zu = zext i8 %%.%zu to i32\n", info->register_num, reg);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = zext i8 %.");
+	uni_print_uint(info->sx->io, reg);
+	uni_print_string(info->sx->io, " to i32\n");
 	info->register_num++;
 }
 
@@ -737,11 +883,15 @@ static void emit_cast_expression(information *const info, const node *const nd)
 	const node expression_to_cast = expression_cast_get_operand(nd);
 	emit_expression(info, &expression_to_cast);
 
-	uni_printf(info->sx->io, " %%.%zu = sitofp ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = sitofp ");
 	type_to_io(info, source_type);
-	uni_printf(info->sx->io, " %%.%zu to ", info->answer_reg);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->answer_reg);
+	uni_print_string(info->sx->io, " to ");
 	type_to_io(info, target_type);
-	uni_printf(info->sx->io, "\n");
+	uni_print_string(info->sx->io, "\n");
 
 	info->answer_reg = info->register_num++;
 }
@@ -1054,16 +1204,18 @@ static void emit_call_expression(information *const info, const node *const nd)
 
 	if (!type_is_void(func_type))
 	{
-		uni_printf(info->sx->io, " %%.%zu =", info->register_num);
+		uni_print_string(info->sx->io, " %.");
+		uni_print_uint(info->sx->io, info->register_num);
+		uni_print_string(info->sx->io, " =");
 		info->answer_kind = AREG;
 		info->answer_reg = info->register_num++;
 	}
-	uni_printf(info->sx->io, " call ");
+	uni_print_string(info->sx->io, " call ");
 
 	if (func_ref == BI_ROUND)
 	{
 		type_to_io(info, TYPE_FLOATING);
-		uni_printf(info->sx->io, " @llvm.round.f64(");
+		uni_print_string(info->sx->io, " @llvm.round.f64(");
 	}
 	else
 	{
@@ -1072,21 +1224,22 @@ static void emit_call_expression(information *const info, const node *const nd)
 		info->is_call = false;
 		if (ident_is_local(info->sx, func_ref))
 		{
-			uni_printf(info->sx->io, " @");
+			uni_print_string(info->sx->io, " @");
 			func_name_to_io(info, func_ref);
 		}
 		else
 		{
-			uni_printf(info->sx->io, " %%.%zu", func_reg);
+			uni_print_string(info->sx->io, " %.");
+			uni_print_uint(info->sx->io, func_reg);
 		}
-		uni_printf(info->sx->io, "(");
+		uni_print_string(info->sx->io, "(");
 	}
 
 	for (size_t i = 0; i < args; i++)
 	{
 		if (i != 0)
 		{
-			uni_printf(info->sx->io, ", ");
+			uni_print_string(info->sx->io, ", ");
 		}
 
 		if (arguments_type[i] == ASTR)
@@ -1094,11 +1247,13 @@ static void emit_call_expression(information *const info, const node *const nd)
 			const size_t index = (size_t)arguments[i];
 			const size_t string_length = strings_length(info->sx, index);
 
-			uni_printf(info->sx->io, "i8* getelementptr inbounds "
-				"([%zu x i8], [%zu x i8]* @.str%zu, i32 0, i32 0)"
-				, string_length + 1
-				, string_length + 1
-				, index);
+			uni_print_string(info->sx->io, "i8* getelementptr inbounds ([");
+			uni_print_uint(info->sx->io, string_length + 1);
+			uni_print_string(info->sx->io, " x i8], [");
+			uni_print_uint(info->sx->io, string_length + 1);
+			uni_print_string(info->sx->io, " x i8]* @.str");
+			uni_print_uint(info->sx->io, index);
+			uni_print_string(info->sx->io, ", i32 0, i32 0)");
 
 			continue;
 		}
@@ -1128,42 +1283,52 @@ static void emit_call_expression(information *const info, const node *const nd)
 			const node argument = expression_call_get_argument(nd, i);
 			const size_t id = expression_identifier_get_id(&argument);
 
-			uni_printf(info->sx->io, " @");
+			uni_print_string(info->sx->io, " @");
 			func_name_to_io(info, id);
 		}
 		else if (arguments_type[i] == AREG || arguments_type[i] == ALOGIC)
 		{
-			uni_printf(info->sx->io, " %%.%" PRIitem, arguments[i]);
+			uni_print_string(info->sx->io, " %.");
+			uni_print_int(info->sx->io, arguments[i]);
 		}
 		else if (arguments_type[i] == ASTR)
 		{
 			const size_t index = (size_t)arguments[i];
 			const size_t string_length = strings_length(info->sx, index);
 
-			uni_printf(info->sx->io, "i8* getelementptr inbounds "
-				"([%zu x i8], [%zu x i8]* @.str%zu, i32 0, i32 0)"
-				, string_length + 1
-				, string_length + 1
-				, index);
+			uni_print_string(info->sx->io, "i8* getelementptr inbounds ([");
+			uni_print_uint(info->sx->io, string_length + 1);
+			uni_print_string(info->sx->io, " x i8], [");
+			uni_print_uint(info->sx->io, string_length + 1);
+			uni_print_string(info->sx->io, " x i8]* @.str");
+			uni_print_uint(info->sx->io, index);
+			uni_print_string(info->sx->io, ", i32 0, i32 0)");
 		}
 		else if (type_is_integer(info->sx, arguments_value_type[i])) // ACONST
 		{
-			uni_printf(info->sx->io, " %" PRIitem, arguments[i]);
+			uni_print_string(info->sx->io, " ");
+			uni_print_int(info->sx->io, arguments[i]);
 		}
 		else if (type_is_boolean(arguments_value_type[i]))
 		{
-			uni_printf(info->sx->io, " %s", arguments_bool[i] ? "true" : "false");
+			uni_print_string(info->sx->io, " ");
+			uni_print_string(info->sx->io, arguments_bool[i] ? "true" : "false");
 		}
 		else // double
 		{
-			uni_printf(info->sx->io, " %f", arguments_double[i]);
+			uni_print_string(info->sx->io, " ");
+			uni_printf(info->sx->io, "%f", arguments_double[i]);
 		}
 	}
-	uni_printf(info->sx->io, ")\n");
+	uni_print_string(info->sx->io, ")\n");
 
 	if (func_ref == BI_ROUND)
 	{
-		uni_printf(info->sx->io, " %%.%zu = fptosi double %%.%zu to i32\n", info->register_num, info->answer_reg);
+		uni_print_string(info->sx->io, " %.");
+		uni_print_uint(info->sx->io, info->register_num);
+		uni_print_string(info->sx->io, " = fptosi double %.");
+		uni_print_uint(info->sx->io, info->answer_reg);
+		uni_print_string(info->sx->io, " to i32\n");
 		info->answer_reg = info->register_num++;
 	}
 }
@@ -1272,16 +1437,33 @@ static void emit_member_expression(information *const info, const node *const nd
 		is_complex = true;
 		info->variable_location = loc;
 
-		uni_printf(info->sx->io, " %%.%zu = extractvalue %%struct_opt.%" PRIitem " %%.%zu, %" PRIitem "\n"
-			, info->register_num, type, info->register_num - 1, place);
+		uni_print_string(info->sx->io, " %.");
+		uni_print_uint(info->sx->io, info->register_num);
+		uni_print_string(info->sx->io, " = extractvalue %struct_opt.");
+		uni_print_int(info->sx->io, type);
+		uni_print_string(info->sx->io, " %.");
+		uni_print_uint(info->sx->io, info->register_num - 1);
+		uni_print_string(info->sx->io, ", ");
+		uni_print_int(info->sx->io, place);
+		uni_print_string(info->sx->io, "\n");
 
 		info->answer_reg = info->register_num++;
 		return;
 	}
 
-	uni_printf(info->sx->io, " %%.%zu = getelementptr inbounds %%struct_opt.%" PRIitem ", " 
-		"%%struct_opt.%" PRIitem "* %s.%zu, i32 0, i32 %" PRIitem "\n", info->register_num, type, type
-		, is_complex ? "%" : (ident_is_local(info->sx, id) ? "%var" : "@var"), is_complex ? info->register_num - 1 : id, place);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = getelementptr inbounds %struct_opt.");
+	uni_print_int(info->sx->io, type);
+	uni_print_string(info->sx->io, ", %struct_opt.");
+	uni_print_int(info->sx->io, type);
+	uni_print_string(info->sx->io, "* ");
+	uni_print_string(info->sx->io, is_complex ? "%" : (ident_is_local(info->sx, id) ? "%var" : "@var"));
+	uni_print_string(info->sx->io, ".");
+	uni_print_uint(info->sx->io, is_complex ? info->register_num - 1 : id);
+	uni_print_string(info->sx->io, ", i32 0, i32 ");
+	uni_print_int(info->sx->io, place);
+	uni_print_string(info->sx->io, "\n");
 
 	if (info->variable_location != LMEM)
 	{
@@ -1457,22 +1639,26 @@ static void emit_unary_expression(information *const info, const node *const nd)
 			info->variable_location = LFREE;
 			emit_expression(info, &operand);
 
-			uni_printf(info->sx->io, " %%.%zu = call ", info->register_num);
+			uni_print_string(info->sx->io, " %.");
+			uni_print_uint(info->sx->io, info->register_num);
+			uni_print_string(info->sx->io, " = call ");
 			type_to_io(info, type);
 
 			if (type_is_integer(info->sx, type))
 			{
-				uni_printf(info->sx->io, " @abs(");
+				uni_print_string(info->sx->io, " @abs(");
 				info->was_abs = true;
 			}
 			else
 			{
-				uni_printf(info->sx->io, " @llvm.fabs.f64(");
+				uni_print_string(info->sx->io, " @llvm.fabs.f64(");
 				info->was_fabs = true;
 			}
 
 			type_to_io(info, type);
-			uni_printf(info->sx->io, " %%.%zu)\n", info->answer_reg);
+			uni_print_string(info->sx->io, " %.");
+			uni_print_uint(info->sx->io, info->answer_reg);
+			uni_print_string(info->sx->io, ")\n");
 
 			info->answer_kind = AREG;
 			info->answer_reg = info->register_num++;
@@ -1496,7 +1682,11 @@ static void emit_unary_expression(information *const info, const node *const nd)
 						upb *= (size_t)hash_get(&info->arrays, id, i);
 					}
 
-					uni_printf(info->sx->io, " %%.%zu = add nsw i32 0, %zu\n", info->register_num, upb);
+					uni_print_string(info->sx->io, " %.");
+					uni_print_uint(info->sx->io, info->register_num);
+					uni_print_string(info->sx->io, " = add nsw i32 0, ");
+					uni_print_uint(info->sx->io, upb);
+					uni_print_string(info->sx->io, "\n");
 					info->answer_kind = AREG;
 					info->answer_reg = info->register_num++;
 				}
@@ -1506,8 +1696,13 @@ static void emit_unary_expression(information *const info, const node *const nd)
 
 					for (size_t i = 2; i <= dimensions; i++)
 					{
-						uni_printf(info->sx->io, " %%.%zu = mul nsw i32 %%.%zu, %%.%zu\n"
-							, info->register_num, upb_reg, (size_t)hash_get(&info->arrays, id, i));
+						uni_print_string(info->sx->io, " %.");
+						uni_print_uint(info->sx->io, info->register_num);
+						uni_print_string(info->sx->io, " = mul nsw i32 %.");
+						uni_print_uint(info->sx->io, upb_reg);
+						uni_print_string(info->sx->io, ", %.");
+						uni_print_uint(info->sx->io, (size_t)hash_get(&info->arrays, id, i));
+						uni_print_string(info->sx->io, "\n");
 						upb_reg = info->register_num++;
 					}
 
@@ -1823,9 +2018,18 @@ static void emit_binary_expression(information *const info, const node *const nd
 			if (!is_logic)
 			{
 				to_code_label(info, info->label_false);
-				uni_printf(info->sx->io, " %%.%zu = phi i1 [ %s, %%%s%zu ], [ %%.%zu, %%label%zu ]\n", info->register_num
-					, operator == BIN_LOG_OR ? "true" : "false", info->label_phi_previous == 0 ? "" : "label"
-					, info->label_phi_previous, info->register_num - 1, label_next);
+				uni_print_string(info->sx->io, " %.");
+				uni_print_uint(info->sx->io, info->register_num);
+				uni_print_string(info->sx->io, " = phi i1 [ ");
+				uni_print_string(info->sx->io, operator == BIN_LOG_OR ? "true" : "false");
+				uni_print_string(info->sx->io, ", %");
+				uni_print_string(info->sx->io, info->label_phi_previous == 0 ? "" : "label");
+				uni_print_uint(info->sx->io, info->label_phi_previous);
+				uni_print_string(info->sx->io, " ], [ %.");
+				uni_print_uint(info->sx->io, info->register_num - 1);
+				uni_print_string(info->sx->io, ", %label");
+				uni_print_uint(info->sx->io, label_next);
+				uni_print_string(info->sx->io, " ]\n");
 
 				info->label_phi_previous = info->label_false;
 				info->answer_reg = info->register_num;
@@ -1914,12 +2118,22 @@ static void emit_ternary_expression(information *const info, const node *const n
 	to_code_unconditional_branch(info, label_end);
 	to_code_label(info, label_end);
 
-	uni_printf(info->sx->io, " %%.%zu = phi ", info->register_num);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->register_num);
+	uni_print_string(info->sx->io, " = phi ");
 	type_to_io(info, expression_get_type(nd));
-	uni_printf(info->sx->io, " [ %s%" PRIitem ", %%label%zu ]", then_answer == AREG ? "%." : ""
-		, then_answer == AREG ? then_reg : then_const, label_then);
-	uni_printf(info->sx->io, ", [ %s%" PRIitem ", %%label%zu ]\n", else_answer == AREG ? "%." : ""
-		, else_answer == AREG ? else_reg : else_const, label_else);
+	uni_print_string(info->sx->io, " [ ");
+	uni_print_string(info->sx->io, then_answer == AREG ? "%." : "");
+	uni_print_int(info->sx->io, then_answer == AREG ? then_reg : then_const);
+	uni_print_string(info->sx->io, ", %label");
+	uni_print_uint(info->sx->io, label_then);
+	uni_print_string(info->sx->io, " ]");
+	uni_print_string(info->sx->io, ", [ ");
+	uni_print_string(info->sx->io, else_answer == AREG ? "%." : "");
+	uni_print_int(info->sx->io, else_answer == AREG ? else_reg : else_const);
+	uni_print_string(info->sx->io, ", %label");
+	uni_print_uint(info->sx->io, label_else);
+	uni_print_string(info->sx->io, " ]\n");
 
 	info->answer_kind = AREG;
 	info->answer_reg = info->register_num++;
@@ -1949,9 +2163,17 @@ static void emit_initializer_expression(information *const info, const node *con
 			const node initializer = expression_initializer_get_subexpr(nd, i);
 			emit_expression(info, &initializer);
 
-			uni_printf(info->sx->io, " %%.%zu = getelementptr inbounds %%struct_opt.%zu, " 
-			"%%struct_opt.%zu* %%.%zu, i32 0, i32 %zu\n", info->register_num
-				, structure_type, structure_type, slice_reg, i);
+			uni_print_string(info->sx->io, " %.");
+			uni_print_uint(info->sx->io, info->register_num);
+			uni_print_string(info->sx->io, " = getelementptr inbounds %struct_opt.");
+			uni_print_uint(info->sx->io, structure_type);
+			uni_print_string(info->sx->io, ", %struct_opt.");
+			uni_print_uint(info->sx->io, structure_type);
+			uni_print_string(info->sx->io, "* %.");
+			uni_print_uint(info->sx->io, slice_reg);
+			uni_print_string(info->sx->io, ", i32 0, i32 ");
+			uni_print_uint(info->sx->io, i);
+			uni_print_string(info->sx->io, "\n");
 
 			to_code_store_const_integer(info, info->answer_const, info->register_num, true, true
 				, expression_get_type(&initializer));
@@ -2175,9 +2397,17 @@ static void emit_initialization(information *const info, const node *const nd, c
 				const item_t type = expression_get_type(&initializer);
 
 				const size_t member_reg = (size_t)info->register_num;
-				uni_printf(info->sx->io, " %%.%zu = getelementptr inbounds %%struct_opt.%" PRIitem
-					", %%struct_opt.%" PRIitem "* %%var.%" PRIitem ", i32 0, i32 %zu\n"
-					, info->register_num, arr_type, arr_type, id, i);
+				uni_print_string(info->sx->io, " %.");
+				uni_print_uint(info->sx->io, info->register_num);
+				uni_print_string(info->sx->io, " = getelementptr inbounds %struct_opt.");
+				uni_print_int(info->sx->io, arr_type);
+				uni_print_string(info->sx->io, ", %struct_opt.");
+				uni_print_int(info->sx->io, arr_type);
+				uni_print_string(info->sx->io, "* %var.");
+				uni_print_int(info->sx->io, id);
+				uni_print_string(info->sx->io, ", i32 0, i32 ");
+				uni_print_uint(info->sx->io, i);
+				uni_print_string(info->sx->io, "\n");
 				info->register_num++;
 
 				emit_expression(info, &initializer);
@@ -2200,7 +2430,9 @@ static void emit_initialization(information *const info, const node *const nd, c
 		}
 		else
 		{
-			uni_printf(info->sx->io, "global %%struct_opt.%" PRIitem " { ", arr_type);
+			uni_print_string(info->sx->io, "global %struct_opt.");
+			uni_print_int(info->sx->io, arr_type);
+			uni_print_string(info->sx->io, " { ");
 
 			for (size_t i = 0; i < N && N != SIZE_MAX; i++)
 			{
@@ -2211,22 +2443,24 @@ static void emit_initialization(information *const info, const node *const nd, c
 
 				if (i != 0)
 				{
-					uni_printf(info->sx->io, ", ");
+					uni_print_string(info->sx->io, ", ");
 				}
 
 				// константа типа int
 				if (type_is_integer(info->sx, type))
 				{
-					uni_printf(info->sx->io, "i32 %" PRIitem, info->answer_const);
+					uni_print_string(info->sx->io, "i32 ");
+					uni_print_int(info->sx->io, info->answer_const);
 				}
 				// константа типа double
 				else
 				{
-					uni_printf(info->sx->io, "double %f", info->answer_const_double);
+					uni_print_string(info->sx->io, "double ");
+					uni_printf(info->sx->io, "%f", info->answer_const_double);
 				}
 			}
 
-			uni_printf(info->sx->io, " }, align 4\n");
+			uni_print_string(info->sx->io, " }, align 4\n");
 		}
 	}
 	else if (expression_get_class(nd) == EXPR_CALL && type_is_structure(info->sx, expression_get_type(nd)))
@@ -2262,9 +2496,11 @@ static void emit_variable_declaration(information *const info, const node *const
 
 	if (!type_is_array(info->sx, type) && is_local) // обычная переменная int a; или struct point p;
 	{
-		uni_printf(info->sx->io, " %%var.%zu = alloca ", id);
+		uni_print_string(info->sx->io, " %var.");
+		uni_print_uint(info->sx->io, id);
+		uni_print_string(info->sx->io, " = alloca ");
 		type_to_io(info, type);
-		uni_printf(info->sx->io, ", align 4\n");
+		uni_print_string(info->sx->io, ", align 4\n");
 
 		if (declaration_variable_has_initializer(nd))
 		{
@@ -2343,7 +2579,9 @@ static void emit_variable_declaration(information *const info, const node *const
 	}
 	else if (!type_is_array(info->sx, type) && !is_local) // глобальные переменные
 	{
-		uni_printf(info->sx->io, "@var.%zu = ", id);
+		uni_print_string(info->sx->io, "@var.");
+		uni_print_uint(info->sx->io, id);
+		uni_print_string(info->sx->io, " = ");
 
 		if (declaration_variable_has_initializer(nd))
 		{
@@ -2362,44 +2600,48 @@ static void emit_variable_declaration(information *const info, const node *const
 
 			if (info->answer_kind == ACONST)
 			{
-				uni_printf(info->sx->io, "global ");
+				uni_print_string(info->sx->io, "global ");
 				type_to_io(info, type);
 				if (type_is_integer(info->sx, type))
 				{
-					uni_printf(info->sx->io, " %" PRIitem ", align 4\n", info->answer_const);
+					uni_print_string(info->sx->io, " ");
+					uni_print_int(info->sx->io, info->answer_const);
+					uni_print_string(info->sx->io, ", align 4\n");
 				}
 				else
 				{
-					uni_printf(info->sx->io, " %f, align 4\n", info->answer_const_double);
+					uni_print_string(info->sx->io, " ");
+					uni_printf(info->sx->io, "%f", info->answer_const_double);
+					uni_print_string(info->sx->io, ", align 4\n");
 				}
 			}
 		}
 		else
 		{
-			uni_printf(info->sx->io, "common global ");
+			uni_print_string(info->sx->io, "common global ");
 			type_to_io(info, type);
 
 			if (type_is_integer(info->sx, type))
 			{
-				uni_printf(info->sx->io, " 0");
+				uni_print_string(info->sx->io, " 0");
 			}
 			else if (type_is_floating(type))
 			{
-				uni_printf(info->sx->io, " 0.0");
+				uni_print_string(info->sx->io, " 0.0");
 			}
 			else if (type_is_boolean(type))  
 			{
-				uni_printf(info->sx->io, " false");
+				uni_print_string(info->sx->io, " false");
 			}
 			else if (type_is_structure(info->sx, type))
 			{
-				uni_printf(info->sx->io, " zeroinitializer");
+				uni_print_string(info->sx->io, " zeroinitializer");
 			}
 			else if (type_is_pointer(info->sx, type))
 			{
-				uni_printf(info->sx->io, " null");
+				uni_print_string(info->sx->io, " null");
 			}
-			uni_printf(info->sx->io, ", align 4\n");
+			uni_print_string(info->sx->io, ", align 4\n");
 		}
 	}
 	else // массив
@@ -2478,52 +2720,62 @@ static void emit_function_definition(information *const info, const node *const
 	const size_t parameters = type_function_get_parameter_amount(info->sx, func_type);
 	info->was_dynamic = false;
 
-	uni_printf(info->sx->io, "define ");
+	uni_print_string(info->sx->io, "define ");
 	type_to_io(info, ret_type);
 	
 	if (ref_ident == info->sx->ref_main)
 	{
-		uni_printf(info->sx->io, " @main(");
+		uni_print_string(info->sx->io, " @main(");
 		info->is_main = true;
 	}
 	else
 	{
-		uni_printf(info->sx->io, " @");
+		uni_print_string(info->sx->io, " @");
 		func_name_to_io(info, ref_ident);
-		uni_printf(info->sx->io, "(");
+		uni_print_string(info->sx->io, "(");
 	}
 
 	for (size_t i = 0; i < parameters; i++)
 	{
-		uni_printf(info->sx->io, i == 0 ? "" : ", ");
+		uni_print_string(info->sx->io, i == 0 ? "" : ", ");
 
 		const item_t param_type = type_function_get_parameter_type(info->sx, func_type, i);
 		type_to_io(info, param_type);
 	}
-	uni_printf(info->sx->io, ") {\n");
+	uni_print_string(info->sx->io, ") {\n");
 
 	for (size_t i = 0; i < parameters; i++)
 	{
 		const size_t id = declaration_function_get_param(nd, i);
 		const item_t param_type = ident_get_type(info->sx, id);
 
-		uni_printf(info->sx->io, " %%var.%zu = alloca ", id);
+		uni_print_string(info->sx->io, " %var.");
+		uni_print_uint(info->sx->io, id);
+		uni_print_string(info->sx->io, " = alloca ");
 		type_to_io(info, param_type);
-		uni_printf(info->sx->io, ", align 4\n");
+		uni_print_string(info->sx->io, ", align 4\n");
 
-		uni_printf(info->sx->io, " store ");
+		uni_print_string(info->sx->io, " store ");
 		type_to_io(info, param_type);
-		uni_printf(info->sx->io, " %%%zu, ", i);
+		uni_print_string(info->sx->io, " %");
+		uni_print_uint(info->sx->io, i);
+		uni_print_string(info->sx->io, ", ");
 		type_to_io(info, param_type);
-		uni_printf(info->sx->io, "* %%var.%zu, align 4\n", id);
+		uni_print_string(info->sx->io, "* %var.");
+		uni_print_uint(info->sx->io, id);
+		uni_print_string(info->sx->io, ", align 4\n");
 
 		if (type_is_array(info->sx, param_type))
 		{
-			uni_printf(info->sx->io, " %%dynarr.%zu = load ", id);
+			uni_print_string(info->sx->io, " %dynarr.");
+			uni_print_uint(info->sx->io, id);
+			uni_print_string(info->sx->io, " = load ");
 			type_to_io(info, param_type);
-			uni_printf(info->sx->io, ", ");
+			uni_print_string(info->sx->io, ", ");
 			type_to_io(info, param_type);
-			uni_printf(info->sx->io, "* %%var.%zu, align 4\n", id);
+			uni_print_string(info->sx->io, "* %var.");
+			uni_print_uint(info->sx->io, id);
+			uni_print_string(info->sx->io, ", align 4\n");
 
 			const size_t dimensions = array_get_dim(info, param_type);
 			const size_t index = hash_add(&info->arrays, id, 1 + dimensions);
@@ -2545,15 +2797,15 @@ static void emit_function_definition(information *const info, const node *const
 		{
 			to_code_stack_load(info, -1);
 		}
-		uni_printf(info->sx->io, " ret void\n");
+		uni_print_string(info->sx->io, " ret void\n");
 	}
 	else if (ref_ident == info->sx->ref_main)
 	{
-		uni_printf(info->sx->io, " ret i32 0\n");
+		uni_print_string(info->sx->io, " ret i32 0\n");
 		info->is_main = false;
 	}
-	uni_printf(info->sx->io, " unreachable\n");
-	uni_printf(info->sx->io, "}\n\n");
+	uni_print_string(info->sx->io, " unreachable\n");
+	uni_print_string(info->sx->io, "}\n\n");
 }
 
 static void emit_declaration(information *const info, const node *const nd, const bool is_local)
@@ -2853,22 +3105,28 @@ static void emit_return_statement(information *const info, const node *const nd)
 		const item_t answer_type = expression_get_type(&expression);
 		if (info->answer_kind == ACONST && type_is_integer(info->sx, answer_type))
 		{
-			uni_printf(info->sx->io, " ret i32 %" PRIitem "\n", info->answer_const);
+			uni_print_string(info->sx->io, " ret i32 ");
+			uni_print_int(info->sx->io, info->answer_const);
+			uni_print_string(info->sx->io, "\n");
 		}
 		else if (info->answer_kind == ACONST && type_is_floating(answer_type))
 		{
-			uni_printf(info->sx->io, " ret double %f\n", info->answer_const_double);
+			uni_print_string(info->sx->io, " ret double ");
+			uni_printf(info->sx->io, "%f", info->answer_const_double);
+			uni_print_string(info->sx->io, "\n");
 		}
 		else if (info->answer_kind == AREG)
 		{
-			uni_printf(info->sx->io, " ret ");
+			uni_print_string(info->sx->io, " ret ");
 			type_to_io(info, answer_type);
-			uni_printf(info->sx->io, " %%.%zu\n", info->answer_reg);
+			uni_print_string(info->sx->io, " %.");
+			uni_print_uint(info->sx->io, info->answer_reg);
+			uni_print_string(info->sx->io, "\n");
 		}
 	}
 	else
 	{
-		uni_printf(info->sx->io, " ret void\n");
+		uni_print_string(info->sx->io, " ret void\n");
 	}
 }
 
@@ -2942,16 +3200,24 @@ static void emit_switch_statement(information *const info, const node *const nd)
 		}
 	}
 
-	uni_printf(info->sx->io, " switch ");
+	uni_print_string(info->sx->io, " switch ");
 	type_to_io(info, expression_get_type(&condition));
-	uni_printf(info->sx->io, " %%.%zu, label %%label%zu [\n", info->answer_reg, info->label_switch - case_num - has_default);
+	uni_print_string(info->sx->io, " %.");
+	uni_print_uint(info->sx->io, info->answer_reg);
+	uni_print_string(info->sx->io, ", label %label");
+	uni_print_uint(info->sx->io, info->label_switch - case_num - has_default);
+	uni_print_string(info->sx->io, " [\n");
 	for (size_t i = 0; i < case_num; i++)
 	{
-		uni_printf(info->sx->io, "  ");
+		uni_print_string(info->sx->io, "  ");
 		type_to_io(info, expression_get_type(&condition));
-		uni_printf(info->sx->io, " %" PRIitem ", label %%label%zu\n", case_values[i], info->label_switch - i);
+		uni_print_string(info->sx->io, " ");
+		uni_print_int(info->sx->io, case_values[i]);
+		uni_print_string(info->sx->io, ", label %label");
+		uni_print_uint(info->sx->io, info->label_switch - i);
+		uni_print_string(info->sx->io, "\n");
 	}
-	uni_printf(info->sx->io, " ]\n");
+	uni_print_string(info->sx->io, " ]\n");
 
 	info->label_break = info->label_switch - case_num - has_default;
 	if (statement_get_class(&body) == STMT_COMPOUND)
@@ -3066,32 +3332,32 @@ static int emit_translation_unit(information *const info, const node *const nd)
 	// FIXME: если это тоже объявление функций, почему тут, а не в functions_declaration?
 	if (info->was_stack_functions)
 	{
-		uni_printf(info->sx->io, "declare i8* @llvm.stacksave()\n");
-		uni_printf(info->sx->io, "declare void @llvm.stackrestore(i8*)\n");
+		uni_print_string(info->sx->io, "declare i8* @llvm.stacksave()\n");
+		uni_print_string(info->sx->io, "declare void @llvm.stackrestore(i8*)\n");
 	}
 
 	if (info->was_file)
 	{
-		uni_printf(info->sx->io, "%%struct._IO_FILE = type { i32, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, "
-			"%%struct._IO_marker*, %%struct._IO_FILE*, i32, i32, i64, i16, i8, [1 x i8], i8*, i64, i8*, i8*, i8*, i8*, "
+		uni_print_string(info->sx->io, "%struct._IO_FILE = type { i32, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, i8*, "
+			"%struct._IO_marker*, %struct._IO_FILE*, i32, i32, i64, i16, i8, [1 x i8], i8*, i64, i8*, i8*, i8*, i8*, "
 			"i64, i32, [20 x i8] }\n");
-		uni_printf(info->sx->io, "%%struct._IO_marker = type { %%struct._IO_marker*, %%struct._IO_FILE*, i32 }\n");
+		uni_print_string(info->sx->io, "%struct._IO_marker = type { %struct._IO_marker*, %struct._IO_FILE*, i32 }\n");
 	}
 
 	if (info->was_abs)
 	{
-		uni_printf(info->sx->io, "declare i32 @abs(i32)\n");
+		uni_print_string(info->sx->io, "declare i32 @abs(i32)\n");
 	}
 
 	if (info->was_fabs)
 	{
-		uni_printf(info->sx->io, "declare double @llvm.fabs.f64(double)\n");
+		uni_print_string(info->sx->io, "declare double @llvm.fabs.f64(double)\n");
 	}
 
 
 	#ifdef _MSC_VER
-		uni_printf(info->sx->io, "!llvm.linker.options = !{!0}\n");
-		uni_printf(info->sx->io, "!0 = !{!\"/STACK:268435456\"}\n");
+		uni_print_string(info->sx->io, "!llvm.linker.options = !{!0}\n");
+		uni_print_string(info->sx->io, "!0 = !{!\"/STACK:268435456\"}\n");
 	#endif
 
 	return info->sx->rprt.errors != 0;
@@ -3105,14 +3371,14 @@ static void architecture(const workspace *const ws, syntax *const sx)
 
 		if (flag == NULL || strcmp(flag, "--x86_64") == 0)
 		{
-			uni_printf(sx->io, "target datalayout = \"e-m:e-i64:64-f80:128-n8:16:32:64-S128\"\n");
-			uni_printf(sx->io, "target triple = \"x86_64-pc-linux-gnu\"\n\n");
+			uni_print_string(sx->io, "target datalayout = \"e-m:e-i64:64-f80:128-n8:16:32:64-S128\"\n");
+			uni_print_string(sx->io, "target triple = \"x86_64-pc-linux-gnu\"\n\n");
 			return;
 		}
 		else if (strcmp(flag, "--mipsel") == 0)
 		{
-			uni_printf(sx->io, "target datalayout = \"e-m:m-p:32:32-i8:8:32-i16:16:32-i64:64-n32-S64\"\n");
-			uni_printf(sx->io, "target triple = \"mipsel\"\n\n");
+			uni_print_string(sx->io, "target datalayout = \"e-m:m-p:32:32-i8:8:32-i16:16:32-i64:64-n32-S64\"\n");
+			uni_print_string(sx->io, "target triple = \"mipsel\"\n\n");
 			return;
 		}
 	}
@@ -3125,19 +3391,21 @@ static void structs_declaration(information *const info)
 	{
 		if (type_is_structure(info->sx, (item_t)i))
 		{
-			uni_printf(info->sx->io, "%%struct_opt.%zu = type { ", i);
+			uni_print_string(info->sx->io, "%struct_opt.");
+			uni_print_uint(info->sx->io, i);
+			uni_print_string(info->sx->io, " = type { ");
 
 			const size_t fields = type_structure_get_member_amount(info->sx, (item_t)i);
 			for (size_t j = 0; j < fields; j++)
 			{
-				uni_printf(info->sx->io, j == 0 ? "" : ", ");
+				uni_print_string(info->sx->io, j == 0 ? "" : ", ");
 				const item_t type_structure_field = type_structure_get_member_type(info->sx, (item_t)i, j);
 
 				if (type_is_array(info->sx, type_structure_field))
 				{
 					// const size_t dimensions = array_get_dim(info, type_structure_field);
 					// const item_t element_type = array_get_type(info, type_structure_field);
-					uni_printf(info->sx->io, "here");
+					uni_print_string(info->sx->io, "here");
 				}
 				else
 				{
@@ -3145,10 +3413,10 @@ static void structs_declaration(information *const info)
 				}
 			}
 
-			uni_printf(info->sx->io, " }\n");
+			uni_print_string(info->sx->io, " }\n");
 		}
 	}
-	uni_printf(info->sx->io, " \n");
+	uni_print_string(info->sx->io, " \n");
 }
 
 static void strings_declaration(information *const info)
@@ -3158,24 +3426,27 @@ static void strings_declaration(information *const info)
 	{
 		const char *string = string_get(info->sx, i);
 		const size_t length = strings_length(info->sx, i);
-		uni_printf(info->sx->io, "@.str%zu = private unnamed_addr constant [%zu x i8] c\""
-			, i, length + 1);
+		uni_print_string(info->sx->io, "@.str");
+		uni_print_uint(info->sx->io, i);
+		uni_print_string(info->sx->io, " = private unnamed_addr constant [");
+		uni_print_uint(info->sx->io, length + 1);
+		uni_print_string(info->sx->io, " x i8] c\"");
 
 		for (size_t j = 0; j < length; j++)
 		{
 			const char ch = string[j];
 			if (ch == '\n')
 			{
-				uni_printf(info->sx->io, "\\0A");
+				uni_print_string(info->sx->io, "\\0A");
 			}
 			else
 			{
 				uni_printf(info->sx->io, "%c", ch);
 			}
 		}
-		uni_printf(info->sx->io, "\\00\", align 1\n");
+		uni_print_string(info->sx->io, "\\00\", align 1\n");
 	}
-	uni_printf(info->sx->io, " \n");
+	uni_print_string(info->sx->io, " \n");
 }
 
 
@@ -3195,23 +3466,23 @@ static void builin_functions_declaration(information *const info)
 			const item_t ret_type = type_function_get_return_type(info->sx, func_type);
 			const size_t parameters = type_function_get_parameter_amount(info->sx, func_type);
 
-			uni_printf(info->sx->io, "declare ");
+			uni_print_string(info->sx->io, "declare ");
 			if (i == BI_ROUND)
 			{
 				type_to_io(info, TYPE_FLOATING);
-				uni_printf(info->sx->io, " @llvm.round.f64(");
+				uni_print_string(info->sx->io, " @llvm.round.f64(");
 			}
 			else
 			{
 				type_to_io(info, ret_type);
-				uni_printf(info->sx->io, " @");
+				uni_print_string(info->sx->io, " @");
 				func_name_to_io(info, i);
-				uni_printf(info->sx->io, "(");
+				uni_print_string(info->sx->io, "(");
 			}
 
 			for (size_t j = 0; j < parameters; j++)
 			{
-				uni_printf(info->sx->io, j == 0 ? "" : ", ");
+				uni_print_string(info->sx->io, j == 0 ? "" : ", ");
 
 				item_t type_parameter = type_function_get_parameter_type(info->sx, func_type, j);
 				if (type_is_pointer(info->sx, type_parameter))
@@ -3223,7 +3494,7 @@ static void builin_functions_declaration(information *const info)
 				}
 				type_to_io(info, type_parameter);
 			}
-			uni_printf(info->sx->io, ")\n");
+			uni_print_string(info->sx->io, ")\n");
 		}
 	}
 }
@@ -3233,38 +3504,38 @@ static void builin_functions_declaration(information *const info)
 static void runtime(information *const info)
 {
 	// assert
-	uni_printf(info->sx->io, "@.str = private unnamed_addr constant [3 x i8] c\"%%s\\00\", align 1\n"
+	uni_print_string(info->sx->io, "@.str = private unnamed_addr constant [3 x i8] c\"%s\\00\", align 1\n"
 		"define void @assert(i1, i8*) {\n"
-		" %%3 = alloca i1, align 4\n"
-		" %%4 = alloca i8*, align 8\n"
-		" store i1 %%0, i1* %%3, align 4\n"
-		" store i8* %%1, i8** %%4, align 8\n"
-		" %%5 = load i1, i1* %%3, align 4\n"
-		" br i1 %%5, label %%9, label %%6\n"
-		" ; <label>:6:                                      ; preds = %%2\n"
-		" %%7 = load i8*, i8** %%4, align 8\n"
-		" %%8 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str, i32 0, i32 0), i8* %%7)\n"
+		" %3 = alloca i1, align 4\n"
+		" %4 = alloca i8*, align 8\n"
+		" store i1 %0, i1* %3, align 4\n"
+		" store i8* %1, i8** %4, align 8\n"
+		" %5 = load i1, i1* %3, align 4\n"
+		" br i1 %5, label %9, label %6\n"
+		" ; <label>:6:                                      ; preds = %2\n"
+		" %7 = load i8*, i8** %4, align 8\n"
+		" %8 = call i32 (i8*, ...) @printf(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @.str, i32 0, i32 0), i8* %7)\n"
 		" call void @exit(i32 1)\n"
 		" unreachable\n"
-		"; <label>:9:                                     ; preds = %%2\n"
+		"; <label>:9:                                     ; preds = %2\n"
 		" ret void\n"
 		"}\n"
 		"declare void @exit(i32)\n\n");
 
 	// TODO: тут пока заглушки
 	// print
-	uni_printf(info->sx->io, "define void @print(...) {\n"
+	uni_print_string(info->sx->io, "define void @print(...) {\n"
 		" ret void\n"
 		"}\n");
 
 	// printid
-	uni_printf(info->sx->io, "define void @printid(...) {\n"
+	uni_print_string(info->sx->io, "define void @printid(...) {\n"
 		" ret void\n"
 		"}\n\n");
 	info->was_function[BI_PRINTF] = true;
 
 	// getid
-	uni_printf(info->sx->io, "define void @getid(...) {\n"
+	uni_print_string(info->sx->io, "define void @getid(...) {\n"
 		" ret void\n"
 		"}\n\n");
 }
@@ -72,16 +72,23 @@ static node parse_statement(parser *const prs);
  *	Create parser
  *
  *	@param	sx			Syntax structure
+ *	@param	tokenize	Set, if whole input is lexed before parsing
  *
  *	@return	Parser
  */
-static inline parser parser_create(syntax *const sx)
+static inline parser parser_create(syntax *const sx, const bool tokenize)
 {
 	parser prs;
 	prs.sx = sx;
 	prs.bld = builder_create(sx);
 	prs.lxr = lexer_create(sx);
 
+	if (tokenize && lexer_tokenize(&prs.lxr))
+	{
+		// Поток токенов не построен, поэтому лексический анализ выполняется по запросу
+		warning_msg("недостаточно памяти для потока токенов, лексический анализ выполняется по запросу");
+	}
+
 	prs.is_in_loop = false;
 	prs.is_in_switch = false;
 
@@ -2246,24 +2253,22 @@ static void parse_translation_unit(parser *const prs, node *const root)
 	} while (token_is_not(&prs->tk, TK_EOF));
 }
 
-
-/*
- *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
- *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
- *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
- *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
- *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+/**
+ *	Parse translation unit
+ *
+ *	@param	sx			Syntax structure
+ *	@param	tokenize	Set, if whole input is lexed before parsing
+ *
+ *	@return	@c 0 on success, @c -1 on failure
  */
-
-
-int parse(syntax *const sx)
+static int parse_unit(syntax *const sx, const bool tokenize)
 {
 	if (sx == NULL)
 	{
 		return -1;
 	}
 
-	parser prs = parser_create(sx);
+	parser prs = parser_create(sx, tokenize);
 	node root = node_get_root(&sx->tree);
 
 	parse_translation_unit(&prs, &root);
@@ -2276,3 +2281,23 @@ int parse(syntax *const sx)
 	// Временное решение - парсер не проверяет таблицы
 	return sx->rprt.errors == 0 ? 0 : -1;
 }
+
+
+/*
+ *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
+ *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
+ *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
+ *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
+ *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+ */
+
+
+int parse(syntax *const sx)
+{
+	return parse_unit(sx, false);
+}
+
+int parse_tokenized(syntax *const sx)
+{
+	return parse_unit(sx, true);
+}
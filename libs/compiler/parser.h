@@ -34,6 +34,16 @@ extern "C" {
  */
 int parse(syntax *const sx);
 
+/**
+ *	Parse source code to generate syntax tree, lexing the whole input beforehand
+ *	@note	Identifiers and strings from lexer are numbered before ones from parser
+ *
+ *	@param	sx		Syntax structure
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+int parse_tokenized(syntax *const sx);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -51,10 +51,11 @@ static inline bool recovery_status(const workspace *const ws)
  */
 
 
-reporter reporter_create(const workspace *const ws)
+reporter reporter_create(const workspace *const ws, const comment_map *const cmts)
 {
 	reporter rprt;
 	rprt.is_recovery_disabled = recovery_status(ws);
+	rprt.comments = cmts;
 	rprt.errors = 0;
 	rprt.warnings = 0;
 
@@ -76,7 +77,7 @@ void report_error(reporter *const rprt, universal_io *const io, const location l
 	const size_t prev_loc = in_get_position(io);
 	in_set_position(io, loc.begin);
 
-	verror(io, num, args);
+	verror(io, rprt->comments, num, args);
 	rprt->errors++;
 
 	in_set_position(io, prev_loc);
@@ -92,7 +93,7 @@ void report_warning(reporter *const rprt, universal_io *const io, const location
 	const size_t prev_loc = in_get_position(io);
 	in_set_position(io, loc.begin);
 
-	vwarning(io, num, args);
+	vwarning(io, rprt->comments, num, args);
 	rprt->warnings++;
 
 	in_set_position(io, prev_loc);
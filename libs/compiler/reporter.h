@@ -32,6 +32,8 @@ typedef struct reporter
 	size_t warnings;						/**< Number of reported warnings */
 
 	bool is_recovery_disabled;				/**< Set, if error recovery & multiple output disabled */
+
+	const comment_map *comments;			/**< Comments of input, which are kept apart from it */
 } reporter;
 
 
@@ -39,10 +41,11 @@ typedef struct reporter
  *	Create reporter
  *
  *	@param	ws		Compiler workspace
+ *	@param	cmts	Comments of input, @c NULL if they are in input
  *
  *	@return	@c 0 on success, @c 1 on failure
  */
-reporter reporter_create(const workspace *const ws);
+reporter reporter_create(const workspace *const ws, const comment_map *const cmts);
 
 /**
  *	Get reported error number
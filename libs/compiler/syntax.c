@@ -17,6 +17,7 @@
 #include "syntax.h"
 #include <stdlib.h>
 #include <string.h>
+#include "keywords.h"
 #include "token.h"
 #include "tree.h"
 
@@ -26,6 +27,7 @@ static const size_t IDENTIFIERS_SIZE = 10000;
 static const size_t FUNCTIONS_SIZE = 100;
 static const size_t STRINGS_SIZE = 80;
 static const size_t TYPES_SIZE = 1000;
+static const size_t TYPES_INDEX_SIZE = 1024;
 static const size_t TREE_SIZE = 10000;
 
 
@@ -52,51 +54,12 @@ static void repr_add_keyword(map *const reprtab, const char32_t *const eng, cons
 
 static inline void repr_init(map *const reprtab)
 {
-	repr_add_keyword(reprtab, U"main", U"главная", TK_MAIN);
-	repr_add_keyword(reprtab, U"char", U"литера", TK_CHAR);
-	repr_add_keyword(reprtab, U"double", U"двойной", TK_DOUBLE);
-	repr_add_keyword(reprtab, U"float", U"вещ", TK_FLOAT);
-	repr_add_keyword(reprtab, U"int", U"цел", TK_INT);
-	repr_add_keyword(reprtab, U"long", U"длин", TK_LONG);
-	repr_add_keyword(reprtab, U"struct", U"структура", TK_STRUCT);
-	repr_add_keyword(reprtab, U"enum", U"перечисление", TK_ENUM);
-	repr_add_keyword(reprtab, U"void", U"пусто", TK_VOID);
-	repr_add_keyword(reprtab, U"file", U"файл", TK_FILE);
-	repr_add_keyword(reprtab, U"typedef", U"типопр", TK_TYPEDEF);
-	repr_add_keyword(reprtab, U"if", U"если", TK_IF);
-	repr_add_keyword(reprtab, U"else", U"иначе", TK_ELSE);
-	repr_add_keyword(reprtab, U"do", U"цикл", TK_DO);
-	repr_add_keyword(reprtab, U"while", U"пока", TK_WHILE);
-	repr_add_keyword(reprtab, U"for", U"для", TK_FOR);
-	repr_add_keyword(reprtab, U"switch", U"выбор", TK_SWITCH);
-	repr_add_keyword(reprtab, U"case", U"случай", TK_CASE);
-	repr_add_keyword(reprtab, U"default", U"умолчание", TK_DEFAULT);
-	repr_add_keyword(reprtab, U"break", U"выход", TK_BREAK);
-	repr_add_keyword(reprtab, U"continue", U"продолжить", TK_CONTINUE);
-	repr_add_keyword(reprtab, U"return", U"возврат", TK_RETURN);
-	repr_add_keyword(reprtab, U"null", U"ничто", TK_NULL);
-	repr_add_keyword(reprtab, U"abs", U"абс", TK_ABS);
-	repr_add_keyword(reprtab, U"upb", U"кол_во", TK_UPB);
-	repr_add_keyword(reprtab, U"bool", U"булево", TK_BOOL);
-	repr_add_keyword(reprtab, U"true", U"истина", TK_TRUE);
-	repr_add_keyword(reprtab, U"false", U"ложь", TK_FALSE);
+#define KEYWORD(eng, rus, token) repr_add_keyword(reprtab, eng, rus, token);
+	KEYWORDS(KEYWORD)
+#undef KEYWORD
 }
 
 
-static inline void type_init(syntax *const sx)
-{
-	vector_increase(&sx->types, 1);
-	// занесение в types описателя struct {int numTh; int inf; }
-	sx->start_type = vector_add(&sx->types, 0);
-	vector_add(&sx->types, TYPE_STRUCTURE);
-	vector_add(&sx->types, 2);
-	vector_add(&sx->types, 4);
-	vector_add(&sx->types, TYPE_INTEGER);
-	vector_add(&sx->types, (item_t)map_reserve(&sx->representations, "numTh"));
-	vector_add(&sx->types, TYPE_INTEGER);
-	vector_add(&sx->types, (item_t)map_reserve(&sx->representations, "data"));
-}
-
 static inline item_t get_static(syntax *const sx, const item_t type)
 {
 	const item_t old_displ = sx->displ;
@@ -114,23 +77,28 @@ static inline item_t get_static(syntax *const sx, const item_t type)
 	return old_displ;
 }
 
-/**	Check if types are equal */
-static inline bool type_is_equal(const syntax *const sx, const size_t first, const size_t second)
+/**	Get amount of compared fields of types table record */
+static inline size_t type_get_length(const syntax *const sx, const size_t record)
 {
-	if (vector_get(&sx->types, first) != vector_get(&sx->types, second))
+	// Определяем, сколько полей надо сравнивать для различных типов записей
+	const item_t type = vector_get(&sx->types, record);
+	if (type == TYPE_STRUCTURE || type == TYPE_FUNCTION)
 	{
-		return false;
+		return 2 + (size_t)vector_get(&sx->types, record + 2);
 	}
 
-	size_t length = 1;
-	const item_t type = vector_get(&sx->types, first);
+	return 1;
+}
 
-	// Определяем, сколько полей надо сравнивать для различных типов записей
-	if (type == TYPE_STRUCTURE || type == TYPE_FUNCTION)
+/**	Check if types are equal */
+static inline bool type_is_equal(const syntax *const sx, const size_t first, const size_t second)
+{
+	if (vector_get(&sx->types, first) != vector_get(&sx->types, second))
 	{
-		length = 2 + (size_t)vector_get(&sx->types, first + 2);
+		return false;
 	}
 
+	const size_t length = type_get_length(sx, first);
 	for (size_t i = 1; i <= length; i++)
 	{
 		if (vector_get(&sx->types, first + i) != vector_get(&sx->types, second + i))
@@ -142,6 +110,83 @@ static inline bool type_is_equal(const syntax *const sx, const size_t first, con
 	return true;
 }
 
+/**	Get hash of types table record */
+static size_t type_get_hash(const syntax *const sx, const size_t record)
+{
+	// FNV-1a over class and compared fields
+	uint64_t hash = 14695981039346656037ULL;
+	const size_t length = type_get_length(sx, record);
+	for (size_t i = 0; i <= length; i++)
+	{
+		hash ^= (uint64_t)vector_get(&sx->types, record + i);
+		hash *= 1099511628211ULL;
+	}
+
+	return (size_t)hash;
+}
+
+/**	Find slot of types table record or empty slot for it in hash index */
+static size_t type_index_find(const syntax *const sx, const size_t record)
+{
+	const size_t mask = vector_size(&sx->types_index) - 1;
+
+	size_t slot = type_get_hash(sx, record) & mask;
+	item_t type = vector_get(&sx->types_index, slot);
+	while (type != 0 && !type_is_equal(sx, record, (size_t)type))
+	{
+		slot = (slot + 1) & mask;
+		type = vector_get(&sx->types_index, slot);
+	}
+
+	return slot;
+}
+
+/**	Add types table record to hash index */
+static void type_index_add(syntax *const sx, const size_t record)
+{
+	const size_t size = vector_size(&sx->types_index);
+	if (4 * (sx->types_amount + 1) > 3 * size)
+	{
+		vector old = sx->types_index;
+		sx->types_index = vector_create(2 * size);
+		vector_increase(&sx->types_index, 2 * size);
+
+		for (size_t i = 0; i < size; i++)
+		{
+			const item_t type = vector_get(&old, i);
+			if (type != 0)
+			{
+				vector_set(&sx->types_index, type_index_find(sx, (size_t)type), type);
+			}
+		}
+
+		vector_clear(&old);
+	}
+
+	vector_set(&sx->types_index, type_index_find(sx, record), (item_t)record);
+	sx->types_amount++;
+}
+
+
+static inline void type_init(syntax *const sx)
+{
+	vector_increase(&sx->types, 1);
+	// занесение в types описателя struct {int numTh; int inf; }
+	sx->start_type = vector_add(&sx->types, 0);
+	vector_add(&sx->types, TYPE_STRUCTURE);
+	vector_add(&sx->types, 2);
+	vector_add(&sx->types, 4);
+	vector_add(&sx->types, TYPE_INTEGER);
+	vector_add(&sx->types, (item_t)map_reserve(&sx->representations, "numTh"));
+	vector_add(&sx->types, TYPE_INTEGER);
+	vector_add(&sx->types, (item_t)map_reserve(&sx->representations, "data"));
+
+	sx->types_index = vector_create(TYPES_INDEX_SIZE);
+	vector_increase(&sx->types_index, TYPES_INDEX_SIZE);
+	sx->types_amount = 0;
+	type_index_add(sx, sx->start_type + 1);
+}
+
 static void builtin_add(syntax *const sx, const char32_t *const eng, const char32_t *const rus, const item_t type)
 {
 	// Добавляем одно из написаний в таблицу representations
@@ -242,7 +287,7 @@ static item_t type_get(const syntax *const sx, const size_t index)
  */
 
 
-syntax sx_create(const workspace *const ws, universal_io *const io)
+syntax sx_create(const workspace *const ws, universal_io *const io, const comment_map *const cmts)
 {
 	syntax sx;
 	sx.io = io;
@@ -274,7 +319,7 @@ syntax sx_create(const workspace *const ws, universal_io *const io)
 	sx.displ = -3;
 	sx.lg = -1;
 
-	sx.rprt = reporter_create(ws);
+	sx.rprt = reporter_create(ws, cmts);
 
 	return sx;
 }
@@ -321,6 +366,7 @@ int sx_clear(syntax *const sx)
 
 	vector_clear(&sx->identifiers);
 	vector_clear(&sx->types);
+	vector_clear(&sx->types_index);
 	map_clear(&sx->representations);
 
 	return 0;
@@ -525,23 +571,23 @@ item_t type_add(syntax *const sx, const item_t *const record, const size_t size)
 		vector_add(&sx->types, record[i]);
 	}
 
+	// Enum fields are added after record, so enums are never merged
+	if (record[0] == TYPE_ENUM)
+	{
+		return (item_t)sx->start_type + 1;
+	}
+
 	// Checking mode duplicates
-	size_t old = (size_t)vector_get(&sx->types, sx->start_type);
-	while (old)
+	const item_t old = vector_get(&sx->types_index, type_index_find(sx, sx->start_type + 1));
+	if (old != 0)
 	{
-		if (type_is_equal(sx, sx->start_type + 1, old + 1))
-		{
-			const size_t start_type = sx->start_type;
-			sx->start_type = (size_t)vector_get(&sx->types, sx->start_type);
-			vector_resize(&sx->types, start_type);
-			return (item_t)old + 1;
-		}
-		else
-		{
-			old = (size_t)vector_get(&sx->types, old);
-		}
+		const size_t start_type = sx->start_type;
+		sx->start_type = (size_t)vector_get(&sx->types, sx->start_type);
+		vector_resize(&sx->types, start_type);
+		return old;
 	}
 
+	type_index_add(sx, sx->start_type + 1);
 	return (item_t)sx->start_type + 1;
 }
 
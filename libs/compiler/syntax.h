@@ -77,6 +77,9 @@ typedef struct syntax
 	vector types;				/**< Types table */
 	size_t start_type;			/**< Start of last record in types table */
 
+	vector types_index;			/**< Hash index of types table records */
+	size_t types_amount;		/**< Amount of records in hash index */
+
 	map representations;		/**< Representations table */
 
 	item_t max_displ;			/**< Max displacement */
@@ -101,10 +104,11 @@ typedef struct scope
  *
  *	@param	ws				Compiler workspace
  *	@param	io				Universal io structure
+ *	@param	cmts			Comments of input, @c NULL if they are in input
  *
  *	@return	Syntax structure
  */
-syntax sx_create(const workspace *const ws, universal_io *const io);
+syntax sx_create(const workspace *const ws, universal_io *const io, const comment_map *const cmts);
 
 /**
  *	Check if syntax structure is correct
@@ -2052,7 +2052,7 @@ static size_t write_instruction(universal_io *const io, const vector *const tabl
 		uni_printf(io, " %" PRIitem, vector_get(table, i++));
 	}
 
-	uni_printf(io, "\n");
+	uni_print_string(io, "\n");
 	return i;
 }
 
@@ -21,6 +21,7 @@
 #include "compiler.h"
 #include "errors.h"
 #include "instructions.h"
+#include "keywords.h"
 #include "lexer.h"
 #include "llvmgen.h"
 #include "operations.h"
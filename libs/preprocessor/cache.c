@@ -0,0 +1,359 @@
+/*
+ *	Copyright 2026 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+#include "cache.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+	#include <sys/stat.h>
+	#include <sys/types.h>
+	#include <unistd.h>
+#else
+	#include <direct.h>
+	#include <process.h>
+#endif
+
+
+/**
+ *	Version of cache entries, which must be increased on each change of preprocessing output,
+ *	of comment map records or of entry format
+ */
+static const char *const VERSION = "ruc-macro-cache 2";
+
+static const char *const FLAG = "--macro-cache=";
+static const char *const SUFFIX = ".macro";
+
+static const uint64_t MAGIC = 0x3145484341434D52u;
+static const uint64_t FNV_OFFSET = 14695981039346656037u;
+
+
+/** Check that flag does not affect preprocessing */
+static bool is_ignored_flag(const char *const flag)
+{
+	return strncmp(flag, FLAG, strlen(FLAG)) == 0 || strcmp(flag, "-VM") == 0 || strcmp(flag, "-LLVM") == 0;
+}
+
+/** Get cache directory from flags */
+static const char *cache_get_dir(const workspace *const ws)
+{
+	const size_t length = strlen(FLAG);
+	for (size_t i = 0; ; i++)
+	{
+		const char *flag = ws_get_flag(ws, i);
+		if (flag == NULL)
+		{
+			return NULL;
+		}
+		else if (strncmp(flag, FLAG, length) == 0 && flag[length] != '\0')
+		{
+			return &flag[length];
+		}
+	}
+}
+
+static inline uint64_t hash_bytes(uint64_t hash, const void *const data, const size_t size)
+{
+	// FNV-1a
+	const unsigned char *const bytes = data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211u;
+	}
+
+	return hash;
+}
+
+static inline uint64_t hash_string(const uint64_t hash, const char *const str)
+{
+	// Завершающий ноль разделяет соседние строки
+	return hash_bytes(hash, str, strlen(str) + 1);
+}
+
+/** Hash file contents */
+static int hash_file(const char *const path, uint64_t *const hash, uint64_t *const size)
+{
+	FILE *const file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	char buffer[BUFSIZ];
+	*hash = FNV_OFFSET;
+	*size = 0;
+
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) != 0)
+	{
+		*hash = hash_bytes(*hash, buffer, read);
+		*size += read;
+	}
+
+	const int ret = ferror(file) ? -1 : 0;
+	fclose(file);
+	return ret;
+}
+
+
+static inline int write_value(FILE *const file, const uint64_t value)
+{
+	return fwrite(&value, sizeof(value), 1, file) == 1 ? 0 : -1;
+}
+
+static inline int write_bytes(FILE *const file, const void *const data, const size_t size)
+{
+	if (write_value(file, size))
+	{
+		return -1;
+	}
+
+	return size == 0 || fwrite(data, 1, size, file) == size ? 0 : -1;
+}
+
+static inline int read_value(FILE *const file, uint64_t *const value)
+{
+	return fread(value, sizeof(*value), 1, file) == 1 ? 0 : -1;
+}
+
+/** Read sized bytes to allocated memory with terminating zero */
+static void *read_bytes(FILE *const file, size_t *const size)
+{
+	uint64_t value;
+	if (read_value(file, &value) || value >= SIZE_MAX)
+	{
+		return NULL;
+	}
+
+	char *const data = malloc((size_t)value + 1);
+	if (data == NULL)
+	{
+		return NULL;
+	}
+
+	if (value != 0 && fread(data, 1, (size_t)value, file) != (size_t)value)
+	{
+		free(data);
+		return NULL;
+	}
+
+	data[value] = '\0';
+	*size = (size_t)value;
+	return data;
+}
+
+
+/** Check that files, which were opened by linker, are not changed, and add them to workspace */
+static int cache_read_files(workspace *const ws, FILE *const file)
+{
+	uint64_t num;
+	if (read_value(file, &num))
+	{
+		return -1;
+	}
+
+	for (uint64_t i = 0; i < num; i++)
+	{
+		size_t length;
+		char *const path = read_bytes(file, &length);
+
+		uint64_t expected_hash, expected_size, hash, size;
+		const int ret = path == NULL || read_value(file, &expected_hash) || read_value(file, &expected_size)
+			|| hash_file(path, &hash, &size) || hash != expected_hash || size != expected_size
+			|| ws_add_file(ws, path) == SIZE_MAX;
+
+		free(path);
+		if (ret)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+/*
+ *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
+ *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
+ *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
+ *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
+ *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+ */
+
+
+int cache_get_path(const workspace *const ws, const bool has_comments, char *const path)
+{
+	const char *const dir = cache_get_dir(ws);
+	if (dir == NULL || strlen(dir) + 2 * sizeof(uint64_t) + strlen(SUFFIX) + 2 > MAX_ARG_SIZE)
+	{
+		return -1;
+	}
+
+#ifndef _WIN32
+	const int ret = mkdir(dir, 0777);
+#else
+	const int ret = _mkdir(dir);
+#endif
+	if (ret != 0 && errno != EEXIST)
+	{
+		return -1;
+	}
+
+	uint64_t hash = hash_string(FNV_OFFSET, VERSION);
+	hash = hash_bytes(hash, &has_comments, sizeof(has_comments));
+
+	for (size_t i = 0; i < ws_get_flags_num(ws); i++)
+	{
+		if (!is_ignored_flag(ws_get_flag(ws, i)))
+		{
+			hash = hash_string(hash, ws_get_flag(ws, i));
+		}
+	}
+
+	hash = hash_bytes(hash, "", 1);
+	for (size_t i = 0; i < ws_get_dirs_num(ws); i++)
+	{
+		hash = hash_string(hash, ws_get_dir(ws, i));
+	}
+
+	hash = hash_bytes(hash, "", 1);
+	for (size_t i = 0; i < ws_get_files_num(ws); i++)
+	{
+		uint64_t content, size;
+		if (hash_file(ws_get_file(ws, i), &content, &size))
+		{
+			return -1;
+		}
+
+		hash = hash_string(hash, ws_get_file(ws, i));
+		hash = hash_bytes(hash, &content, sizeof(content));
+		hash = hash_bytes(hash, &size, sizeof(size));
+	}
+
+	sprintf(path, "%s/%016llx%s", dir, (unsigned long long)hash, SUFFIX);
+	return 0;
+}
+
+char *cache_read(workspace *const ws, const char *const path, comment_map *const cmts)
+{
+	FILE *const file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		return NULL;
+	}
+
+	uint64_t magic;
+	if (read_value(file, &magic) || magic != MAGIC)
+	{
+		fclose(file);
+		return NULL;
+	}
+
+	// Рабочее пространство меняется только после проверки всей записи
+	workspace checked = ws_create();
+	if (cache_read_files(&checked, file))
+	{
+		ws_clear(&checked);
+		fclose(file);
+		return NULL;
+	}
+
+	size_t size;
+	char *const text = read_bytes(file, &size);
+	if (text == NULL || strlen(text) != size || (cmts != NULL && cmt_map_read(cmts, file)))
+	{
+		ws_clear(&checked);
+		free(text);
+		fclose(file);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < ws_get_files_num(&checked); i++)
+	{
+		ws_add_file(ws, ws_get_file(&checked, i));
+	}
+
+	ws_clear(&checked);
+	fclose(file);
+	return text;
+}
+
+int cache_hash_input(universal_io *const io, uint64_t *const hash, uint64_t *const size)
+{
+	*hash = FNV_OFFSET;
+	*size = 0;
+
+	// Отображенный в память файл хэшируется без чтения
+	size_t available = 0;
+	const char *cursor;
+	while ((cursor = in_get_cursor(io, &available)) != NULL && available != 0)
+	{
+		*hash = hash_bytes(*hash, cursor, available);
+		*size += available;
+		in_skip(io, available);
+	}
+
+	return cursor == NULL || in_set_position(io, 0) ? -1 : 0;
+}
+
+int cache_write(const linker *const lk, const char *const path, const char *const text
+	, const comment_map *const cmts)
+{
+	if (!lk->has_hashes)
+	{
+		return -1;
+	}
+
+	char temp[MAX_ARG_SIZE + 32];
+#ifndef _WIN32
+	sprintf(temp, "%s.%ld", path, (long)getpid());
+#else
+	sprintf(temp, "%s.%ld", path, (long)_getpid());
+#endif
+
+	FILE *const file = fopen(temp, "wb");
+	if (file == NULL)
+	{
+		return -1;
+	}
+
+	// Файлы записываются с содержимым, прочитанным при их открытии линкером
+	int ret = write_value(file, MAGIC) || write_value(file, ws_get_files_num(lk->ws));
+	for (size_t i = 0; !ret && i < ws_get_files_num(lk->ws); i++)
+	{
+		const char *const dependency = ws_get_file(lk->ws, i);
+		ret = write_bytes(file, dependency, strlen(dependency))
+			|| write_value(file, lk->hashes[i]) || write_value(file, lk->sizes[i]);
+	}
+
+	ret = ret || write_bytes(file, text, strlen(text)) || (cmts != NULL && cmt_map_write(cmts, file));
+
+	ret = fclose(file) || ret;
+
+	// Запись заменяется целиком, поэтому параллельные сборки не видят её частично
+	if (ret || rename(temp, path))
+	{
+		remove(temp);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+/*
+ *	Copyright 2026 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "commenter.h"
+#include "linker.h"
+#include "uniio.h"
+#include "workspace.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	Get path of cache entry for preprocessing of workspace files
+ *	@note	Entry is named by hash of version, flags, directories and contents of files.
+ *			Cache directory is set by flag @c --macro-cache=<directory>
+ *
+ *	@param	ws				Workspace
+ *	@param	has_comments	Set, if comments are kept apart from preprocessed text
+ *	@param	path			Buffer of @c MAX_ARG_SIZE for entry path
+ *
+ *	@return	@c 0 on success, @c -1 if cache is not used or its directory cannot be created
+ */
+int cache_get_path(const workspace *const ws, const bool has_comments, char *const path);
+
+/**
+ *	Read preprocessed text from cache entry
+ *	@note	Entry is used only if all files, which were opened by linker, are not changed.
+ *			These files are added to workspace as by preprocessing
+ *
+ *	@param	ws				Workspace
+ *	@param	path			Entry path
+ *	@param	cmts			Comment map, @c NULL if comments are in text
+ *
+ *	@return	Preprocessed text, @c NULL if entry is missing or outdated
+ */
+char *cache_read(workspace *const ws, const char *const path, comment_map *const cmts);
+
+/**
+ *	Hash contents of opened input file
+ *	@note	Input position is returned to the beginning of file
+ *
+ *	@param	io				Universal io structure
+ *	@param	hash			Hash of contents
+ *	@param	size			Size of contents
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+int cache_hash_input(universal_io *const io, uint64_t *const hash, uint64_t *const size);
+
+/**
+ *	Write preprocessed text to cache entry
+ *	@note	Files of linker workspace are written with contents hashes, which are recorded on their opening
+ *
+ *	@param	lk				Linker after preprocessing
+ *	@param	path			Entry path
+ *	@param	text			Preprocessed text
+ *	@param	cmts			Comment map, @c NULL if comments are in text
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+int cache_write(const linker *const lk, const char *const path, const char *const text
+	, const comment_map *const cmts);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
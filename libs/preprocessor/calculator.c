@@ -14,502 +14,808 @@
  *	limitations under the License.
  */
 
+
 #include "calculator.h"
 #include "environment.h"
 #include "error.h"
 #include "macro_load.h"
 #include "linker.h"
 #include "utils.h"
+#include <inttypes.h>
+#include <locale.h>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
 
+#define MAX_NUMBER_SIZE	128
 
-#define STK_SIZE 32
-#define OPN_SIZE STK_SIZE
+#define CALC_INTEGER	0
+#define CALC_DOUBLE		1
+#define CALC_MACRO		2
+#define CALC_OPERATION	3
 
 
-double get_digit(environment *const env, int* error)// Временная замена
+/** Expression parser */
+typedef struct calculator
+{
+	environment *env;			/**< Preprocessor environment */
+	vector *tree;				/**< Expression tree */
+	bool is_compiled;			/**< Set, if macro names are kept in tree for repeated calculation */
+	bool was_error;				/**< Set, if expression is incorrect */
+} calculator;
+
+/** Typed value of expression */
+typedef struct calc_value
 {
-	double k;
-	int d = 1;
+	bool is_int;				/**< Set, if value is integer */
+	int64_t integer;			/**< Integer value */
+	double real;				/**< Floating value */
+} calc_value;
+
+
+static size_t calc_parse_expression(calculator *const calc, const int type, const int prior);
+
 
-	env->flagint = 1;
-	int num = 0;
-	double numdouble = 0.0;
-	if (env->curchar == '-')
+static void calc_error(calculator *const calc, const int num)
+{
+	if (!calc->was_error && !calc->is_compiled)
 	{
-		d = -1;
-		m_nextch(env);
+		env_error(calc->env, num);
 	}
 
-	while (utf8_is_digit(env->curchar))
+	calc->was_error = true;
+}
+
+/**
+ *	Get next state of number reading
+ *	@note	States are sign, integer part, point, fractional part, exponent, exponent sign and order
+ *
+ *	@param	state		Current state, @c 0 before number
+ *	@param	character	Next character
+ *
+ *	@return	Next state, @c -1 if character does not continue number
+ */
+static int number_next(const int state, const int character)
+{
+	const bool is_digit = utf8_is_digit((char32_t)character);
+	switch (state)
 	{
-		numdouble = numdouble * 10 + (env->curchar - '0');
-		if (numdouble > (double)INT_MAX)
-		{
-			env_error(env, too_many_nuber);
-			*error = -1;
-			return 0.0;
-		}
-		num = num * 10 + (env->curchar - '0');
-		m_nextch(env);
+		case 0:
+			return character == '-' ? 1 : is_digit ? 2 : -1;
+		case 1:
+			return is_digit ? 2 : -1;
+		case 2:
+			return is_digit ? 2 : character == '.' ? 3 : utf8_is_power((char32_t)character) ? 5 : -1;
+		case 3:
+		case 4:
+			return is_digit ? 4 : utf8_is_power((char32_t)character) ? 5 : -1;
+		case 5:
+			return character == '-' || character == '+' ? 6 : is_digit ? 7 : -1;
+		case 6:
+		case 7:
+			return is_digit ? 7 : -1;
+		default:
+			return -1;
 	}
+}
 
-	if (env->curchar == '.')
-	{
-		env->flagint = 0;
-		m_nextch(env);
-		k = 0.1;
+/**
+ *	Convert number text to typed value
+ *	@note	Number is integer, if it has no point and no negative exponent
+ *
+ *	@param	text		Number text with Latin exponent letter
+ *	@param	val			Value of number
+ *
+ *	@return	@c 0 on success, error code on failure
+ */
+static int number_to_value(const char *const text, calc_value *const val)
+{
+	const bool is_negative = text[0] == '-';
+	size_t i = is_negative ? 1 : 0;
 
-		while (utf8_is_digit(env->curchar))
+	uint64_t integer = 0;
+	for (; utf8_is_digit((char32_t)text[i]); i++)
+	{
+		const uint64_t digit = (uint64_t)(text[i] - '0');
+		if (integer > (UINT64_MAX - digit) / 10)
 		{
-			numdouble += (env->curchar - '0') * k;
-			k *= 0.1;
-			m_nextch(env);
+			integer = UINT64_MAX;
+			continue;
 		}
+		integer = integer * 10 + digit;
 	}
 
-	if (utf8_is_power(env->curchar))
+	val->is_int = text[i] != '.' && (text[i] != 'e' || text[i + 1] != '-');
+	if (!val->is_int)
 	{
-		int power = 0;
-		int sign = 1;
-		int i;
-
-		m_nextch(env);
-		if (env->curchar == '-')
-		{
-			env->flagint = 0;
-			m_nextch(env);
-			sign = -1;
-		}
-		else if (env->curchar == '+')
+		// Точка заменяется на разделитель текущей локали
+		char buffer[MAX_NUMBER_SIZE];
+		for (size_t j = 0; ; j++)
 		{
-			m_nextch(env);
+			buffer[j] = text[j] == '.' ? localeconv()->decimal_point[0] : text[j];
+			if (text[j] == '\0')
+			{
+				break;
+			}
 		}
 
+		val->real = strtod(buffer, NULL);
+		return 0;
+	}
 
-		if (!utf8_is_digit(env->curchar))
+	if (text[i] == 'e')
+	{
+		size_t power = 0;
+		for (i += text[i + 1] == '+' ? 2 : 1; text[i] != '\0'; i++)
 		{
-			env_error(env, must_be_digit_after_exp1);
-			*error = -1;
-			return 0.0;
+			power = power < MAX_NUMBER_SIZE ? power * 10 + (size_t)(text[i] - '0') : power;
 		}
 
-
-		while (utf8_is_digit(env->curchar))
+		for (size_t j = 0; j < power && integer != 0 && integer != UINT64_MAX; j++)
 		{
-			power = power * 10 + env->curchar - '0';
-			m_nextch(env);
+			integer = integer > UINT64_MAX / 10 ? UINT64_MAX : integer * 10;
 		}
+	}
 
-		if (env->flagint)
+	if (integer > (uint64_t)INT64_MAX + (is_negative ? 1 : 0))
+	{
+		return too_many_nuber;
+	}
+
+	val->integer = is_negative ? (int64_t)(~integer + 1) : (int64_t)integer;
+	return 0;
+}
+
+/**
+ *	Read number from input
+ *
+ *	@param	calc		Expression parser
+ *	@param	val			Value of number
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+static int calc_read_number(calculator *const calc, calc_value *const val)
+{
+	environment *const env = calc->env;
+	char text[MAX_NUMBER_SIZE];
+	size_t size = 0;
+
+	int state = 0;
+	for (int next = number_next(state, env->curchar); next != -1; next = number_next(state, env->curchar))
+	{
+		if (size == MAX_NUMBER_SIZE - 1)
 		{
-			for (i = 1; i <= power; i++)
-			{
-				num *= 10;
-			}
+			calc_error(calc, too_many_nuber);
+			return -1;
 		}
 
-		numdouble *= pow(10.0, sign * power);
+		text[size++] = utf8_is_power((char32_t)env->curchar) ? 'e' : (char)env->curchar;
+		state = next;
+		m_nextch(env);
 	}
+	text[size] = '\0';
 
-	if (env->flagint)
+	if (state == 5 || state == 6)
 	{
-		return num * d;
+		calc_error(calc, must_be_digit_after_exp1);
+		return -1;
 	}
-	else
+
+	const int error = number_to_value(text, val);
+	if (error)
 	{
-		return numdouble * d;
+		calc_error(calc, error);
+		return -1;
 	}
+
+	return 0;
 }
 
-char get_opiration(const char cur, const char next)
+/**
+ *	Read number from table, which is followed by the end of macro
+ *
+ *	@param	tab			Table
+ *	@param	index		Index of first character
+ *	@param	val			Value of number
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+static int tab_read_number(const table *const tab, size_t index, calc_value *const val)
 {
-	switch (cur)
+	if (tab_get(tab, index) == '-' && !utf8_is_digit((char32_t)tab_get(tab, index + 1)))
 	{
-	case '|':
-	case '&':
-	case '=':
-	case '!':
-		if ((next == cur && cur != '!') || (cur == '!' && next == '='))
-		{
-			return cur;
-		}
-		else
-		{
-			return '\0';
-		}
-	case '>':
-	case '<':
-		if (cur == '>' && next == '=')
-		{
-			return 'b';
-		}
-		else if (cur == '>' && next == '=')
+		return -1;
+	}
+
+	char text[MAX_NUMBER_SIZE];
+	size_t size = 0;
+
+	int state = 0;
+	for (int next = number_next(state, tab_get(tab, index)); next != -1
+		; next = number_next(state, tab_get(tab, index)))
+	{
+		if (size == MAX_NUMBER_SIZE - 1)
 		{
-			return 's';
+			return -1;
 		}
-	case '+':
-	case '-':
-	case '*':
-	case '/':
-	case '%':
-	case '(':
-		return cur;
-	default:
-		return '\0';
+
+		text[size++] = utf8_is_power((char32_t)tab_get(tab, index)) ? 'e' : (char)tab_get(tab, index);
+		state = next;
+		index++;
+	}
+	text[size] = '\0';
+
+	if (state != 2 && state != 3 && state != 4 && state != 7)
+	{
+		return -1;
 	}
+
+	return tab_get(tab, index) == MACROEND && !number_to_value(text, val) ? 0 : -1;
+}
+
+
+static size_t calc_add_node(calculator *const calc, const item_t kind, const item_t data
+	, const size_t left, const size_t right)
+{
+	const size_t node = vector_size(calc->tree);
+	vector_add(calc->tree, kind);
+	vector_add(calc->tree, data);
+	vector_add(calc->tree, (item_t)left);
+	vector_add(calc->tree, (item_t)right);
+	vector_add_double(calc->tree, 0.0);
+	return node;
 }
 
-int get_prior(const char opiration)
+static size_t calc_add_value(calculator *const calc, const calc_value *const val)
 {
-	switch (opiration)
+	const size_t node = calc_add_node(calc, val->is_int ? CALC_INTEGER : CALC_DOUBLE, 0, 0, 0);
+	if (val->is_int)
+	{
+		vector_set_int64(calc->tree, node + 4, val->integer);
+	}
+	else
+	{
+		vector_set_double(calc->tree, node + 4, val->real);
+	}
+
+	return node;
+}
+
+
+/**
+ *	Get operation from its characters
+ *	@note	Operations @c <= and @c >= are denoted by @c s and @c b
+ *
+ *	@param	cur		Current character
+ *	@param	next	Next character
+ *
+ *	@return	Operation, @c '\0' if characters are not operation
+ */
+static char get_operation(const int cur, const int next)
+{
+	switch (cur)
 	{
-		case '(':
-			return 0;
 		case '|':
-			return 1;
 		case '&':
-			return 2;
-		case '<':
-		case '>':
-		case 's':
-		case 'b':
 		case '=':
+			return next == cur ? (char)cur : '\0';
 		case '!':
-			return 3;
+			return next == '=' ? '!' : '\0';
+		case '<':
+			return next == '=' ? 's' : '<';
+		case '>':
+			return next == '=' ? 'b' : '>';
 		case '+':
 		case '-':
-			return 4;
 		case '*':
 		case '/':
 		case '%':
-			return 5;
+			return (char)cur;
 		default:
-			return 0;
+			return '\0';
 	}
 }
 
-double calc_count(const double x, const double y, const char opiration, const int is_int)
+static int get_prior(const char operation)
 {
-	switch (opiration)
+	switch (operation)
 	{
+		case '|':
+			return 1;
+		case '&':
+			return 2;
 		case '<':
-			return x < y;
 		case '>':
-			return x > y;
 		case 's':
-			return x <= y;
 		case 'b':
-			return x >= y;
 		case '=':
-			return x == y;
 		case '!':
-			return x != y;
-		case '&':
-			return x && y;
-		case '|':
-			return x || y;
+			return 3;
 		case '+':
-			return x + y;
 		case '-':
-			return x - y;
+			return 4;
 		case '*':
-			return x * y;
 		case '/':
-			if (is_int)
-			{
-				return (int)x / (int)y;
-			}
-			else
-			{
-				return x / y;
-			}
 		case '%':
-			if (is_int)
-			{
-				return (int)x % (int)y;
-			}
-			else
-			{
-				return x / y;
-			}
-
+			return 5;
 		default:
 			return 0;
 	}
 }
 
-void double_to_string(environment *const env, const double x, const int is_int)
+/** Expand macro in expression */
+static int calc_macro(calculator *const calc)
 {
-	char s[30] = "\0";
-
-	if (is_int)
+	const int macro_ptr = collect_mident(calc->env);
+	if (!macro_ptr)
 	{
-		sprintf(s, "%f", x);
-		for (env->calc_string_size = 0; env->calc_string_size < 20; env->calc_string_size++)
-		{
-			env->calc_string[env->calc_string_size] = s[env->calc_string_size];
-
-			if (s[env->calc_string_size] == '.')
-			{
-				return;
-			}
-		}
+		calc_error(calc, not_macro);
+		return -1;
 	}
-	else
-	{
-		int l = 0;
 
-		sprintf(s, "%.14lf", x);
-		for (env->calc_string_size = 0; env->calc_string_size < 20; env->calc_string_size++)
-		{
-			env->calc_string[env->calc_string_size] = s[env->calc_string_size];
-
-			if (s[env->calc_string_size] != '0' && utf8_is_digit(s[env->calc_string_size]))
-			{
-				l = (int)env->calc_string_size;
-			}
-		}
-		env->calc_string_size = l + 1;
-	}
+	return macro_get(calc->env, (size_t)macro_ptr);
 }
 
-int calc_macro(environment *const env)
+/** Parse macro name, which is kept in compiled expression */
+static size_t calc_parse_name(calculator *const calc)
 {
-	const int macro_ptr = collect_mident(env);
-	if (!macro_ptr)
-	{
-		env_error(env, not_macro);
-		return -1;
-	}
+	environment *const env = calc->env;
+	const size_t begin = env->nextp - 1;
+	size_t size = 0;
 
-	if(macro_get(env, macro_ptr))
+	while (utf8_is_letter((char32_t)env->curchar) || utf8_is_digit((char32_t)env->curchar))
 	{
-		return -1;
+		size++;
+		m_nextch(env);
 	}
 
-	return 0;
-}
-
-int calc_digit(environment *const env, double *stack, int *is_int, int *stk_size)
-{
-	int error = 0;
-	stack[*stk_size] = get_digit(env, &error);
-	if (error)
+	const size_t repr = env_get_name(env, &env->if_string, begin, size);
+	if (repr == 0)
 	{
-			return -1;
+		calc->was_error = true;
+		return SIZE_MAX;
 	}
 
-	is_int[*stk_size] = env->flagint;
-	*stk_size = *stk_size + 1;
-
-	return 0;
+	return calc_add_node(calc, CALC_MACRO, (item_t)repr, 0, 0);
 }
 
-int calc_opiration(environment *const env, double *const stack, int *const is_int, char *const operation, int *op_size, int *stk_size, const int type)
+/** Parse expression in parentheses */
+static size_t calc_parse_scope(calculator *const calc, const int type)
 {
-	const char c = get_opiration((char)env->curchar, (char)env->nextchar);
-	if(!c)
-	{
-		env_error(env, third_party_symbol);
-		return -1;
-	}
-
+	environment *const env = calc->env;
 	m_nextch(env);
-	if (c == 'b'|| c == 's' || c == '=' || c == '&'|| c == '|' || c == '!')
-	{
-		m_nextch(env);
-	}
 
-	const int prior = get_prior(c);
-	if (type == LOGIC && prior > 3)
+	const size_t node = calc_parse_expression(calc, type, 1);
+	if (node == SIZE_MAX)
 	{
-		env_error(env, not_arithmetic_operations);
-		return -1;
-	}
-	if (type == ARITHMETIC && prior <= 3)
-	{
-		env_error(env, not_logical_operations);
-		return -1;
+		return SIZE_MAX;
 	}
 
-	while (*op_size != 0 && get_prior(operation[*op_size - 1]) >= prior)
+	if (env->curchar != ')')
 	{
-		is_int[*stk_size - 2] = is_int[*stk_size - 2] && is_int[*stk_size - 1];
-		stack[*stk_size - 2] = calc_count(stack[*stk_size - 2], stack[*stk_size - 1], operation[*op_size - 1], is_int[*stk_size - 2]);
-		*op_size = *op_size - 1;
-		*stk_size = *stk_size - 1;
+		calc_error(calc, env->curchar != '\n'
+			? third_party_symbol
+			: type == ARITHMETIC ? in_eval_must_end_parenthesis : incorrect_arithmetic_expression);
+		return SIZE_MAX;
 	}
 
-	operation[*op_size] = c;
-	*op_size = *op_size + 1;
-
-	return 0;
+	m_nextch(env);
+	return node;
 }
 
-int calc_close(double *const stack, int *const is_int, const char *operation, int *op_size, int *stk_size)
+static size_t calc_parse_operand(calculator *const calc, const int type)
 {
-	int scope_flag = 0;
-	if(operation[*op_size - 1] == ')')
-	{
-		scope_flag++;
-		*op_size = *op_size - 1;
-	}
+	environment *const env = calc->env;
+	skip_separators(env);
 
-	while ((scope_flag && operation[*op_size - 1] != '(' && operation[*op_size - 1] != '[') || (!scope_flag && *op_size > 0))
+	if (utf8_is_letter((char32_t)env->curchar))
 	{
-		if (*stk_size < 2 || *op_size == 0)
-		{	
-			return -1;
+		if (calc->is_compiled)
+		{
+			return calc_parse_name(calc);
 		}
 
-		is_int[*stk_size - 2] = is_int[*stk_size - 2] && is_int[*stk_size - 1];
-		stack[*stk_size - 2] = calc_count(stack[*stk_size - 2], stack[*stk_size - 1], operation[*op_size - 1], is_int[*stk_size - 2]);
-		*op_size = *op_size - 1;
-		*stk_size = *stk_size - 1;
+		return calc_macro(calc) ? SIZE_MAX : calc_parse_operand(calc, type);
 	}
 
-	*op_size = *op_size - 1;
-	return 0;
-}
-
-int additional_elements(environment *const env, double *const stack, int *const is_int, char *const operation, int *op_size, int *stk_size, int *type, int opration_flag)
-{
-	if (env->curchar == '#' && *type == LOGIC && !opration_flag)
+	if (env->curchar == '#' && type == LOGIC)
 	{
-		const int cur = macro_keywords(env);
-		if (cur == SH_EVAL && env->curchar == '(')
+		if (calc->is_compiled)
 		{
-			*type = ARITHMETIC;
-			operation[*op_size] = '[';
-			*op_size = *op_size + 1;
-			m_nextch(env);
-			return 1;
+			calc->was_error = true;
+			return SIZE_MAX;
 		}
-		else
+
+		if (macro_keywords(env) != SH_EVAL || env->curchar != '(')
 		{
-			env_error(env, after_eval_must_be_ckob);//
-			return -1;
+			calc_error(calc, after_eval_must_be_ckob);
+			return SIZE_MAX;
 		}
+
+		return calc_parse_scope(calc, ARITHMETIC);
 	}
 
-	if(utf8_is_letter(env->curchar))
+	if (env->curchar == '(')
 	{
-		if(calc_macro(env))
-		{
-			return -1;
-		}
-		return 1;
+		return calc_parse_scope(calc, type);
 	}
 
-	if (env->curchar == '(' && !opration_flag)
+	if (utf8_is_digit((char32_t)env->curchar)
+		|| (env->curchar == '-' && utf8_is_digit((char32_t)env->nextchar)))
 	{
-		operation[*op_size] = '(';
-		*op_size = *op_size + 1;
-		m_nextch(env);
-		return 1;
+		calc_value val;
+		return calc_read_number(calc, &val) ? SIZE_MAX : calc_add_value(calc, &val);
 	}
 
-	if (env->curchar == ')' && opration_flag)
+	calc_error(calc, third_party_symbol);
+	return SIZE_MAX;
+}
+
+/**
+ *	Parse expression with operations of given priority and higher
+ *
+ *	@param	calc		Expression parser
+ *	@param	type		Type of expression
+ *	@param	prior		The lowest priority of operations
+ *
+ *	@return	Index of expression node in tree, @c SIZE_MAX on failure
+ */
+static size_t calc_parse_expression(calculator *const calc, const int type, const int prior)
+{
+	environment *const env = calc->env;
+	size_t left = calc_parse_operand(calc, type);
+
+	while (left != SIZE_MAX)
 	{
-		operation[*op_size] = ')';
-		*op_size = *op_size + 1;
-		if(calc_close(stack, is_int, operation, op_size, stk_size))
+		skip_separators(env);
+		if (!calc->is_compiled && utf8_is_letter((char32_t)env->curchar))
 		{
-			env_error(env, incorrect_arithmetic_expression);
-			return -1;
+			// Макрос может продолжать выражение операцией
+			if (calc_macro(calc))
+			{
+				return SIZE_MAX;
+			}
+			continue;
+		}
+
+		const char operation = get_operation(env->curchar, env->nextchar);
+		const int operation_prior = get_prior(operation);
+		if (operation_prior == 0 || operation_prior < prior)
+		{
+			return left;
 		}
 
 		m_nextch(env);
-		if (operation[*op_size] == '[')
+		if (operation == 'b' || operation == 's' || operation == '=' || operation == '&' || operation == '|'
+			|| operation == '!')
 		{
-			*type = LOGIC;
+			m_nextch(env);
 		}
-		if (*op_size == 0 && *type == ARITHMETIC)
+
+		if (type == LOGIC && operation_prior > 3)
 		{
-			double_to_string(env, stack[0], is_int[0]);
-			return 0;
+			calc_error(calc, not_arithmetic_operations);
+			return SIZE_MAX;
 		}
-		return 1;
+		if (type == ARITHMETIC && operation_prior <= 3)
+		{
+			calc_error(calc, not_logical_operations);
+			return SIZE_MAX;
+		}
+
+		const size_t right = calc_parse_expression(calc, type, operation_prior + 1);
+		if (right == SIZE_MAX)
+		{
+			return SIZE_MAX;
+		}
+
+		left = calc_add_node(calc, CALC_OPERATION, (item_t)operation, left, right);
 	}
 
-	return 2;
+	return SIZE_MAX;
 }
 
-int calculate(environment *const env, const int type)
+
+static inline double calc_to_double(const calc_value *const val)
 {
-	int op_size = 0;
-	char operation[OPN_SIZE];
-	int locl_type = type;
+	return val->is_int ? (double)val->integer : val->real;
+}
+
+static inline bool calc_is_true(const calc_value *const val)
+{
+	return val->is_int ? val->integer != 0 : val->real != 0;
+}
 
-	if (type == ARITHMETIC)
+/**
+ *	Apply operation to values
+ *	@note	Comparisons and logical operations give integer, arithmetic on integers is performed in 64 bits
+ *
+ *	@param	calc		Expression parser
+ *	@param	operation	Operation
+ *	@param	x			Left value
+ *	@param	y			Right value
+ *	@param	result		Result value
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+static int calc_apply(calculator *const calc, const char operation, const calc_value *const x
+	, const calc_value *const y, calc_value *const result)
+{
+	const bool is_int = x->is_int && y->is_int;
+	if (get_prior(operation) <= 3)
 	{
-		operation[op_size++] = '(';
-		m_nextch(env);
+		const double a = calc_to_double(x);
+		const double b = calc_to_double(y);
+
+		result->is_int = true;
+		switch (operation)
+		{
+			case '<':
+				result->integer = is_int ? x->integer < y->integer : a < b;
+				break;
+			case '>':
+				result->integer = is_int ? x->integer > y->integer : a > b;
+				break;
+			case 's':
+				result->integer = is_int ? x->integer <= y->integer : a <= b;
+				break;
+			case 'b':
+				result->integer = is_int ? x->integer >= y->integer : a >= b;
+				break;
+			case '=':
+				result->integer = is_int ? x->integer == y->integer : a == b;
+				break;
+			case '!':
+				result->integer = is_int ? x->integer != y->integer : a != b;
+				break;
+			case '&':
+				result->integer = calc_is_true(x) && calc_is_true(y);
+				break;
+			default:
+				result->integer = calc_is_true(x) || calc_is_true(y);
+				break;
+		}
+
+		return 0;
 	}
 
-	int stk_size = 0;
-	double stack[STK_SIZE];
-	int is_int[STK_SIZE];
-	int opration_flag = 0;
-	while (env->curchar != '\n')
+	result->is_int = is_int;
+	if (!is_int)
 	{
-		skip_separators(env);
-		const int rez = additional_elements(env, stack, is_int, operation, &op_size, &stk_size, &locl_type, opration_flag);
-		if(rez == -1 || rez == 0)
+		const double a = calc_to_double(x);
+		const double b = calc_to_double(y);
+		switch (operation)
 		{
-			return rez;
-		} 
-		else if (rez == 1)
-		{
-			continue;
+			case '+':
+				result->real = a + b;
+				break;
+			case '-':
+				result->real = a - b;
+				break;
+			case '*':
+				result->real = a * b;
+				break;
+			case '/':
+				result->real = a / b;
+				break;
+			default:
+				result->real = fmod(a, b);
+				break;
 		}
 
-		if(!opration_flag && (utf8_is_digit(env->curchar) || (env->curchar == '-' && utf8_is_digit(env->nextchar))))
-		{
-			opration_flag = 1;
-			if(calc_digit(env, stack, is_int, &stk_size))
+		return 0;
+	}
+
+	// Переполнение в беззнаковой арифметике определено
+	const uint64_t a = (uint64_t)x->integer;
+	const uint64_t b = (uint64_t)y->integer;
+	switch (operation)
+	{
+		case '+':
+			result->integer = (int64_t)(a + b);
+			return 0;
+		case '-':
+			result->integer = (int64_t)(a - b);
+			return 0;
+		case '*':
+			result->integer = (int64_t)(a * b);
+			return 0;
+		default:
+			if (y->integer == 0)
 			{
+				calc_error(calc, incorrect_arithmetic_expression);
 				return -1;
 			}
-		}
-		else if(opration_flag && env->curchar != '\n')
+
+			if (y->integer == -1)
+			{
+				result->integer = operation == '/' ? (int64_t)(~a + 1) : 0;
+			}
+			else
+			{
+				result->integer = operation == '/' ? x->integer / y->integer : x->integer % y->integer;
+			}
+			return 0;
+	}
+}
+
+/**
+ *	Get value of macro, which is defined by single number
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	repr	Index of macro name in reprtab
+ *	@param	val		Value of macro
+ *
+ *	@return	@c 0 on success, @c -1 if macro should be expanded by text
+ */
+static int calc_macro_value(environment *const env, const size_t repr, calc_value *const val)
+{
+	if ((int)repr < env->mfirstrp)
+	{
+		return -1;
+	}
+
+	const size_t index = (size_t)tab_get(&env->reprtab, repr + 1);
+	return tab_get(&env->macro_tab, index) == MACRODEF ? tab_read_number(&env->macro_tab, index + 1, val) : -1;
+}
+
+/**
+ *	Calculate expression tree
+ *
+ *	@param	calc		Expression parser
+ *	@param	node		Index of expression node in tree
+ *	@param	val			Value of expression
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+static int calc_eval(calculator *const calc, const size_t node, calc_value *const val)
+{
+	switch (vector_get(calc->tree, node))
+	{
+		case CALC_INTEGER:
+			val->is_int = true;
+			val->integer = vector_get_int64(calc->tree, node + 4);
+			return 0;
+
+		case CALC_DOUBLE:
+			val->is_int = false;
+			val->real = vector_get_double(calc->tree, node + 4);
+			return 0;
+
+		case CALC_MACRO:
+			return calc_macro_value(calc->env, (size_t)vector_get(calc->tree, node + 1), val);
+
+		case CALC_OPERATION:
 		{
-			opration_flag = 0;
-			if(calc_opiration(env, stack, is_int, operation, &op_size, &stk_size, locl_type))
+			calc_value x;
+			calc_value y;
+			if (calc_eval(calc, (size_t)vector_get(calc->tree, node + 2), &x)
+				|| calc_eval(calc, (size_t)vector_get(calc->tree, node + 3), &y))
 			{
 				return -1;
 			}
+
+			return calc_apply(calc, (char)vector_get(calc->tree, node + 1), &x, &y, val);
 		}
-		else if(env->curchar != '\n')
-		{
-			env_error(env, third_party_symbol);
+
+		default:
 			return -1;
-		}
 	}
+}
+
 
-	if (locl_type == LOGIC)
+static void double_to_string(environment *const env, const double x)
+{
+	char s[30] = "\0";
+	int l = 0;
+
+	sprintf(s, "%.14lf", x);
+	for (env->calc_string_size = 0; env->calc_string_size < 20; env->calc_string_size++)
 	{
-		if(calc_close(stack, is_int, operation, &op_size, &stk_size))
-		{
-			env_error(env, incorrect_arithmetic_expression);
-			return -1;
-		}
+		tab_set(&env->calc_string, env->calc_string_size, s[env->calc_string_size]);
 
-		if (stack[0] == 0)
-		{
-			env->calc_string[0] = 0;
-		}
-		else
+		if (s[env->calc_string_size] != '0' && utf8_is_digit(s[env->calc_string_size]))
 		{
-			env->calc_string[0] = 1;
+			l = (int)env->calc_string_size;
 		}
 	}
-	else
+	env->calc_string_size = l + 1;
+}
+
+static void value_to_string(environment *const env, const calc_value *const val)
+{
+	if (!val->is_int)
+	{
+		double_to_string(env, val->real);
+		return;
+	}
+
+	char s[MAX_NUMBER_SIZE];
+	const int size = sprintf(s, "%" PRIi64, val->integer);
+	for (env->calc_string_size = 0; env->calc_string_size < (size_t)size; env->calc_string_size++)
+	{
+		tab_set(&env->calc_string, env->calc_string_size, s[env->calc_string_size]);
+	}
+}
+
+
+/*
+ *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
+ *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
+ *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
+ *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
+ *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+ */
+
+
+int calculate(environment *const env, const int type)
+{
+	vector_resize(&env->calc_tree, 0);
+	calculator calc = { env, &env->calc_tree, false, false };
+
+	size_t root = type == ARITHMETIC
+		? calc_parse_scope(&calc, ARITHMETIC)
+		: calc_parse_expression(&calc, LOGIC, 1);
+
+	if (type == LOGIC && root != SIZE_MAX && env->curchar != '\n')
 	{
-		env_error(env, in_eval_must_end_parenthesis);
+		calc_error(&calc, env->curchar == ')' ? incorrect_arithmetic_expression : third_party_symbol);
+		root = SIZE_MAX;
+	}
+
+	calc_value val;
+	const int ret = root == SIZE_MAX || calc_eval(&calc, root, &val) ? -1 : 0;
+	if (!ret && type == LOGIC)
+	{
+		tab_set(&env->calc_string, 0, calc_is_true(&val));
+	}
+	else if (!ret)
+	{
+		value_to_string(env, &val);
+	}
+
+	return ret;
+}
+
+int calc_compile(environment *const env, const size_t begin, vector *const program)
+{
+	calculator calc = { env, program, true, false };
+	const size_t program_size = vector_size(program);
+	const int depth = get_depth(env);
+
+	vector_add(program, 0);
+	m_change_nextch_type(env, IFTYPE, (int)begin);
+	m_nextch(env);
+
+	const size_t root = calc_parse_expression(&calc, LOGIC, 1);
+	const bool is_correct = root != SIZE_MAX && env->curchar == '\n' && get_depth(env) > depth;
+	while (get_depth(env) > depth)
+	{
+		m_old_nextch_type(env);
+	}
+
+	if (!is_correct)
+	{
+		vector_resize(program, program_size);
 		return -1;
 	}
 
+	vector_set(program, program_size, (item_t)root);
 	return 0;
 }
+
+int calc_run(environment *const env, vector *const program, const size_t begin)
+{
+	calculator calc = { env, program, true, false };
+
+	calc_value val;
+	if (calc_eval(&calc, (size_t)vector_get(program, begin), &val))
+	{
+		return -1;
+	}
+
+	const int truth = calc_is_true(&val);
+	tab_set(&env->calc_string, 0, truth);
+	return truth;
+}
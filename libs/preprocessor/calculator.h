@@ -37,6 +37,30 @@ extern "C" {
  */
 int calculate(environment *const env, const int type);
 
+/**
+ *	Compile a logical expression to tree for repeated calculation
+ *	@note	Expression is compiled, if it consists of numbers, macro names, parentheses and operations
+ *
+ *	@param	env				Preprocessor environment
+ *	@param	begin			Index of expression in if_string, which ends with line break
+ *	@param	program			Vector to add compiled expression
+ *
+ *	@return	@c 0 on success, @c -1 if expression should be calculated by text
+ */
+int calc_compile(environment *const env, const size_t begin, vector *const program);
+
+/**
+ *	Calculate a compiled logical expression
+ *	@note	Macros are substituted, if they are defined by single number
+ *
+ *	@param	env				Preprocessor environment
+ *	@param	program			Vector with compiled expression
+ *	@param	begin			Index of compiled expression in vector
+ *
+ *	@return	@c 1 on true, @c 0 on false, @c -1 if expression should be calculated by text
+ */
+int calc_run(environment *const env, vector *const program, const size_t begin);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -18,7 +18,7 @@
 
 #define MACRODEBUG 1
 
-#define MAXTAB		100000
+#define TAB_SIZE	1024
 #define LONGSTR		10000
 #define STRING_SIZE	256
 #define HASH		256
@@ -19,11 +19,12 @@
 #include "commenter.h"
 #include "error.h"
 #include "uniprinter.h"
-#include "uniscanner.h"
+#include <stdlib.h>
 #include <string.h>
 
 
 #define MAX_CMT_SIZE MAX_ARG_SIZE + 32
+#define MAX_CHAR_SIZE 4
 
 
 static inline int is_recovery_disabled(const workspace *const ws)
@@ -42,9 +43,126 @@ static inline int is_recovery_disabled(const workspace *const ws)
 	}
 }
 
+static inline uint32_t name_hash(const table *const tab, const size_t begin, const size_t size)
+{
+	// FNV-1a по кодам символов
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ (uint32_t)tab_get(tab, begin + i)) * 16777619u;
+	}
+
+	return hash ^ (hash >> 15);
+}
+
+static inline item_t name_key(const table *const tab, const size_t begin, const size_t size)
+{
+	// FNV-1a с 64-битным результатом, чтобы совпадения ключей разных имён были маловероятны
+	uint64_t key = 14695981039346656037u;
+	for (size_t i = 0; i < size; i++)
+	{
+		key = (key ^ (uint32_t)tab_get(tab, begin + i)) * 1099511628211u;
+	}
+
+	return (item_t)key;
+}
+
+static inline bool name_equal(const table *const first, const size_t first_begin
+	, const table *const second, const size_t second_begin, const size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		if (tab_get(first, first_begin + i) != tab_get(second, second_begin + i))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static inline void names_insert(name_record *const names, const size_t alloc, const size_t repr, const uint32_t hash)
+{
+	size_t i = hash & (alloc - 1);
+	while (names[i].repr != 0)
+	{
+		i = (i + 1) & (alloc - 1);
+	}
+
+	names[i].repr = repr;
+	names[i].hash = hash;
+}
+
+static int names_grow(environment *const env)
+{
+	const size_t alloc = 2 * env->names_alloc;
+	name_record *const names = calloc(alloc, sizeof(name_record));
+	if (names == NULL)
+	{
+		return -1;
+	}
+
+	for (size_t i = 0; i < env->names_alloc; i++)
+	{
+		if (env->names[i].repr != 0)
+		{
+			names_insert(names, alloc, env->names[i].repr, env->names[i].hash);
+		}
+	}
+
+	free(env->names);
+	env->names = names;
+	env->names_alloc = alloc;
+	return 0;
+}
+
+static int env_reserve_error_string(environment *const env, const size_t size)
+{
+	// Место под завершающий ноль
+	if (env->position + size + 1 <= env->error_string_alloc)
+	{
+		return 0;
+	}
+
+	size_t alloc = 2 * env->error_string_alloc;
+	while (env->position + size + 1 > alloc)
+	{
+		alloc *= 2;
+	}
+
+	char *const error_string = realloc(env->error_string, alloc);
+	if (error_string == NULL)
+	{
+		return -1;
+	}
+
+	memset(&error_string[env->error_string_alloc], 0, alloc - env->error_string_alloc);
+	env->error_string = error_string;
+	env->error_string_alloc = alloc;
+	return 0;
+}
+
+
+static void env_add_error_string(environment *const env, const char *const text, const size_t size)
+{
+	if (size == 0 || env_reserve_error_string(env, size))
+	{
+		return;
+	}
+
+	memcpy(&env->error_string[env->position], text, size);
+	env->position += size;
+	env->error_string[env->position] = '\0';
+}
+
+
 void env_init(environment *const env, linker *const lk, universal_io *const output)
 {
 	env->output = output;
+	env->comments = NULL;
+
+	env->lookups = NULL;
+	env->is_quiet = 0;
 
 	env->lk = lk;
 
@@ -66,51 +184,141 @@ void env_init(environment *const env, linker *const lk, universal_io *const outp
 	env->line = 1;
 	env->position = 0;
 	env->nested_if = 0;
-	env->flagint = 1;
-	env->error_string[0] = '\0';
+	env->error_string = calloc(STRING_SIZE, sizeof(char));
+	env->error_string_alloc = STRING_SIZE;
 
 	env->was_error = 0;
 	env->disable_recovery = is_recovery_disabled(lk->ws);
 
-	for (size_t i = 0; i < HASH; i++)
-	{
-		env->hashtab[i] = 0;
-	}
+	env->names = calloc(HASH, sizeof(name_record));
+	env->names_size = 0;
+	env->names_alloc = HASH;
+
+	env->reprtab = tab_create(TAB_SIZE);
+	env->macro_tab = tab_create(TAB_SIZE);
+	env->mstring = tab_create(STRING_SIZE);
+	env->change = tab_create(STRING_SIZE);
+	env->localstack = tab_create(STRING_SIZE);
+	env->calc_string = tab_create(STRING_SIZE);
+	env->calc_tree = vector_create(STRING_SIZE);
+	env->if_string = tab_create(STRING_SIZE);
+	env->while_string = tab_create(STRING_SIZE);
+
+	env->while_loops = malloc(DEPTH * sizeof(while_loop));
+	env->while_loops_size = 0;
+	env->while_loops_alloc = DEPTH;
+	env->while_index = hash_create(DEPTH);
+
+	env->while_ops = malloc(STRING_SIZE * sizeof(while_op));
+	env->while_ops_size = 0;
+	env->while_ops_alloc = STRING_SIZE;
+
+	env->while_conditions = vector_create(STRING_SIZE);
+	env->while_text = malloc(STRING_SIZE * sizeof(char));
+	env->while_text_size = 0;
+	env->while_text_alloc = STRING_SIZE;
+
+	env->oldcurchar = tab_create(DEPTH);
+	env->oldnextchar = tab_create(DEPTH);
+	env->oldnextch_type = tab_create(DEPTH);
+	env->oldnextp = tab_create(DEPTH);
+}
 
-	for (size_t i = 0; i < MAXTAB; i++)
-	{
-		env->reprtab[i] = 0;
-	}
+void env_clear(environment *const env)
+{
+	tab_clear(&env->reprtab);
+	tab_clear(&env->macro_tab);
+	tab_clear(&env->mstring);
+	tab_clear(&env->change);
+	tab_clear(&env->localstack);
+	tab_clear(&env->calc_string);
+	vector_clear(&env->calc_tree);
+	tab_clear(&env->if_string);
+	tab_clear(&env->while_string);
+
+	free(env->while_loops);
+	env->while_loops = NULL;
+	hash_clear(&env->while_index);
+
+	free(env->while_ops);
+	env->while_ops = NULL;
+
+	vector_clear(&env->while_conditions);
+	free(env->while_text);
+	env->while_text = NULL;
+
+	tab_clear(&env->oldcurchar);
+	tab_clear(&env->oldnextchar);
+	tab_clear(&env->oldnextch_type);
+	tab_clear(&env->oldnextp);
+
+	free(env->error_string);
+	env->error_string = NULL;
+
+	free(env->names);
+	env->names = NULL;
+}
 
-	for (size_t i = 0; i < STRING_SIZE; i++)
-	{
-		env->mstring[i] = 0;
-		env->localstack[i] = 0;
-		env->calc_string[i] = 0;
-	}
+size_t env_get_name(const environment *const env, const table *const tab, const size_t begin, const size_t size)
+{
+	const uint32_t hash = name_hash(tab, begin, size);
+	const size_t mask = env->names_alloc - 1;
 
-	for (size_t i = 0; i < STRING_SIZE * 3; i++)
+	if (env->lookups != NULL)
 	{
-		env->change[i] = 0;
+		hash_add(env->lookups, name_key(tab, begin, size), 0);
 	}
 
-	for (size_t i = 0; i < STRING_SIZE * 2; i++)
+	for (size_t i = hash & mask; env->names[i].repr != 0; i = (i + 1) & mask)
 	{
-		env->if_string[i] = 0;
+		const size_t repr = env->names[i].repr;
+		if (env->names[i].hash == hash && (size_t)tab_get(&env->reprtab, repr) == size
+			&& name_equal(&env->reprtab, repr + 2, tab, begin, size))
+		{
+			return repr;
+		}
 	}
 
-	for (size_t i = 0; i < STRING_SIZE * 5; i++)
+	return 0;
+}
+
+item_t env_get_name_key(const environment *const env, const size_t repr)
+{
+	return name_key(&env->reprtab, repr + 2, (size_t)tab_get(&env->reprtab, repr));
+}
+
+int env_add_name(environment *const env, const size_t repr)
+{
+	if (2 * (env->names_size + 1) > env->names_alloc && names_grow(env))
 	{
-		env->while_string[i] = 0;
+		return -1;
 	}
 
-	for (size_t i = 0; i < DEPTH; i++)
+	const uint32_t hash = name_hash(&env->reprtab, repr + 2, (size_t)tab_get(&env->reprtab, repr));
+	names_insert(env->names, env->names_alloc, repr, hash);
+	env->names_size++;
+	return 0;
+}
+
+size_t env_get_macro(const environment *const env, const table *const tab, const size_t begin, const size_t size)
+{
+	const size_t r = env_get_name(env, tab, begin, size);
+
+	// Ключевые слова препроцессора не являются макросами
+	if (r != 0 && (int)r >= env->mfirstrp)
 	{
-		env->oldcurchar[i] = 0;
-		env->oldnextchar[i] = 0;
-		env->oldnextch_type[i] = 0;
-		env->oldnextp[i] = 0;
+		return tab_get(&env->macro_tab, tab_get(&env->reprtab, r + 1)) != MACROUNDEF ? r : 0;
 	}
+
+	return 0;
+}
+
+bool env_is_lost(const environment *const env)
+{
+	return env->reprtab.is_lost || env->macro_tab.is_lost || env->mstring.is_lost || env->change.is_lost
+		|| env->localstack.is_lost || env->calc_string.is_lost || env->if_string.is_lost
+		|| env->while_string.is_lost || env->oldcurchar.is_lost || env->oldnextchar.is_lost
+		|| env->oldnextch_type.is_lost || env->oldnextp.is_lost;
 }
 
 void env_clear_error_string(environment *const env)
@@ -121,6 +329,12 @@ void env_clear_error_string(environment *const env)
 void env_add_comment(environment *const env)
 {
 	comment cmt = cmt_create(lk_get_current(env->lk), env->line);
+	if (env->comments != NULL)
+	{
+		m_fprintf(env, '\n');
+		cmt_map_add(env->comments, out_get_position(env->output), &cmt);
+		return;
+	}
 
 	char buffer[MAX_CMT_SIZE];
 	cmt_to_string(&cmt, buffer);
@@ -145,7 +359,7 @@ size_t env_skip_str(environment *const env)
 
 int get_next_char(environment *const env)
 {
-	env->nextchar = uni_scan_char(env->input);
+	env->nextchar = in_get_char(env->input);
 	return env->nextchar == U'\r' ? get_next_char(env) : env->nextchar;
 }
 
@@ -156,10 +370,10 @@ int get_depth(environment *const env)
 
 void m_change_nextch_type(environment *const env, int type, int p)
 {
-	env->oldcurchar[env->depth] = env->curchar;
-	env->oldnextchar[env->depth] = env->nextchar;
-	env->oldnextch_type[env->depth] = env->nextch_type;
-	env->oldnextp[env->depth] = (int)env->nextp;
+	tab_set(&env->oldcurchar, env->depth, env->curchar);
+	tab_set(&env->oldnextchar, env->depth, env->nextchar);
+	tab_set(&env->oldnextch_type, env->depth, env->nextch_type);
+	tab_set(&env->oldnextp, env->depth, (int)env->nextp);
 	env->nextp = p;
 	env->depth++;
 	env->nextch_type = type;
@@ -168,10 +382,10 @@ void m_change_nextch_type(environment *const env, int type, int p)
 void m_old_nextch_type(environment *const env)
 {
 	env->depth--;
-	env->curchar = env->oldcurchar[env->depth];
-	env->nextchar = env->oldnextchar[env->depth];
-	env->nextch_type = env->oldnextch_type[env->depth];
-	env->nextp = env->oldnextp[env->depth];
+	env->curchar = tab_get(&env->oldcurchar, env->depth);
+	env->nextchar = tab_get(&env->oldnextchar, env->depth);
+	env->nextch_type = tab_get(&env->oldnextch_type, env->depth);
+	env->nextp = tab_get(&env->oldnextp, env->depth);
 }
 
 void end_line(environment *const env)
@@ -197,9 +411,322 @@ void m_fprintf(environment *const env, int a)
 	uni_print_char(env->output, a);
 }
 
+/**
+ *	Walk loaded input by whole UTF-8 characters up to the first stop character
+ *	@note	Walk also stops before malformed or partially loaded character,
+ *			so line breaks in walked text are real characters
+ *
+ *	@param	text		Loaded input
+ *	@param	available	Number of loaded bytes
+ *	@param	stops		ASCII stop characters
+ *
+ *	@return	Number of walked bytes
+ */
+static inline size_t text_walk(const char *const text, const size_t available, const char *const stops)
+{
+	if (text == NULL)
+	{
+		return 0;
+	}
+
+	// Все используемые символы остановки меньше 64
+	uint64_t mask = 0;
+	for (size_t i = 0; stops[i] != '\0'; i++)
+	{
+		mask |= (uint64_t)1 << stops[i];
+	}
+
+	size_t size = 0;
+	while (size < available)
+	{
+		const unsigned char byte = (unsigned char)text[size];
+		if (byte < 64 && (mask >> byte) & 1)
+		{
+			return size;
+		}
+
+		if (byte < 0x80)
+		{
+			size++;
+			continue;
+		}
+
+		const size_t symbol = utf8_symbol_size((char)byte);
+		if (symbol == 1 || size + symbol > available)
+		{
+			return size;
+		}
+
+		for (size_t i = 1; i < symbol; i++)
+		{
+			if (((unsigned char)text[size + i] & 0xC0) != 0x80)
+			{
+				return size;
+			}
+		}
+		size += symbol;
+	}
+
+	return size;
+}
+
+static inline bool is_ascii_letter(const int character)
+{
+	return (character >= 'a' && character <= 'z') || (character >= 'A' && character <= 'Z') || character == '_';
+}
+
+/**
+ *	Check that character is copied to output as is and does not change line
+ *
+ *	@param	env			Preprocessor environment
+ *	@param	character	Character
+ *
+ *	@return	@c true on plain text character, @c false otherwise
+ */
+static inline bool is_text_char(const environment *const env, const int character)
+{
+	switch (character)
+	{
+		case '#':
+		case '\'':
+		case '"':
+		case '@':
+		case '/':
+			return false;
+		default:
+			// Без макроопределений идентификаторы выводятся без изменений
+			return (character == '\t' || (character >= ' ' && character <= '~'))
+				&& (env->prep_flag != 1 || !is_ascii_letter(character));
+	}
+}
+
+void m_fprintf_text(environment *const env)
+{
+	m_fprintf(env, env->curchar);
+	if (env->nextch_type != FILETYPE || !is_text_char(env, env->nextchar))
+	{
+		m_nextch(env);
+		return;
+	}
+
+	size_t available = 0;
+	const char *const text = in_get_cursor(env->input, &available);
+	size_t size = 0;
+	while (size < available && is_text_char(env, (unsigned char)text[size]))
+	{
+		size++;
+	}
+
+	if (size == 0 || env_reserve_error_string(env, size + 1))
+	{
+		m_nextch(env);
+		return;
+	}
+
+	// Последний символ фрагмента становится текущим, как после m_nextch
+	m_fprintf(env, env->nextchar);
+	out_write(env->output, text, size - 1);
+
+	env->error_string[env->position++] = (char)env->nextchar;
+	memcpy(&env->error_string[env->position], text, size);
+	env->position += size;
+	env->error_string[env->position] = '\0';
+
+	env->curchar = (unsigned char)text[size - 1];
+	in_skip(env->input, size);
+	get_next_char(env);
+}
+
+static inline bool is_ascii_ident_char(const int character)
+{
+	return is_ascii_letter(character) || (character >= '0' && character <= '9');
+}
+
+bool m_fprintf_ident(environment *const env)
+{
+	if (env->nextch_type != FILETYPE || !is_ascii_letter(env->curchar))
+	{
+		return false;
+	}
+
+	// Идентификатор из текущего, следующего и загруженных символов, как в collect_mident
+	size_t available = 0;
+	const char *const text = in_get_cursor(env->input, &available);
+	const bool is_long = is_ascii_ident_char(env->nextchar);
+	if (!is_long && utf8_is_letter(env->nextchar))
+	{
+		return false;
+	}
+
+	env->msp = 0;
+	tab_set(&env->mstring, env->msp++, env->curchar);
+
+	size_t size = 0;
+	if (is_long)
+	{
+		tab_set(&env->mstring, env->msp++, env->nextchar);
+		while (size < available && is_ascii_ident_char((unsigned char)text[size]))
+		{
+			tab_set(&env->mstring, env->msp++, (unsigned char)text[size]);
+			size++;
+		}
+
+		// Символ после идентификатора становится текущим, поэтому он должен быть простым текстом
+		if (size == available || !is_text_char(env, (unsigned char)text[size])
+			|| env_reserve_error_string(env, size + 2))
+		{
+			return false;
+		}
+	}
+
+	tab_set(&env->mstring, env->msp, MACROEND);
+	if (env_get_macro(env, &env->mstring, 0, env->msp))
+	{
+		return false;
+	}
+
+	if (!is_long)
+	{
+		m_fprintf(env, env->curchar);
+		m_nextch(env);
+		return true;
+	}
+
+	const char head[] = { (char)env->curchar, (char)env->nextchar };
+	out_write(env->output, head, 2);
+	out_write(env->output, text, size);
+
+	env->error_string[env->position++] = head[1];
+	memcpy(&env->error_string[env->position], text, size + 1);
+	env->position += size + 1;
+	env->error_string[env->position] = '\0';
+
+	env->curchar = (unsigned char)text[size];
+	in_skip(env->input, size + 1);
+	get_next_char(env);
+	return true;
+}
+
+void m_skip_text(environment *const env)
+{
+	if (env->nextch_type != FILETYPE || env->nextchar == '#' || env->nextchar == '/' || env->nextchar == EOF)
+	{
+		m_nextch(env);
+		return;
+	}
+
+	// Фрагмент заканчивается перед директивой, возможным комментарием или возвратом каретки
+	size_t available = 0;
+	const char *const text = in_get_cursor(env->input, &available);
+	size_t size = text_walk(text, available, "#/\r");
+
+	// Последний символ фрагмента становится текущим, поэтому он должен быть однобайтовым
+	while (size > 0 && (unsigned char)text[size - 1] >= 0x80)
+	{
+		do
+		{
+			size--;
+		} while (((unsigned char)text[size] & 0xC0) == 0x80);
+	}
+
+	if (size == 0)
+	{
+		m_nextch(env);
+		return;
+	}
+
+	size_t line_begin = 0;
+	if (env->nextchar == '\n')
+	{
+		end_line(env);
+		env_clear_error_string(env);
+	}
+	else if (!env_reserve_error_string(env, MAX_CHAR_SIZE))
+	{
+		env->position += utf8_to_string(&env->error_string[env->position], env->nextchar);
+	}
+
+	// Строка для сообщений об ошибках заполняется так же, как посимвольно
+	for (const char *line = memchr(text, '\n', size); line != NULL
+		; line = memchr(line + 1, '\n', size - (size_t)(line + 1 - text)))
+	{
+		env_add_error_string(env, &text[line_begin], (size_t)(line - text) - line_begin);
+		end_line(env);
+		env_clear_error_string(env);
+		line_begin = (size_t)(line + 1 - text);
+	}
+	env_add_error_string(env, &text[line_begin], size - line_begin);
+
+	env->curchar = (unsigned char)text[size - 1];
+	in_skip(env->input, size);
+	get_next_char(env);
+}
+
+/**
+ *	Skip line comment in loaded input up to line break, which becomes current character
+ *
+ *	@param	env	Preprocessor environment
+ *
+ *	@return	@c true on success, @c false if line break is not loaded
+ */
+static inline bool comment_skip_line(environment *const env)
+{
+	size_t available = 0;
+	const char *const text = in_get_cursor(env->input, &available);
+	const size_t size = text_walk(text, available, "\n");
+	if (size == available || text[size] != '\n')
+	{
+		return false;
+	}
+
+	in_skip(env->input, size + 1);
+	env->curchar = '\n';
+	get_next_char(env);
+	return true;
+}
+
+/**
+ *	Skip block comment in loaded input, space becomes current character
+ *
+ *	@param	env	Preprocessor environment
+ *
+ *	@return	@c true on success, @c false if comment end is not loaded
+ */
+static inline bool comment_skip_block(environment *const env)
+{
+	size_t available = 0;
+	const char *const text = in_get_cursor(env->input, &available);
+	size_t size = text_walk(text, available, "*");
+
+	while (size + 1 < available && text[size] == '*' && text[size + 1] != '/')
+	{
+		if (text[size + 1] == '\r')
+		{
+			return false;
+		}
+		size += 1 + text_walk(&text[size + 1], available - size - 1, "*");
+	}
+
+	if (size + 1 >= available || text[size] != '*')
+	{
+		return false;
+	}
+
+	for (const char *line = memchr(text, '\n', size); line != NULL
+		; line = memchr(line + 1, '\n', size - (size_t)(line + 1 - text)))
+	{
+		end_line(env);
+	}
+
+	in_skip(env->input, size + 2);
+	get_next_char(env);
+	env->curchar = ' ';
+	return true;
+}
+
 void m_coment_skip(environment *const env)
 {
-	if (env->curchar == '/' && env->nextchar == '/')
+	if (env->curchar == '/' && env->nextchar == '/' && !comment_skip_line(env))
 	{
 		do
 		{
@@ -213,7 +740,7 @@ void m_coment_skip(environment *const env)
 		} while (env->curchar != '\n');
 	}
 
-	if (env->curchar == '/' && env->nextchar == '*')
+	if (env->curchar == '/' && env->nextchar == '*' && !comment_skip_block(env))
 	{
 		// m_fprintf_com();
 		m_onemore(env);
@@ -245,7 +772,7 @@ void m_coment_skip(environment *const env)
 void m_nextch_cange(environment *const env)
 {
 	m_nextch(env);
-	m_change_nextch_type(env, FTYPE, env->localstack[env->curchar + env->local_stack_size]);
+	m_change_nextch_type(env, FTYPE, tab_get(&env->localstack, env->curchar + env->local_stack_size));
 	m_nextch(env);
 }
 
@@ -255,28 +782,28 @@ void m_nextch(environment *const env)
 	{
 		if (env->nextch_type == MTYPE && env->nextp < env->msp)
 		{
-			env->curchar = env->mstring[env->nextp++];
-			env->nextchar = env->mstring[env->nextp];
+			env->curchar = tab_get(&env->mstring, env->nextp++);
+			env->nextchar = tab_get(&env->mstring, env->nextp);
 		}
 		else if (env->nextch_type == CTYPE && env->nextp < env->calc_string_size)
 		{
-			env->curchar = env->calc_string[env->nextp++];
-			env->nextchar = env->calc_string[env->nextp];
+			env->curchar = tab_get(&env->calc_string, env->nextp++);
+			env->nextchar = tab_get(&env->calc_string, env->nextp);
 		}
 		else if (env->nextch_type == IFTYPE && env->nextp < env->if_string_size)
 		{
-			env->curchar = env->if_string[env->nextp++];
-			env->nextchar = env->if_string[env->nextp];
+			env->curchar = tab_get(&env->if_string, env->nextp++);
+			env->nextchar = tab_get(&env->if_string, env->nextp);
 		}
 		else if (env->nextch_type == WHILETYPE && env->nextp < env->while_string_size)
 		{
-			env->curchar = env->while_string[env->nextp++];
-			env->nextchar = env->while_string[env->nextp];
+			env->curchar = tab_get(&env->while_string, env->nextp++);
+			env->nextchar = tab_get(&env->while_string, env->nextp);
 		}
 		else if (env->nextch_type == TEXTTYPE && env->nextp < env->macro_tab_size)
 		{
-			env->curchar = env->macro_tab[env->nextp++];
-			env->nextchar = env->macro_tab[env->nextp];
+			env->curchar = tab_get(&env->macro_tab, env->nextp++);
+			env->nextchar = tab_get(&env->macro_tab, env->nextp);
 
 			if (env->curchar == '\n')
 			{
@@ -293,8 +820,8 @@ void m_nextch(environment *const env)
 		}
 		else if (env->nextch_type == FTYPE)
 		{
-			env->curchar = env->change[env->nextp++];
-			env->nextchar = env->change[env->nextp];
+			env->curchar = tab_get(&env->change, env->nextp++);
+			env->nextchar = tab_get(&env->change, env->nextp);
 
 			if (env->curchar == END_PARAMETER)
 			{
@@ -314,7 +841,10 @@ void m_nextch(environment *const env)
 
 		if (env->curchar != '\n' && env->curchar != EOF)
 		{
-			env->position += utf8_to_string(&env->error_string[env->position], env->curchar);
+			if (!env_reserve_error_string(env, MAX_CHAR_SIZE))
+			{
+				env->position += utf8_to_string(&env->error_string[env->position], env->curchar);
+			}
 		}
 		else
 		{
@@ -331,7 +861,11 @@ void env_error(environment *const env, const int num)
 {
 	const size_t position = env_skip_str(env);
 
-	if (!env->disable_recovery || !env->was_error)
+	if (env->is_quiet)
+	{
+		env->was_error = 1;
+	}
+	else if (!env->disable_recovery || !env->was_error)
 	{
 		macro_error(num, lk_get_current(env->lk), env->error_string, env->line, position);
 		env->was_error = 1;
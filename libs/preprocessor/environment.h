@@ -16,45 +16,108 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "commenter.h"
 #include "constants.h"
+#include "hash.h"
 #include "uniio.h"
 #include "linker.h"
+#include "vector.h"
 
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Record of names table */
+typedef struct name_record
+{
+	size_t repr;			/**< Index of name in reprtab, @c 0 for free record */
+	uint32_t hash;			/**< Hash of name */
+} name_record;
+
+/** Part of compiled loop body */
+typedef struct while_op
+{
+	bool is_ident;			/**< Set if part is identifier, otherwise it is plain text */
+	size_t begin;			/**< Begin of part in while_string */
+	size_t end;				/**< End of part in while_string */
+	size_t text;			/**< Begin of part in while_text */
+	size_t text_size;		/**< Size of part in while_text */
+	int repr;				/**< Macro name of identifier, @c 0 if it is not found */
+	size_t names_size;		/**< Size of names table on the last search, @c SIZE_MAX if there was none */
+} while_op;
+
+/** Compiled loop */
+typedef struct while_loop
+{
+	size_t first;			/**< First character of body in while_string */
+	size_t ops;				/**< First part of body in while_ops */
+	size_t ops_size;		/**< Number of parts of body */
+	size_t condition;		/**< Condition in while_conditions, @c SIZE_MAX if it is not compiled */
+} while_loop;
+
+/** Preprocessor table of characters and indices */
+typedef struct table
+{
+	int *values;			/**< Values */
+	size_t size;			/**< Number of written values */
+	size_t alloc;			/**< Allocated size */
+	bool is_lost;			/**< Set, if some value is not written */
+} table;
+
 typedef struct environment
 {
-	int hashtab[256];
-	int reprtab[MAXTAB];
+	name_record *names;
+	size_t names_size;
+	size_t names_alloc;
+
+	table reprtab;
 	int rp;
 
-	int macro_tab[MAXTAB];
+	table macro_tab;
 	size_t macro_tab_size;
 
-	char error_string[STRING_SIZE];
+	char *error_string;
+	size_t error_string_alloc;
 	size_t position;
 
-	int mstring[STRING_SIZE];
+	table mstring;
 	size_t msp;
 
-	int change[STRING_SIZE * 3];
+	table change;
 	size_t change_size;
 
-	int localstack[STRING_SIZE];
+	table localstack;
 	size_t local_stack_size;
 
-	int calc_string[STRING_SIZE];
+	table calc_string;
 	size_t calc_string_size;
+	vector calc_tree;
 
-	int if_string[STRING_SIZE * 2];
+	table if_string;
 	size_t if_string_size;
 
-	int while_string[STRING_SIZE * 5];
+	table while_string;
 	size_t while_string_size;
 
+	while_loop *while_loops;
+	size_t while_loops_size;
+	size_t while_loops_alloc;
+	hash while_index;
+
+	while_op *while_ops;
+	size_t while_ops_size;
+	size_t while_ops_alloc;
+
+	vector while_conditions;
+	char *while_text;
+	size_t while_text_size;
+	size_t while_text_alloc;
+
 	int mfirstrp;
 
 	int prep_flag;
@@ -65,14 +128,13 @@ typedef struct environment
 
 	size_t nextp;
 
-	int oldcurchar[DEPTH];
-	int oldnextchar[DEPTH];
-	int oldnextch_type[DEPTH];
-	int oldnextp[DEPTH];
+	table oldcurchar;
+	table oldnextchar;
+	table oldnextch_type;
+	table oldnextp;
 	size_t depth;
 
 	int nested_if;
-	int flagint;
 
 	size_t line;
 
@@ -80,16 +142,164 @@ typedef struct environment
 
 	universal_io *output;
 	universal_io *input;
+	comment_map *comments;
+
+	hash *lookups;
+	int is_quiet;
 
 	int disable_recovery;
 	int was_error;
 } environment;
 
+/**
+ *	Create preprocessor table
+ *
+ *	@param	alloc	Initializer of allocated size
+ *
+ *	@return	Table
+ */
+static inline table tab_create(const size_t alloc)
+{
+	table tab;
+	tab.values = malloc(alloc * sizeof(int));
+	tab.size = 0;
+	tab.alloc = tab.values != NULL ? alloc : 0;
+	tab.is_lost = false;
+	return tab;
+}
+
+/**
+ *	Get value from preprocessor table
+ *	@note	Values after the last written one are zeros
+ *
+ *	@param	tab		Table
+ *	@param	index	Index of value
+ *
+ *	@return	Value
+ */
+static inline int tab_get(const table *const tab, const size_t index)
+{
+	return index < tab->size ? tab->values[index] : 0;
+}
+
+/**
+ *	Set value in preprocessor table, table grows on demand
+ *	@note	Value is lost, if table can not grow, it is checked by @c env_is_lost
+ *
+ *	@param	tab		Table
+ *	@param	index	Index of value
+ *	@param	value	Value
+ */
+static inline void tab_set(table *const tab, const size_t index, const int value)
+{
+	if (index >= tab->alloc)
+	{
+		size_t alloc = tab->alloc != 0 ? 2 * tab->alloc : 1;
+		while (index >= alloc)
+		{
+			alloc *= 2;
+		}
+
+		int *const values = realloc(tab->values, alloc * sizeof(int));
+		if (values == NULL)
+		{
+			tab->is_lost = true;
+			return;
+		}
+
+		tab->values = values;
+		tab->alloc = alloc;
+	}
+
+	if (index >= tab->size)
+	{
+		memset(&tab->values[tab->size], 0, (index - tab->size) * sizeof(int));
+		tab->size = index + 1;
+	}
+	tab->values[index] = value;
+}
+
+/**
+ *	Free preprocessor table
+ *
+ *	@param	tab		Table
+ */
+static inline void tab_clear(table *const tab)
+{
+	free(tab->values);
+	tab->values = NULL;
+	tab->size = 0;
+	tab->alloc = 0;
+}
+
 void env_init(environment *const env, linker *const lk, universal_io *const output);
+
+/**
+ *	Free preprocessor tables
+ *
+ *	@param	env	Preprocessor environment
+ */
+void env_clear(environment *const env);
+
+/**
+ *	Find name in names table
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	tab		Table with name
+ *	@param	begin	Index of first character of name in table
+ *	@param	size	Number of characters in name
+ *
+ *	@return	Index of name in reprtab, @c 0 if name is not found
+ */
+size_t env_get_name(const environment *const env, const table *const tab, const size_t begin, const size_t size);
+
+/**
+ *	Get key of name, which is added to lookups set of environment on each search of name
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	repr	Index of record in reprtab
+ *
+ *	@return	Key of name
+ */
+item_t env_get_name_key(const environment *const env, const size_t repr);
+
+/**
+ *	Add name from reprtab to names table
+ *	@note	Record in reprtab consists of name size, name value, characters and zero
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	repr	Index of record in reprtab
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+int env_add_name(environment *const env, const size_t repr);
+
+/**
+ *	Check that some value of preprocessor tables is lost due to lack of memory
+ *
+ *	@param	env		Preprocessor environment
+ *
+ *	@return	@c 1 on true, @c 0 on false
+ */
+bool env_is_lost(const environment *const env);
+
+/**
+ *	Find defined macro in names table
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	tab		Table with name
+ *	@param	begin	Index of first character of name in table
+ *	@param	size	Number of characters in name
+ *
+ *	@return	Index of macro name in reprtab, @c 0 if name is not a defined macro
+ */
+size_t env_get_macro(const environment *const env, const table *const tab, const size_t begin, const size_t size);
+
 void env_clear_error_string(environment *const env);
 
 /**
  *	Add a comment to indicate line changes in the output
+ *	@note	Comment is added to comment map instead of output, if environment has it
  *
  *	@param	env	Preprocessor environment
  */
@@ -102,6 +312,35 @@ int get_depth(environment *const env);
 int get_next_char(environment *const env);
 
 void m_fprintf(environment *const env, int a);
+
+/**
+ *	Print current character and copy following plain text from input file to output in bulk
+ *	@note	Plain text contains no directives, strings, comments, line breaks and macro identifiers.
+ *			The last character of copied text becomes current one.
+ *
+ *	@param	env	Preprocessor environment
+ */
+void m_fprintf_text(environment *const env);
+
+/**
+ *	Print identifier from input file in bulk, if it is not a macro
+ *	@note	Identifier is left for collect_mident, if it is not loaded entirely or it is not followed
+ *			by plain text character. Otherwise the character after identifier becomes current one.
+ *
+ *	@param	env	Preprocessor environment
+ *
+ *	@return	@c 1 if identifier is printed, @c 0 otherwise
+ */
+bool m_fprintf_ident(environment *const env);
+
+/**
+ *	Skip input file up to the next directive without output
+ *	@note	Comments and carriage returns are skipped by characters, lines are counted.
+ *			The last character of skipped text becomes current one.
+ *
+ *	@param	env	Preprocessor environment
+ */
+void m_skip_text(environment *const env);
 void m_nextch(environment *const env);
 
 void env_error(environment *const env, const int num);
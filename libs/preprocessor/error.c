@@ -133,6 +133,9 @@ void get_message_error(const int num, char *const msg)
 		case no_string_ending: // need_test
 			sprintf(msg, "строка не завершена, пропущен символ \" или \'");
 			break;
+		case tables_not_allocated:
+			sprintf(msg, "недостаточно памяти для таблиц препроцессора");
+			break;
 		default:
 			sprintf(msg, "не реализованная ошибка №%d", num);
 			break;
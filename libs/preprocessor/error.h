@@ -60,6 +60,7 @@ enum ERROR
 	include_file_not_found,
 	source_file_not_found,
 	no_string_ending, 
+	tables_not_allocated,
 };
 
 
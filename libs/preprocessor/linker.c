@@ -15,6 +15,7 @@
  */
 
 #include "linker.h"
+#include "cache.h"
 #include "constants.h"
 #include "environment.h"
 #include "error.h"
@@ -25,6 +26,24 @@
 #include <string.h>
 
 
+static inline void lk_system_error(const environment *const env, const char *const tag, const int num)
+{
+	if (!env->is_quiet)
+	{
+		macro_system_error(tag, num);
+	}
+}
+
+/** Hash contents of opened file, so that cache entry matches the read text */
+static inline void lk_hash_input(linker *const lk, universal_io *const io, const size_t index)
+{
+	if (lk->has_hashes)
+	{
+		lk->has_hashes = !cache_hash_input(io, &lk->hashes[index], &lk->sizes[index]);
+	}
+}
+
+
 linker lk_create(workspace *const ws)
 {
 	linker lk;
@@ -38,9 +57,16 @@ linker lk_create(workspace *const ws)
 		lk.included[i] = 0;
 	}
 
+	lk.paths = map_create(MAX_PATHS);
+	lk.has_hashes = false;
 	return lk;
 }
 
+int lk_clear(linker *const lk)
+{
+	return lk == NULL ? -1 : map_clear(&lk->paths);
+}
+
 void lk_make_path(char *const output, const char *const source, const char *const header, const int is_slash)
 {
 	size_t index = 0;
@@ -64,8 +90,30 @@ void lk_make_path(char *const output, const char *const source, const char *cons
 
 size_t lk_open_include(environment *const env, const char* const path)
 {
+	char key[MAX_ARG_SIZE];
+	lk_make_path(key, lk_get_current(env->lk), path, 1);
+
+	// Повторное подключение не требует поиска и открытия файла
+	const item_t cached = map_get(&env->lk->paths, key);
+	if (cached != ITEM_MAX)
+	{
+		if (env->lk->included[cached])
+		{
+			return SIZE_MAX;
+		}
+
+		if (in_set_file(env->input, ws_get_file(env->lk->ws, (size_t)cached)))
+		{
+			lk_system_error(env, ws_get_file(env->lk->ws, (size_t)cached), include_file_not_found);
+			return SIZE_MAX - 1;
+		}
+
+		lk_hash_input(env->lk, env->input, (size_t)cached);
+		return (size_t)cached;
+	}
+
 	char full_path[MAX_ARG_SIZE];
-	lk_make_path(full_path, lk_get_current(env->lk), path, 1);
+	strcpy(full_path, key);
 
 	if (in_set_file(env->input, full_path))
 	{
@@ -83,11 +131,16 @@ size_t lk_open_include(environment *const env, const char* const path)
 	if (!in_is_correct(env->input))
 	{
 		in_clear(env->input);
-		macro_system_error(full_path, include_file_not_found);
+		lk_system_error(env, full_path, include_file_not_found);
 		return SIZE_MAX - 1;
 	}
 
 	const size_t index = ws_add_file(env->lk->ws, full_path);
+	if (index != SIZE_MAX)
+	{
+		map_add(&env->lk->paths, key, (item_t)index);
+	}
+
 	if (index == env->lk->count)
 	{
 		env->lk->included[env->lk->count++] = 0;
@@ -98,6 +151,7 @@ size_t lk_open_include(environment *const env, const char* const path)
 		return SIZE_MAX;
 	}
 
+	lk_hash_input(env->lk, env->input, index);
 	return index;
 }
 
@@ -105,10 +159,11 @@ int lk_open_source(environment *const env, const size_t index)
 {
 	if (in_set_file(env->input, ws_get_file(env->lk->ws, index)))
 	{
-		macro_system_error(lk_get_current(env->lk), source_file_not_found);
+		lk_system_error(env, lk_get_current(env->lk), source_file_not_found);
 		return -1;
 	}
 
+	lk_hash_input(env->lk, env->input, index);
 	return 0;
 }
 
@@ -221,6 +276,20 @@ int lk_include(environment *const env)
 	return res;
 }
 
+int lk_preprocess_source(environment *const env, const size_t index)
+{
+	universal_io input = io_create();
+	env->input = &input;
+
+	if (lk_open_source(env, index) || lk_preprocess_file(env, index))
+	{
+		return -1;
+	}
+
+	in_clear(&input);
+	return 0;
+}
+
 int lk_preprocess_all(environment *const env)
 {
 	if (env == NULL)
@@ -235,14 +304,17 @@ int lk_preprocess_all(environment *const env)
 			continue;
 		}
 
-		universal_io input = io_create();
-		env->input = &input;
+		if (lk_preprocess_source(env, i))
+		{
+			return -1;
+		}
 
-		if (lk_open_source(env, i) || lk_preprocess_file(env, i))
+		// Потерянные значения таблиц искажают текст, поэтому препроцессинг прекращается
+		if (env_is_lost(env))
 		{
+			lk_system_error(env, ws_get_file(env->lk->ws, i), tables_not_allocated);
 			return -1;
 		}
-		in_clear(&input);
 	}
 
 	if (env->was_error)
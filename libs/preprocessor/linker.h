@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+#include "map.h"
 #include "workspace.h"
 
 
@@ -33,6 +36,12 @@ typedef struct linker
 	int included[MAX_PATHS];	/**< List of already added files */
 	size_t count; 				/**< Number of added files */
 
+	map paths;					/**< Indexes of included files by includer directory and header name */
+
+	uint64_t hashes[MAX_PATHS];	/**< Contents hashes of opened files */
+	uint64_t sizes[MAX_PATHS];	/**< Contents sizes of opened files */
+	bool has_hashes;			/**< Set, if contents of opened files are hashed */
+
 	size_t current; 			/**< Index of the current file */
 } linker;
 
@@ -46,6 +55,15 @@ typedef struct linker
  */
 linker lk_create(workspace *const ws);
 
+/**
+ *	Free allocated memory
+ *
+ *	@param	lk		Linker structure
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+int lk_clear(linker *const lk);
+
 /**
  *	Preprocess all files from workspace
  *
@@ -55,6 +73,16 @@ linker lk_create(workspace *const ws);
  */
 int lk_preprocess_all(environment *const env);
 
+/**
+ *	Preprocess top-level file from workspace
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	index	Index of file in workspace
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+int lk_preprocess_source(environment *const env, const size_t index);
+
 /**
  *	Include current file from environment to target output
  *
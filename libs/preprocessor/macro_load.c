@@ -41,37 +41,37 @@ int function_scope_collect(environment *const env, const size_t num, const size_
 					return -1;
 				}
 
-				int loc_change[STRING_SIZE];
-				size_t loc_change_size = 0;
+				vector loc_change = vector_create(STRING_SIZE);
 				const int loc_depth = env->nextch_type == FTYPE
 				? get_depth(env) - 1
 				: get_depth(env);
 
 				while (get_depth(env) >= loc_depth) // 1 переход потому что есть префиксная замена
 				{
-					loc_change[loc_change_size++] = env->curchar;
+					vector_add(&loc_change, env->curchar);
 					m_nextch(env);
 				}
 
 				env->local_stack_size = old_local_stack_size;
 				env->change_size = old_change_size;
 
-				for (size_t i = 0; i < loc_change_size; i++)
+				for (size_t i = 0; i < vector_size(&loc_change); i++)
 				{
-					env->change[env->change_size++] = loc_change[i];
+					tab_set(&env->change, env->change_size++, (int)vector_get(&loc_change, i));
 				}
+				vector_clear(&loc_change);
 			}
 			else
 			{
 				for (size_t i = 0; i < env->msp; i++)
 				{
-					env->change[env->change_size++] = env->mstring[i];
+					tab_set(&env->change, env->change_size++, tab_get(&env->mstring, i));
 				}
 			}
 		}
 		else if (env->curchar == '(')
 		{
-			env->change[env->change_size++] = env->curchar;
+			tab_set(&env->change, env->change_size++, env->curchar);
 			m_nextch(env);
 
 			if (function_scope_collect(env, num, 0))
@@ -83,7 +83,7 @@ int function_scope_collect(environment *const env, const size_t num, const size_
 		{
 			if (was_bracket == 0)
 			{
-				env->change[env->change_size++] = env->curchar;
+				tab_set(&env->change, env->change_size++, env->curchar);
 				m_nextch(env);
 			}
 
@@ -99,20 +99,20 @@ int function_scope_collect(environment *const env, const size_t num, const size_
 				}
 				for (size_t i = 0; i < env->calc_string_size; i++)
 				{
-					env->change[env->change_size++] = env->calc_string[i];
+					tab_set(&env->change, env->change_size++, tab_get(&env->calc_string, i));
 				}
 			}
 			else
 			{
-				for (size_t i = 0; i < (size_t)env->reprtab[env->rp]; i++)
+				for (size_t i = 0; i < (size_t)tab_get(&env->reprtab, env->rp); i++)
 				{
-					env->change[env->change_size++] = env->reprtab[env->rp + 2 + i];
+					tab_set(&env->change, env->change_size++, tab_get(&env->reprtab, env->rp + 2 + i));
 				}
 			}
 		}
 		else
 		{
-			env->change[env->change_size++] = env->curchar;
+			tab_set(&env->change, env->change_size++, env->curchar);
 			m_nextch(env);
 		}
 	}
@@ -132,7 +132,7 @@ int function_stack_create(environment *const env, const size_t parameters)
 	}
 
 	size_t num = 0;
-	env->localstack[num + env->local_stack_size] = (int)env->change_size;
+	tab_set(&env->localstack, num + env->local_stack_size, (int)env->change_size);
 
 	while (env->curchar != ')')
 	{
@@ -140,12 +140,12 @@ int function_stack_create(environment *const env, const size_t parameters)
 		{
 			return -1;
 		}
-		env->change[env->change_size++] = END_PARAMETER;
+		tab_set(&env->change, env->change_size++, END_PARAMETER);
 
 		if (env->curchar == ',')
 		{
 			num++;
-			env->localstack[num + env->local_stack_size] = (int)env->change_size;
+			tab_set(&env->localstack, num + env->local_stack_size, (int)env->change_size);
 
 			if (num > parameters)
 			{
@@ -168,7 +168,7 @@ int function_stack_create(environment *const env, const size_t parameters)
 			}
 			m_nextch(env);
 
-			env->change_size = env->localstack[env->local_stack_size];
+			env->change_size = tab_get(&env->localstack, env->local_stack_size);
 			return 0;
 		}
 	}
@@ -187,10 +187,10 @@ int macro_get(environment *const env, const size_t index)
 
 	env->msp = 0;
 
-	int loc_macro_ptr = env->reprtab[index + 1];
-	if (env->macro_tab[loc_macro_ptr++] == MACROFUNCTION)
+	int loc_macro_ptr = tab_get(&env->reprtab, index + 1);
+	if (tab_get(&env->macro_tab, loc_macro_ptr++) == MACROFUNCTION)
 	{
-		if (env->macro_tab[loc_macro_ptr] > -1 && function_stack_create(env, env->macro_tab[loc_macro_ptr]))
+		if (tab_get(&env->macro_tab, loc_macro_ptr) > -1 && function_stack_create(env, tab_get(&env->macro_tab, loc_macro_ptr)))
 		{
 			return -1;
 		}
@@ -30,17 +30,17 @@ size_t m_equal(environment *const env)
 	for (size_t i = 0; i < env->calc_string_size; i++)
 	{
 		size_t j = 0;
-		while (env->calc_string[i + j] == env->mstring[j])
+		while (tab_get(&env->calc_string, i + j) == tab_get(&env->mstring, j))
 		{
 			j++;
-			if (env->calc_string[i + j] == '\0' && env->mstring[j] == MACROEND)
+			if (tab_get(&env->calc_string, i + j) == '\0' && tab_get(&env->mstring, j) == MACROEND)
 			{
 				return n;
 			}
 		}
 
 		i += j;
-		while (env->calc_string[i] != '\0')
+		while (tab_get(&env->calc_string, i) != '\0')
 		{
 			i++;
 		}
@@ -58,8 +58,8 @@ int func_check_macro(environment *const env, int flag_macro_directive)
 	const int num = (int)m_equal(env);
 	if (num != 0)
 	{
-		env->macro_tab[env->macro_tab_size++] = MACROCANGE;
-		env->macro_tab[env->macro_tab_size++] = num - 1;
+		tab_set(&env->macro_tab, env->macro_tab_size++, MACROCANGE);
+		tab_set(&env->macro_tab, env->macro_tab_size++, num - 1);
 	}
 	else if (!flag_macro_directive && macro_ptr)
 	{
@@ -72,7 +72,7 @@ int func_check_macro(environment *const env, int flag_macro_directive)
 	{
 		for (size_t i = 0; i < env->msp; i++)
 		{
-			env->macro_tab[env->macro_tab_size++] = env->mstring[i];
+			tab_set(&env->macro_tab, env->macro_tab_size++, tab_get(&env->mstring, i));
 		}
 	}
 
@@ -92,10 +92,10 @@ int func_add_ident(environment *const env)
 		{
 			while (utf8_is_letter(env->curchar) || utf8_is_digit(env->curchar))
 			{
-				env->calc_string[env->calc_string_size++] = env->curchar;
+				tab_set(&env->calc_string, env->calc_string_size++, env->curchar);
 				m_nextch(env);
 			}
-			env->calc_string[env->calc_string_size++] = '\0';
+			tab_set(&env->calc_string, env->calc_string_size++, '\0');
 		}
 		else
 		{
@@ -125,12 +125,12 @@ int macro_tab_add_func(environment *const env)
 {
 	const int flag_macro_directive = env->cur == SH_MACRO;
 
-	env->macro_tab[env->macro_tab_size++] = MACROFUNCTION;
+	tab_set(&env->macro_tab, env->macro_tab_size++, MACROFUNCTION);
 	
 	int empty = 0;
 	if (env->curchar == ')')
 	{
-		env->macro_tab[env->macro_tab_size++] = -1;
+		tab_set(&env->macro_tab, env->macro_tab_size++, -1);
 		empty = 1;
 		m_nextch(env);
 	}
@@ -141,7 +141,7 @@ int macro_tab_add_func(environment *const env)
 		{
 			return -1;
 		}
-		env->macro_tab[env->macro_tab_size++] = res;
+		tab_set(&env->macro_tab, env->macro_tab_size++, res);
 	}
 	skip_separators(env);
 
@@ -166,27 +166,27 @@ int macro_tab_add_func(environment *const env)
 				}
 				for (size_t i = 0; i < env->calc_string_size; i++)
 				{
-					env->macro_tab[env->macro_tab_size++] = env->calc_string[i];
+					tab_set(&env->macro_tab, env->macro_tab_size++, tab_get(&env->calc_string, i));
 				}
 			}
 			else if (flag_macro_directive && env->cur == SH_ENDM)
 			{
 				m_nextch(env);
-				env->macro_tab[env->macro_tab_size++] = MACROEND;
+				tab_set(&env->macro_tab, env->macro_tab_size++, MACROEND);
 				return 0;
 			}
 			else
 			{
 				env->cur = 0;
-				for (size_t i = 0; i < (size_t)env->reprtab[env->rp]; i++)
+				for (size_t i = 0; i < (size_t)tab_get(&env->reprtab, env->rp); i++)
 				{
-					env->macro_tab[env->macro_tab_size++] = env->reprtab[env->rp + 2 + i];
+					tab_set(&env->macro_tab, env->macro_tab_size++, tab_get(&env->reprtab, env->rp + 2 + i));
 				}
 			}
 		}
 		else
 		{
-			env->macro_tab[env->macro_tab_size++] = env->curchar;
+			tab_set(&env->macro_tab, env->macro_tab_size++, env->curchar);
 			m_nextch(env);
 		}
 
@@ -209,7 +209,7 @@ int macro_tab_add_func(environment *const env)
 		}
 	}
 
-	env->macro_tab[env->macro_tab_size++] = MACROEND;
+	tab_set(&env->macro_tab, env->macro_tab_size++, MACROEND);
 	return 0;
 }
 
@@ -223,49 +223,43 @@ int define_add_to_reprtab(environment *const env)
 
 	
 	int oldrepr = env->rp;
-	int hash = 0;
+	int size = 0;
 	env->rp += 2;
 
 	do
 	{
-		hash += env->curchar;
-		env->reprtab[env->rp++] = env->curchar;
+		tab_set(&env->reprtab, env->rp++, env->curchar);
+		size++;
 		m_nextch(env);
 	} while (utf8_is_letter(env->curchar) || utf8_is_digit(env->curchar));
 
-	hash &= 255;
-	env->reprtab[env->rp++] = 0;
-	int r = env->hashtab[hash];
+	tab_set(&env->reprtab, env->rp++, 0);
+	const int r = (int)env_get_name(env, &env->reprtab, (size_t)oldrepr + 2, (size_t)size);
 
-	while (r)
+	if (r)
 	{
-		if (equal_reprtab(r, oldrepr, env))
+		if (tab_get(&env->macro_tab, tab_get(&env->reprtab, r + 1)) == MACROUNDEF)
 		{
-			if (env->macro_tab[env->reprtab[r + 1]] == MACROUNDEF)
-			{
-				env->rp = oldrepr;
-				return r;
-			}
-			else
-			{
-				env_error(env, repeat_ident);
-				return -1;
-			}
+			env->rp = oldrepr;
+			return r;
+		}
+		else
+		{
+			env_error(env, repeat_ident);
+			return -1;
 		}
-		r = env->reprtab[r];
 	}
 
-	env->reprtab[oldrepr] = env->hashtab[hash];
-	env->reprtab[oldrepr + 1] = (int)env->macro_tab_size;
-	env->hashtab[hash] = oldrepr;
-	return 0;
+	tab_set(&env->reprtab, oldrepr, size);
+	tab_set(&env->reprtab, oldrepr + 1, (int)env->macro_tab_size);
+	return env_add_name(env, (size_t)oldrepr);
 }
 
 int macro_tab_add_define(environment *const env, const int rep_ptr)
 {
 	int old_macro_tab_size = (int)env->macro_tab_size;
 
-	env->macro_tab[env->macro_tab_size++] = MACRODEF;
+	tab_set(&env->macro_tab, env->macro_tab_size++, MACRODEF);
 	if (env->curchar != '\n')
 	{
 		while (env->curchar != '\n')
@@ -293,14 +287,14 @@ int macro_tab_add_define(environment *const env, const int rep_ptr)
 
 					for (size_t i = 0; i < env->calc_string_size; i++)
 					{
-						env->macro_tab[env->macro_tab_size++] = env->calc_string[i];
+						tab_set(&env->macro_tab, env->macro_tab_size++, tab_get(&env->calc_string, i));
 					}
 				}
 				else
 				{
-					for (size_t i = 0; i < (size_t)env->reprtab[env->rp]; i++)
+					for (size_t i = 0; i < (size_t)tab_get(&env->reprtab, env->rp); i++)
 					{
-						env->macro_tab[env->macro_tab_size++] = env->reprtab[env->rp + 2 + i];
+						tab_set(&env->macro_tab, env->macro_tab_size++, tab_get(&env->reprtab, env->rp + 2 + i));
 					}
 				}
 			}
@@ -325,33 +319,33 @@ int macro_tab_add_define(environment *const env, const int rep_ptr)
 				{
 					for (size_t i = 0; i < env->msp; i++)
 					{
-						env->macro_tab[env->macro_tab_size++] = env->mstring[i];
+						tab_set(&env->macro_tab, env->macro_tab_size++, tab_get(&env->mstring, i));
 					}
 				}
 			}
 			else
 			{
-				env->macro_tab[env->macro_tab_size++] = env->curchar;
+				tab_set(&env->macro_tab, env->macro_tab_size++, env->curchar);
 				m_nextch(env);
 			}
 		}
 
-		while (env->macro_tab[env->macro_tab_size - 1] == ' ' || env->macro_tab[env->macro_tab_size - 1] == '\t')
+		while (tab_get(&env->macro_tab, env->macro_tab_size - 1) == ' ' || tab_get(&env->macro_tab, env->macro_tab_size - 1) == '\t')
 		{
-			env->macro_tab[env->macro_tab_size - 1] = MACROEND;
+			tab_set(&env->macro_tab, env->macro_tab_size - 1, MACROEND);
 			env->macro_tab_size--;
 		}
 	}
 	else
 	{
-		env->macro_tab[env->macro_tab_size++] = '0';
+		tab_set(&env->macro_tab, env->macro_tab_size++, '0');
 	}
 
-	env->macro_tab[env->macro_tab_size++] = MACROEND;
+	tab_set(&env->macro_tab, env->macro_tab_size++, MACROEND);
 
 	if (rep_ptr)
 	{
-		env->reprtab[rep_ptr + 1] = old_macro_tab_size;
+		tab_set(&env->reprtab, rep_ptr + 1, old_macro_tab_size);
 	}
 	return 0;
 }
@@ -394,7 +388,7 @@ int macro_set(environment *const env)
 	}
 
 	const int macro_ptr = collect_mident(env);	
-	if (env->macro_tab[env->reprtab[macro_ptr + 1]] == MACROFUNCTION)
+	if (tab_get(&env->macro_tab, tab_get(&env->reprtab, macro_ptr + 1)) == MACROFUNCTION)
 	{
 		env_error(env, functions_cannot_be_changed);
 		return -1;
@@ -23,6 +23,330 @@
 #include "linker.h"
 #include "macro_save.h"
 #include "utils.h"
+#include <stdlib.h>
+
+
+#define MAX_CHAR_SIZE	4
+
+
+int while_implementation(environment *const env);
+
+
+/** Check that character of loop body is printed without changes */
+static inline bool is_while_text(const int character)
+{
+	return character > 0 && character != '#' && character != '\'' && character != '\"' && character != '@'
+		&& !utf8_is_letter(character);
+}
+
+/** Add characters of loop body to loop text in UTF-8 */
+static int while_add_text(environment *const env, const size_t begin, const size_t end)
+{
+	if (env->while_text_size + (end - begin) * MAX_CHAR_SIZE + 1 > env->while_text_alloc)
+	{
+		size_t alloc = env->while_text_alloc * 2;
+		while (env->while_text_size + (end - begin) * MAX_CHAR_SIZE + 1 > alloc)
+		{
+			alloc *= 2;
+		}
+
+		char *const text = realloc(env->while_text, alloc * sizeof(char));
+		if (text == NULL)
+		{
+			return -1;
+		}
+
+		env->while_text = text;
+		env->while_text_alloc = alloc;
+	}
+
+	for (size_t i = begin; i < end; i++)
+	{
+		env->while_text_size += utf8_to_string(&env->while_text[env->while_text_size]
+			, (char32_t)tab_get(&env->while_string, i));
+	}
+
+	return 0;
+}
+
+/** Add compiled loop */
+static size_t while_add_loop(environment *const env, const size_t begin, const size_t first)
+{
+	if (env->while_loops_size == env->while_loops_alloc)
+	{
+		while_loop *const loops = realloc(env->while_loops, 2 * env->while_loops_alloc * sizeof(while_loop));
+		if (loops == NULL)
+		{
+			return SIZE_MAX;
+		}
+
+		env->while_loops = loops;
+		env->while_loops_alloc *= 2;
+	}
+
+	const size_t index = hash_add(&env->while_index, (item_t)begin, 1);
+	if (index == SIZE_MAX)
+	{
+		return SIZE_MAX;
+	}
+
+	const size_t loop = env->while_loops_size++;
+	hash_set_by_index(&env->while_index, index, 0, (item_t)loop);
+
+	env->while_loops[loop].first = first;
+	env->while_loops[loop].ops = env->while_ops_size;
+	env->while_loops[loop].ops_size = 0;
+	env->while_loops[loop].condition = SIZE_MAX;
+	return loop;
+}
+
+/** Add part of loop body */
+static int while_add_op(environment *const env, const bool is_ident, const size_t begin, const size_t end)
+{
+	if (env->while_ops_size == env->while_ops_alloc)
+	{
+		while_op *const ops = realloc(env->while_ops, 2 * env->while_ops_alloc * sizeof(while_op));
+		if (ops == NULL)
+		{
+			return -1;
+		}
+
+		env->while_ops = ops;
+		env->while_ops_alloc *= 2;
+	}
+
+	const size_t text = env->while_text_size;
+	if (while_add_text(env, begin, end))
+	{
+		return -1;
+	}
+
+	while_op *const op = &env->while_ops[env->while_ops_size++];
+	op->is_ident = is_ident;
+	op->begin = begin;
+	op->end = end;
+	op->text = text;
+	op->text_size = env->while_text_size - text;
+	op->repr = 0;
+	op->names_size = SIZE_MAX;
+	return 0;
+}
+
+/**
+ *	Compile loop collected by while_collect
+ *	@note	Loop body is split to plain text, identifiers and other characters, which are processed by tokens.
+ *			Nested loops are compiled on their first implementation.
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	begin	Index of loop in while_string
+ *
+ *	@return	Index of compiled loop in while_loops, @c SIZE_MAX on failure
+ */
+static size_t while_compile(environment *const env, const size_t begin)
+{
+	const size_t end = (size_t)tab_get(&env->while_string, begin + 2);
+
+	size_t first = begin + 3;
+	while (first < end - 1
+		&& (tab_get(&env->while_string, first) == ' ' || tab_get(&env->while_string, first) == '\t'))
+	{
+		first++;
+	}
+
+	const size_t loop = while_add_loop(env, begin, first);
+	if (loop == SIZE_MAX)
+	{
+		return SIZE_MAX;
+	}
+
+	for (size_t i = first; i < end - 1;)
+	{
+		const int character = tab_get(&env->while_string, i);
+		size_t next = i + 1;
+		bool is_ident = false;
+
+		if (character == WHILEBEGIN)
+		{
+			const size_t nested_end = (size_t)tab_get(&env->while_string, i + 2);
+			i = nested_end > i ? nested_end : next;
+			continue;
+		}
+		else if (utf8_is_letter(character))
+		{
+			is_ident = true;
+			while (utf8_is_letter(tab_get(&env->while_string, next)) || utf8_is_digit(tab_get(&env->while_string, next)))
+			{
+				next++;
+			}
+		}
+		else if (is_while_text(character))
+		{
+			while (next < end - 1 && is_while_text(tab_get(&env->while_string, next)))
+			{
+				next++;
+			}
+		}
+		else
+		{
+			i = next;
+			continue;
+		}
+
+		if (while_add_op(env, is_ident, i, next))
+		{
+			// Rest of body is processed by tokens
+			break;
+		}
+
+		env->while_loops[loop].ops_size++;
+		i = next;
+	}
+
+	const size_t condition = vector_size(&env->while_conditions);
+	if (!calc_compile(env, (size_t)tab_get(&env->while_string, begin + 1), &env->while_conditions))
+	{
+		env->while_loops[loop].condition = condition;
+	}
+
+	return loop;
+}
+
+/** Get compiled loop, loop is compiled on the first call */
+static size_t while_find(environment *const env, const size_t begin)
+{
+	const item_t loop = hash_get(&env->while_index, (item_t)begin, 0);
+	return loop != ITEM_MAX ? (size_t)loop : while_compile(env, begin);
+}
+
+/**
+ *	Check that identifier of loop body is macro name
+ *	@note	Found name is kept in part, missing name is searched again only after adding new names
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	op		Index of identifier part in while_ops
+ *
+ *	@return	@c true on macro name, @c false otherwise
+ */
+static bool while_is_macro(environment *const env, const size_t op)
+{
+	while_op *const ident = &env->while_ops[op];
+	if (ident->repr == 0 && ident->names_size != env->names_size)
+	{
+		ident->repr = (int)env_get_name(env, &env->while_string, ident->begin, ident->end - ident->begin);
+		ident->names_size = env->names_size;
+	}
+
+	return ident->repr != 0 && ident->repr >= env->mfirstrp
+		&& tab_get(&env->macro_tab, tab_get(&env->reprtab, ident->repr + 1)) != MACROUNDEF;
+}
+
+/**
+ *	Check condition of compiled loop
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	begin	Index of loop in while_string
+ *	@param	loop	Index of compiled loop in while_loops
+ *
+ *	@return	@c 1 on true, @c 0 on false, @c -1 on failure
+ */
+static int while_check(environment *const env, const size_t begin, const size_t loop)
+{
+	const size_t condition = env->while_loops[loop].condition;
+	if (condition != SIZE_MAX)
+	{
+		const int truth = calc_run(env, &env->while_conditions, condition);
+		if (truth != -1)
+		{
+			return truth;
+		}
+	}
+
+	env->nextp = begin;
+	m_nextch(env);
+	m_change_nextch_type(env, IFTYPE, tab_get(&env->while_string, env->nextp));
+	m_nextch(env);
+	if (calculate(env, LOGIC))
+	{
+		return -1;
+	}
+	m_old_nextch_type(env);
+
+	return tab_get(&env->calc_string, 0);
+}
+
+/**
+ *	Implement one iteration of compiled loop body
+ *	@note	Text and identifiers, which are not macro names, are printed in bulk,
+ *			other characters are processed by tokens up to the next compiled part.
+ *
+ *	@param	env		Preprocessor environment
+ *	@param	loop	Index of compiled loop in while_loops
+ *	@param	end		End of loop in while_string
+ *
+ *	@return	@c 0 on success, error code on failure
+ */
+static int while_body(environment *const env, const size_t loop, const size_t end)
+{
+	// Nested loops may reallocate compiled loops and parts, so they are accessed by indices
+	const size_t ops = env->while_loops[loop].ops;
+	const size_t ops_end = ops + env->while_loops[loop].ops_size;
+	const size_t depth = (size_t)get_depth(env);
+
+	size_t op = ops;
+	size_t position = env->while_loops[loop].first;
+	while (position < end - 1)
+	{
+		while (op < ops_end && env->while_ops[op].begin < position)
+		{
+			op++;
+		}
+
+		if (op < ops_end && env->while_ops[op].begin == position
+			&& (!env->while_ops[op].is_ident || env->prep_flag != 1 || !while_is_macro(env, op)))
+		{
+			const while_op *const part = &env->while_ops[op];
+			if (part->text + part->text_size <= env->while_text_size)
+			{
+				out_write(env->output, &env->while_text[part->text], part->text_size);
+			}
+
+			position = part->end;
+			op++;
+			continue;
+		}
+
+		env->nextp = position;
+		m_nextch(env);
+		do
+		{
+			if (env->curchar == WHILEBEGIN)
+			{
+				env->nextp--;
+				if (while_implementation(env))
+				{
+					return -1;
+				}
+			}
+			else if (env->curchar == EOF)
+			{
+				env_error(env, must_end_endw);
+				return -1;
+			}
+			else
+			{
+				const int error = preprocess_token(env);
+				if (error)
+				{
+					return error;
+				}
+			}
+		} while (env->nextch_type != WHILETYPE || (size_t)get_depth(env) > depth);
+
+		position = env->nextp - 1;
+	}
+
+	return 0;
+}
 
 
 int if_check(environment *const env, int type_if)
@@ -35,7 +359,7 @@ int if_check(environment *const env, int type_if)
 		{
 			return -1;
 		}
-		return env->calc_string[0];
+		return tab_get(&env->calc_string, 0);
 	}
 	else
 	{
@@ -91,7 +415,7 @@ int if_end(environment *const env)
 		}
 		else
 		{
-			m_nextch(env);
+			m_skip_text(env);
 		}
 	}
 
@@ -122,7 +446,7 @@ int if_false(environment *const env)
 		}
 		else
 		{
-			m_nextch(env);
+			m_skip_text(env);
 		}
 	}
 
@@ -246,16 +570,16 @@ int while_collect(environment *const env)
 {
 	const int oldwsp = (int)env->while_string_size;
 
-	env->while_string[env->while_string_size++] = WHILEBEGIN;
-	env->while_string[env->while_string_size++] = (int)env->if_string_size;
+	tab_set(&env->while_string, env->while_string_size++, WHILEBEGIN);
+	tab_set(&env->while_string, env->while_string_size++, (int)env->if_string_size);
 	env->while_string_size++;
 
 	while (env->curchar != '\n')
 	{
-		env->if_string[env->if_string_size++] = env->curchar;
+		tab_set(&env->if_string, env->if_string_size++, env->curchar);
 		m_nextch(env);
 	}
-	env->if_string[env->if_string_size++] = '\n';
+	tab_set(&env->if_string, env->if_string_size++, '\n');
 	m_nextch(env);
 
 	while (env->curchar != EOF)
@@ -270,21 +594,21 @@ int while_collect(environment *const env)
 			}
 			else if (env->cur == SH_ENDW)
 			{
-				env->while_string[env->while_string_size++] = ' ';
-				env->while_string[oldwsp + 2] = (int)env->while_string_size;
+				tab_set(&env->while_string, env->while_string_size++, ' ');
+				tab_set(&env->while_string, oldwsp + 2, (int)env->while_string_size);
 				env->cur = 0;
 
 				return 0;
 			}
 			else
 			{
-				for (size_t i = 0; i < (size_t)env->reprtab[env->rp]; i++)
+				for (size_t i = 0; i < (size_t)tab_get(&env->reprtab, env->rp); i++)
 				{
-					env->while_string[env->while_string_size++] = env->reprtab[env->rp + 2 + i];
+					tab_set(&env->while_string, env->while_string_size++, tab_get(&env->reprtab, env->rp + 2 + i));
 				}
 			}
 		}
-		env->while_string[env->while_string_size++] = env->curchar;
+		tab_set(&env->while_string, env->while_string_size++, env->curchar);
 		m_nextch(env);
 	}
 
@@ -294,62 +618,37 @@ int while_collect(environment *const env)
 
 int while_implementation(environment *const env)
 {
-	const int oldernextp = (int)env->nextp;
-	const size_t end = (size_t)env->while_string[oldernextp + 2];
-	int error = 0;
+	const size_t begin = env->nextp;
+	const size_t end = (size_t)tab_get(&env->while_string, begin + 2);
+
+	const size_t loop = while_find(env, begin);
+	if (loop == SIZE_MAX)
+	{
+		return -1;
+	}
 
 	env->cur = 0;
-	while (env->while_string[oldernextp] == WHILEBEGIN)
+	while (true)
 	{
-		m_nextch(env);
-		m_change_nextch_type(env, IFTYPE, env->while_string[env->nextp]);
-		m_nextch(env);
-		if (calculate(env, LOGIC))
+		const int truth = while_check(env, begin, loop);
+		if (truth == -1)
 		{
 			return -1;
 		}
-		m_old_nextch_type(env);
-
 
-		if (env->calc_string[0] == 0)
+		if (!truth)
 		{
 			env->nextp = end;
 			m_nextch(env);
 			return 0;
 		}
 
-		m_nextch(env);
-		m_nextch(env);
-		m_nextch(env);
-		skip_separators(env);
-
-		while (env->nextp != end || env->nextch_type != WHILETYPE)
+		const int error = while_body(env, loop, end);
+		if (error)
 		{
-			if (env->curchar == WHILEBEGIN)
-			{
-				env->nextp--;
-				if (while_implementation(env))
-				{
-					return -1;
-				}
-			}
-			else if (env->curchar == EOF)
-			{
-				env_error(env, must_end_endw);
-				return -1;
-			}
-			else
-			{
-				error = preprocess_token(env);
-				if (error)
-				{
-					return error;
-				}
-			}
+			return error;
 		}
-		env->nextp = oldernextp;
 	}
-	return 0;
 }
 
 
@@ -373,7 +672,7 @@ int preprocess_words(environment *const env)
 			const int macro_ptr = collect_mident(env);;
 			if (macro_ptr)
 			{
-				env->macro_tab[env->reprtab[macro_ptr + 1]] = MACROUNDEF;
+				tab_set(&env->macro_tab, tab_get(&env->reprtab, macro_ptr + 1), MACROUNDEF);
 				return skip_line(env);
 			}
 			else
@@ -415,6 +714,13 @@ int preprocess_words(environment *const env)
 		{
 			env->while_string_size = 0;
 			env->if_string_size = 0;
+			env->while_loops_size = 0;
+			env->while_ops_size = 0;
+			vector_resize(&env->while_conditions, 0);
+			env->while_text_size = 0;
+
+			// Loops of the previous #while are at the same positions
+			hash_reset(&env->while_index);
 			if (while_collect(env))
 			{
 				return -1;
@@ -493,6 +799,12 @@ int preprocess_token(environment *const env)
 		{
 			if (utf8_is_letter(env->curchar) && env->prep_flag == 1)
 			{
+				// Идентификаторы, не являющиеся макросами, выводятся целиком
+				if (m_fprintf_ident(env))
+				{
+					return 0;
+				}
+
 				const int macro_ptr = collect_mident(env);
 				if (macro_ptr)
 				{
@@ -502,14 +814,13 @@ int preprocess_token(environment *const env)
 				{
 					for (size_t i = 0; i < env->msp; i++)
 					{
-						m_fprintf(env, env->mstring[i]);
+						m_fprintf(env, tab_get(&env->mstring, i));
 					}
 				}
 			}
 			else
 			{
-				m_fprintf(env, env->curchar);
-				m_nextch(env);
+				m_fprintf_text(env);
 			}
 
 			return 0;
@@ -15,6 +15,9 @@
  */
 
 #include "preprocessor.h"
+#include <stdlib.h>
+#include <string.h>
+#include "cache.h"
 #include "constants.h"
 #include "environment.h"
 #include "error.h"
@@ -24,6 +27,11 @@
 #include "uniprinter.h"
 #include "utils.h"
 
+#ifndef _WIN32
+	#include <pthread.h>
+	#include <unistd.h>
+#endif
+
 
 const size_t SIZE_OUT_BUFFER = 1024;
 
@@ -32,7 +40,7 @@ void to_reprtab(environment *const env, const char str[], int num)
 {
 	int i = 0;
 	int oldrepr = env->rp;
-	int hash = 0;
+	int size = 0;
 	//unsigned char firstchar;
 	//unsigned char secondchar;
 	//int p;
@@ -56,15 +64,14 @@ void to_reprtab(environment *const env, const char str[], int num)
 		c = utf8_convert(&str[i]);
 		i += (int)utf8_symbol_size(str[i]);
 
-		hash += c;
-		env->reprtab[env->rp++] = c;
+		size++;
+		tab_set(&env->reprtab, env->rp++, c);
 	}
 
-	hash &= 255;
-	env->reprtab[env->rp++] = 0;
-	env->reprtab[oldrepr] = env->hashtab[hash];
-	env->reprtab[oldrepr + 1] = num;
-	env->hashtab[hash] = oldrepr;
+	tab_set(&env->reprtab, env->rp++, 0);
+	tab_set(&env->reprtab, oldrepr, size);
+	tab_set(&env->reprtab, oldrepr + 1, num);
+	env_add_name(env, (size_t)oldrepr);
 }
 
 void to_reprtab_full(environment *const env, const char str1[], const char str2[], const char str3[], const char str4[], int num)
@@ -97,17 +104,307 @@ void add_keywods(environment *const env)
 	to_reprtab_full(env, "#INCLUDE", "#include", "#ДОБАВИТЬ", "#добавить", SH_INCLUDE);
 }
 
-int macro_form_io(workspace *const ws, universal_io *const output)
+#ifndef _WIN32
+/** Top-level file, which is preprocessed on its own thread */
+typedef struct unit
 {
-	linker lk = lk_create(ws);
+	workspace ws;						/**< Copy of workspace */
+	linker lk;							/**< Linker of file */
+
+	universal_io io;					/**< Output of file */
+	comment_map cmts;					/**< Comments of output */
+
+	hash lookups;						/**< Keys of names, which are looked up */
+	vector defined;						/**< Keys of names, which are defined */
+
+	int ret;							/**< Result of preprocessing */
+} unit;
+
+/** Queue of top-level files */
+typedef struct queue
+{
+	unit *units;						/**< Top-level files */
+	size_t size;						/**< Number of files */
+	size_t next;						/**< Index of next file to preprocess */
+
+	bool has_comments;					/**< Set, if comments are kept apart from output */
+	pthread_mutex_t mutex;				/**< Mutex of next index */
+} queue;
+
+
+/** Use parallel preprocessing of top-level files */
+static inline bool is_parallel(const workspace *const ws)
+{
+	for (size_t i = 0; ; i++)
+	{
+		const char *flag = ws_get_flag(ws, i);
+		if (flag == NULL)
+		{
+			return false;
+		}
+		else if (strcmp(flag, "--parallel-macro") == 0)
+		{
+			return true;
+		}
+	}
+}
+
+static int unit_init(unit *const un, const linker *const lk)
+{
+	const workspace *const ws = lk->ws;
+	un->ws = ws_create();
+	for (size_t i = 0; i < ws_get_files_num(ws); i++)
+	{
+		ws_add_file(&un->ws, ws_get_file(ws, i));
+	}
+	for (size_t i = 0; i < ws_get_dirs_num(ws); i++)
+	{
+		ws_add_dir(&un->ws, ws_get_dir(ws, i));
+	}
+	for (size_t i = 0; i < ws_get_flags_num(ws); i++)
+	{
+		ws_add_flag(&un->ws, ws_get_flag(ws, i));
+	}
+
+	un->lk = lk_create(&un->ws);
+	un->lk.has_hashes = lk->has_hashes;
+	un->io = io_create();
+	un->cmts = cmt_map_create();
+
+	un->lookups = hash_create(HASH);
+	un->defined = vector_create(HASH);
+
+	un->ret = -1;
+	return ws_is_correct(&un->ws) ? out_set_buffer(&un->io, SIZE_OUT_BUFFER) : -1;
+}
+
+static void unit_preprocess(unit *const un, const size_t index, const bool has_comments)
+{
+	environment env;
+	env_init(&env, &un->lk, &un->io);
+	env.comments = has_comments ? &un->cmts : NULL;
+
+	// Ошибки выводятся при последовательном препроцессинге
+	env.lookups = &un->lookups;
+	env.is_quiet = 1;
+
+	add_keywods(&env);
+	env.mfirstrp = env.rp;
+
+	// Идентификаторы ищутся среди макросов, чтобы обнаружить макросы предыдущих файлов
+	env.prep_flag = index != 0;
+
+	un->ret = lk_preprocess_source(&env, index) || env.was_error ? -1 : 0;
+
+	for (size_t i = 0; i < env.names_alloc; i++)
+	{
+		if (env.names[i].repr >= (size_t)env.mfirstrp)
+		{
+			vector_add(&un->defined, env_get_name_key(&env, env.names[i].repr));
+		}
+	}
+
+	env_clear(&env);
+}
+
+static void unit_clear(unit *const un)
+{
+	lk_clear(&un->lk);
+	ws_clear(&un->ws);
+	io_erase(&un->io);
+	cmt_map_clear(&un->cmts);
+	hash_clear(&un->lookups);
+	vector_clear(&un->defined);
+}
+
+static void *queue_run(void *const arg)
+{
+	queue *const que = arg;
+
+	while (true)
+	{
+		pthread_mutex_lock(&que->mutex);
+		const size_t index = que->next++;
+		pthread_mutex_unlock(&que->mutex);
+
+		if (index >= que->size)
+		{
+			return NULL;
+		}
+
+		unit_preprocess(&que->units[index], index, que->has_comments);
+	}
+}
+
+/**
+ *	Check that parallel preprocessing is the same as sequential one
+ *	@note	Files differ, if one of them uses macro or header of previous ones or is included by them
+ *
+ *	@param	que		Queue of preprocessed files
+ *
+ *	@return	@c true on success, @c false on failure
+ */
+static bool queue_is_sequential(const queue *const que)
+{
+	map opened = map_create(MAX_PATHS);
+	vector defined = vector_create(HASH);
+	bool is_sequential = true;
+
+	for (size_t i = 0; i < que->size && is_sequential; i++)
+	{
+		const unit *const un = &que->units[i];
+		is_sequential = un->ret == 0;
+
+		for (size_t j = 0; j < vector_size(&defined) && is_sequential; j++)
+		{
+			is_sequential = hash_get_index(&un->lookups, vector_get(&defined, j)) == SIZE_MAX;
+		}
+
+		for (size_t j = 0; j < un->lk.count && is_sequential; j++)
+		{
+			if (un->lk.included[j])
+			{
+				is_sequential = map_add(&opened, ws_get_file(&un->ws, j), 0) != SIZE_MAX;
+			}
+		}
+
+		for (size_t j = 0; j < vector_size(&un->defined); j++)
+		{
+			vector_add(&defined, vector_get(&un->defined, j));
+		}
+	}
+
+	vector_clear(&defined);
+	map_clear(&opened);
+	return is_sequential;
+}
+
+/**
+ *	Preprocess top-level files in parallel
+ *
+ *	@param	lk		Linker
+ *	@param	output	Output
+ *	@param	cmts	Comment map
+ *
+ *	@return	@c 0 on success, @c -1 if parallel preprocessing differs from sequential one,
+ *			@c 1 on failure after output is partly written
+ */
+static int macro_form_parallel(linker *const lk, universal_io *const output, comment_map *const cmts)
+{
+	workspace *const ws = lk->ws;
+	queue que;
+	que.size = ws_get_files_num(ws);
+	que.next = 0;
+	que.has_comments = cmts != NULL;
+
+	que.units = malloc(que.size * sizeof(unit));
+	if (que.units == NULL)
+	{
+		return -1;
+	}
+
+	int ret = 0;
+	for (size_t i = 0; i < que.size; i++)
+	{
+		ret = unit_init(&que.units[i], lk) || ret;
+	}
+
+	// Если число процессоров неизвестно, файлы разбирает один поток
+	const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	const size_t workers = processors > 1 ? (size_t)processors : 1;
+	const size_t size = workers < que.size ? workers : que.size;
+	pthread_t *const threads = malloc(size * sizeof(pthread_t));
+	pthread_mutex_init(&que.mutex, NULL);
+
+	size_t started = 0;
+	while (!ret && threads != NULL && started < size && !pthread_create(&threads[started], NULL, &queue_run, &que))
+	{
+		started++;
+	}
+
+	if (started != 0)
+	{
+		// Если не все потоки созданы, оставшиеся файлы разбирают созданные
+		for (size_t i = 0; i < started; i++)
+		{
+			pthread_join(threads[i], NULL);
+		}
+
+		ret = queue_is_sequential(&que) ? 0 : -1;
+	}
+	else
+	{
+		ret = -1;
+	}
+
+	// После начала записи результат нельзя получить последовательным препроцессингом
+	for (size_t i = 0; i < que.size && !ret; i++)
+	{
+		unit *const un = &que.units[i];
+		const size_t offset = out_get_position(output);
+		const size_t length = out_get_position(&un->io);
+
+		ret = out_write(output, un->io.out_buffer, length) ? 1 : 0;
+		if (!ret && cmts != NULL)
+		{
+			ret = cmt_map_append(cmts, &un->cmts, offset) ? 1 : 0;
+		}
+
+		lk->hashes[i] = un->lk.hashes[i];
+		lk->sizes[i] = un->lk.sizes[i];
+		lk->has_hashes = lk->has_hashes && un->lk.has_hashes;
+
+		// Подключенные файлы добавляются в порядке последовательного препроцессинга
+		for (size_t j = que.size; j < ws_get_files_num(&un->ws) && !ret; j++)
+		{
+			const size_t index = ws_add_file(ws, ws_get_file(&un->ws, j));
+			ret = index == SIZE_MAX ? 1 : 0;
+
+			if (!ret)
+			{
+				lk->hashes[index] = un->lk.hashes[j];
+				lk->sizes[index] = un->lk.sizes[j];
+			}
+		}
+	}
+
+	for (size_t i = 0; i < que.size; i++)
+	{
+		unit_clear(&que.units[i]);
+	}
+
+	pthread_mutex_destroy(&que.mutex);
+	free(threads);
+	free(que.units);
+	return ret;
+}
+#endif
+
+
+int macro_form_io(linker *const lk, universal_io *const output, comment_map *const cmts)
+{
+#ifndef _WIN32
+	if (is_parallel(lk->ws) && ws_get_files_num(lk->ws) > 1)
+	{
+		// Последовательный препроцессинг выполняется, только если вывод не начат
+		const int ret = macro_form_parallel(lk, output, cmts);
+		if (ret != -1)
+		{
+			return ret == 0 ? 0 : -1;
+		}
+	}
+#endif
 
 	environment env;
-	env_init(&env, &lk, output);
+	env_init(&env, lk, output);
+	env.comments = cmts;
 
 	add_keywods(&env);
 	env.mfirstrp = env.rp;
 
-	return lk_preprocess_all(&env);
+	const int ret = lk_preprocess_all(&env);
+	env_clear(&env);
+	return ret;
 }
 
 /*
@@ -120,27 +417,79 @@ int macro_form_io(workspace *const ws, universal_io *const output)
 
 
 char *macro(workspace *const ws)
+{
+	return macro_with_comments(ws, NULL);
+}
+
+char *macro_with_comments(workspace *const ws, comment_map *const cmts)
 {
 	if (!ws_is_correct(ws) || ws_get_files_num(ws) == 0)
 	{
 		return NULL;
 	}
 
+	char path[MAX_ARG_SIZE];
+	const bool is_cached = !cache_get_path(ws, cmts != NULL, path);
+	if (is_cached)
+	{
+		char *const text = cache_read(ws, path, cmts);
+		if (text != NULL)
+		{
+			return text;
+		}
+	}
+
 	universal_io io = io_create();
 	if (out_set_buffer(&io, SIZE_OUT_BUFFER))
 	{
 		return NULL;
 	}
 
-	int ret = macro_form_io(ws, &io);
+	// Содержимое файлов для записи кэша хэшируется при их открытии
+	linker lk = lk_create(ws);
+	lk.has_hashes = is_cached;
+
+	int ret = macro_form_io(&lk, &io, cmts);
 	if (ret)
 	{
+		lk_clear(&lk);
 		io_erase(&io);
 		return NULL;
 	}
 
 	in_clear(&io);
-	return out_extract_buffer(&io);
+	char *const buffer = out_extract_buffer(&io);
+	if (cmts != NULL)
+	{
+		cmt_map_complete(cmts, buffer);
+	}
+
+	if (is_cached)
+	{
+		cache_write(&lk, path, buffer, cmts);
+	}
+
+	lk_clear(&lk);
+	return buffer;
+}
+
+int macro_to_channel(workspace *const ws, channel *const ch, comment_map *const cmts)
+{
+	universal_io io = io_create();
+	if (!ws_is_correct(ws) || ws_get_files_num(ws) == 0 || out_set_channel(&io, ch))
+	{
+		channel_close(ch, false);
+		return -1;
+	}
+
+	// Текст не хранится целиком, поэтому промежуточные комментарии добавляет канал после загрузки текста
+	linker lk = lk_create(ws);
+	const int ret = macro_form_io(&lk, &io, cmts);
+
+	lk_clear(&lk);
+	io_erase(&io);
+	channel_close(ch, ret == 0);
+	return ret;
 }
 
 int macro_to_file(workspace *const ws, const char *const path)
@@ -156,8 +505,10 @@ int macro_to_file(workspace *const ws, const char *const path)
 		return -1;
 	}
 
-	int ret = macro_form_io(ws, &io);
+	linker lk = lk_create(ws);
+	int ret = macro_form_io(&lk, &io, NULL);
 
+	lk_clear(&lk);
 	io_erase(&io);
 	return ret;
 }
@@ -17,6 +17,8 @@
 #pragma once
 
 #include "environment.h"
+#include "channel.h"
+#include "commenter.h"
 #include "dll.h"
 #include "workspace.h"
 
@@ -34,6 +36,28 @@ extern "C" {
  */
 EXPORTED char *macro(workspace *const ws);
 
+/**
+ *	Preprocess files from workspace, line changes are added to comment map instead of output
+ *
+ *	@param	ws		Workspace
+ *	@param	cmts	Comment map
+ *
+ *	@return	Preprocessed string, @c NULL on failure
+ */
+EXPORTED char *macro_with_comments(workspace *const ws, comment_map *const cmts);
+
+/**
+ *	Preprocess files from workspace to channel, which is closed at the end
+ *	@note	Line changes are added to comment map instead of output
+ *
+ *	@param	ws		Workspace
+ *	@param	ch		Output channel
+ *	@param	cmts	Comment map
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int macro_to_channel(workspace *const ws, channel *const ch, comment_map *const cmts);
+
 /**
  *	Preprocess files from workspace
  *
@@ -27,45 +27,23 @@
 #include <string.h>
 
 
-int equal_reprtab(int i, int j, environment *const env)
-{
-	i += 2;
-	j += 2;
-
-	while (env->reprtab[i] == env->reprtab[j])
-	{
-		i++;
-		j++;
-
-		if (env->reprtab[i] == 0 && env->reprtab[j] == 0)
-		{
-			return 1;
-		}
-	}
-
-	return 0;
-}
-
 void output_keywords(environment *const env)
 {
-	for (size_t j = 0; j < (size_t)env->reprtab[env->rp]; j++)
+	for (size_t j = 0; j < (size_t)tab_get(&env->reprtab, env->rp); j++)
 	{
-		m_fprintf(env, env->reprtab[env->rp + 2 + j]);
+		m_fprintf(env, tab_get(&env->reprtab, env->rp + 2 + j));
 	}
 }
 
 int macro_keywords(environment *const env)
 {
 	int oldrepr = env->rp;
-	int r = 0;
 	int n = 0;
 
 	env->rp += 2;
-	int hash = 0;
 	do
 	{
-		hash += env->curchar;
-		env->reprtab[env->rp++] = env->curchar;
+		tab_set(&env->reprtab, env->rp++, env->curchar);
 		n++;
 		m_nextch(env);
 	} while (utf8_is_letter(env->curchar) || utf8_is_digit(env->curchar));
@@ -77,77 +55,26 @@ int macro_keywords(environment *const env)
 		env_error(env, after_ident_must_be_space);
 	}*/
 
-	hash &= 255;
-	env->reprtab[env->rp++] = 0;
-	r = env->hashtab[hash];
-	if (r)
-	{
-		do
-		{
-			if (equal_reprtab(r, oldrepr, env))
-			{
-				env->rp = oldrepr;
-				env->reprtab[env->rp] = n;
-				return (env->reprtab[r + 1] < 0) ? env->reprtab[r + 1] : 0;
-			}
-			else
-			{
-				r = env->reprtab[r];
-			}
-		} while (r);
-	}
+	tab_set(&env->reprtab, env->rp++, 0);
+	const size_t r = env_get_name(env, &env->reprtab, (size_t)oldrepr + 2, (size_t)n);
 
 	env->rp = oldrepr;
-	env->reprtab[env->rp] = n;
-	return 0;
-}
-
-int mf_equal(int i, environment *const env)
-{
-	int j = 0;
-	i += 2;
-
-	while (env->reprtab[i] == env->mstring[j])
-	{
-		i++;
-		j++;
-		if (env->reprtab[i] == 0 && env->mstring[j] == MACROEND)
-		{
-			return 1;
-		}
-	}
-
-	return 0;
+	tab_set(&env->reprtab, env->rp, n);
+	return r && tab_get(&env->reprtab, r + 1) < 0 ? tab_get(&env->reprtab, r + 1) : 0;
 }
 
 int collect_mident(environment *const env)
 {
-	int r;
-	int hash = 0;
 	env->msp = 0;
 
 	while (utf8_is_letter(env->curchar) || utf8_is_digit(env->curchar))
 	{
-		env->mstring[env->msp++] = env->curchar;
-		hash += env->curchar;
+		tab_set(&env->mstring, env->msp++, env->curchar);
 		m_nextch(env);
 	}
 
-	env->mstring[env->msp] = MACROEND;
-	hash &= 255;
-	r = env->hashtab[hash];
-
-	while (r)
-	{
-		if (r >= env->mfirstrp && mf_equal(r, env))
-		{
-			return (env->macro_tab[env->reprtab[r + 1]] != MACROUNDEF) ? r : 0;
-		}
-
-		r = env->reprtab[r];
-	}
-
-	return 0;
+	tab_set(&env->mstring, env->msp, MACROEND);
+	return (int)env_get_macro(env, &env->mstring, 0, env->msp);
 }
 
 int skip_line(environment *const env)
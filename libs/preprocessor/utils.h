@@ -23,7 +23,6 @@
 extern "C" {
 #endif
 
-int equal_reprtab(int i, int j, environment *const env);
 void output_keywords(environment *const env);
 int macro_keywords(environment *const env);
 int collect_mident(environment *const env);
@@ -0,0 +1,490 @@
+/*
+ *	Copyright 2026 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+#include "channel.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+	#include <pthread.h>
+	#include <stdatomic.h>
+	#include <sys/mman.h>
+#endif
+
+
+#define CHUNK_SIZE 65536
+#define CHUNKS_NUM 16
+
+
+#ifndef _WIN32
+/** Writer state of channel */
+enum
+{
+	CHANNEL_OPEN,
+	CHANNEL_FINISHED,
+	CHANNEL_FAILED,
+};
+
+struct channel
+{
+	char *chunks;				/**< Ring of chunks */
+	size_t sizes[CHUNKS_NUM];	/**< Sizes of passed chunks */
+
+	atomic_size_t passed;		/**< Number of chunks passed by writer */
+	atomic_size_t released;		/**< Number of chunks returned to writer by reader */
+	atomic_int state;			/**< Writer state */
+
+	size_t written;				/**< Size of written text */
+	size_t filled;				/**< Size of current chunk of writer */
+
+	size_t received;			/**< Number of chunks seen by reader */
+	size_t size;				/**< Size of received text */
+
+	FILE *file;					/**< Temporary file with released chunks */
+	size_t spilled;				/**< Size of text in temporary file */
+
+	comment_map *cmts;			/**< Comments of text */
+	char *text;					/**< Whole text */
+	bool is_mapped;				/**< Set, if whole text is memory-mapped file */
+	bool is_lost;				/**< Set, if released text is not saved to file */
+
+	pthread_mutex_t mutex;		/**< Mutex of waiting */
+	pthread_cond_t cond;		/**< Condition of passed or released chunk */
+};
+
+
+static inline bool has_free_chunk(const channel *const ch)
+{
+	return atomic_load_explicit(&ch->passed, memory_order_relaxed)
+		- atomic_load_explicit(&ch->released, memory_order_acquire) < CHUNKS_NUM;
+}
+
+static inline bool is_finished(const channel *const ch)
+{
+	return atomic_load_explicit(&ch->state, memory_order_acquire) != CHANNEL_OPEN;
+}
+
+static inline bool can_receive(const channel *const ch)
+{
+	// State is loaded first, because no chunks are passed after finishing
+	const bool was_finished = is_finished(ch);
+	return atomic_load_explicit(&ch->passed, memory_order_acquire) != ch->received || was_finished;
+}
+
+/** Wait until condition is satisfied, mutex is used only for sleeping */
+static void channel_wait_for(channel *const ch, bool (*is_ready)(const channel *const))
+{
+	if (is_ready(ch))
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&ch->mutex);
+	while (!is_ready(ch))
+	{
+		pthread_cond_wait(&ch->cond, &ch->mutex);
+	}
+	pthread_mutex_unlock(&ch->mutex);
+}
+
+static inline void channel_wake(channel *const ch)
+{
+	pthread_mutex_lock(&ch->mutex);
+	pthread_cond_broadcast(&ch->cond);
+	pthread_mutex_unlock(&ch->mutex);
+}
+
+static void channel_pass(channel *const ch)
+{
+	const size_t passed = atomic_load_explicit(&ch->passed, memory_order_relaxed);
+	ch->sizes[passed % CHUNKS_NUM] = ch->filled;
+	ch->filled = 0;
+
+	atomic_store_explicit(&ch->passed, passed + 1, memory_order_release);
+	channel_wake(ch);
+}
+
+/** Save received chunks before the chunk with text position to file and return them to writer */
+static void channel_release(channel *const ch, const size_t position)
+{
+	const size_t released = atomic_load_explicit(&ch->released, memory_order_relaxed);
+	const size_t last = position / CHUNK_SIZE < ch->received ? position / CHUNK_SIZE : ch->received;
+	if (released >= last)
+	{
+		return;
+	}
+
+	// Lost chunks are still released, so that writer does not wait forever
+	ch->is_lost = ch->is_lost || fseek(ch->file, 0, SEEK_END);
+	for (size_t i = released; i < last; i++)
+	{
+		const size_t size = ch->sizes[i % CHUNKS_NUM];
+		if (!ch->is_lost && fwrite(&ch->chunks[i % CHUNKS_NUM * CHUNK_SIZE], sizeof(char), size, ch->file) == size)
+		{
+			ch->spilled += size;
+		}
+		else
+		{
+			ch->is_lost = true;
+		}
+	}
+
+	atomic_store_explicit(&ch->released, last, memory_order_release);
+	channel_wake(ch);
+}
+
+/**
+ *	Receive text up to required size, chunks before text position are released before waiting,
+ *	so that writer always has free chunk, while reader waits
+ */
+static size_t channel_receive(channel *const ch, const size_t position, const size_t size)
+{
+	for (;;)
+	{
+		// State is loaded first, because no chunks are passed after finishing
+		const bool was_finished = is_finished(ch);
+		const size_t passed = atomic_load_explicit(&ch->passed, memory_order_acquire);
+		for (; ch->received < passed; ch->received++)
+		{
+			ch->size += ch->sizes[ch->received % CHUNKS_NUM];
+		}
+
+		if (ch->size >= size || was_finished)
+		{
+			return ch->size;
+		}
+
+		channel_release(ch, position);
+		channel_wait_for(ch, &can_receive);
+	}
+}
+
+/** Copy received text, which is not released yet or saved to file */
+static size_t channel_copy(channel *const ch, const size_t position, char *const buffer, const size_t size)
+{
+	size_t done = 0;
+	if (position < ch->spilled)
+	{
+		const size_t part = ch->spilled - position < size ? ch->spilled - position : size;
+		if (fseek(ch->file, (long)position, SEEK_SET)
+			|| fread(buffer, sizeof(char), part, ch->file) != part)
+		{
+			return 0;
+		}
+
+		done = part;
+	}
+
+	while (done < size)
+	{
+		const size_t offset = (position + done) % CHUNK_SIZE;
+		const size_t index = (position + done) / CHUNK_SIZE % CHUNKS_NUM;
+		const size_t part = CHUNK_SIZE - offset < size - done ? CHUNK_SIZE - offset : size - done;
+
+		memcpy(&buffer[done], &ch->chunks[index * CHUNK_SIZE + offset], part);
+		done += part;
+	}
+
+	return done;
+}
+
+static char *channel_load(channel *const ch)
+{
+	if (fseek(ch->file, 0, SEEK_END) || fputc('\0', ch->file) == EOF || fflush(ch->file))
+	{
+		return NULL;
+	}
+
+	// Terminating zero is mapped too, so mapping is never empty
+	void *const map = mmap(NULL, ch->size + 1, PROT_READ, MAP_PRIVATE, fileno(ch->file), 0);
+	if (map != MAP_FAILED)
+	{
+		ch->is_mapped = true;
+		return map;
+	}
+
+	char *const text = malloc((ch->size + 1) * sizeof(char));
+	if (text == NULL)
+	{
+		return NULL;
+	}
+
+	if (fseek(ch->file, 0, SEEK_SET) || fread(text, sizeof(char), ch->size + 1, ch->file) != ch->size + 1)
+	{
+		free(text);
+		return NULL;
+	}
+
+	return text;
+}
+#endif
+
+
+/*
+ *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
+ *	/\ \   /\ "-.\ \   /\__  _\ /\  ___\   /\  == \   /\  ___\ /\  __ \   /\  ___\   /\  ___\
+ *	\ \ \  \ \ \-.  \  \/_/\ \/ \ \  __\   \ \  __<   \ \  __\ \ \  __ \  \ \ \____  \ \  __\
+ *	 \ \_\  \ \_\\"\_\    \ \_\  \ \_____\  \ \_\ \_\  \ \_\    \ \_\ \_\  \ \_____\  \ \_____\
+ *	  \/_/   \/_/ \/_/     \/_/   \/_____/   \/_/ /_/   \/_/     \/_/\/_/   \/_____/   \/_____/
+ */
+
+
+channel *channel_create(comment_map *const cmts)
+{
+#ifndef _WIN32
+	channel *const ch = malloc(sizeof(channel));
+	if (ch == NULL)
+	{
+		return NULL;
+	}
+
+	ch->chunks = malloc(CHUNKS_NUM * CHUNK_SIZE * sizeof(char));
+	ch->file = tmpfile();
+	if (ch->chunks == NULL || ch->file == NULL)
+	{
+		free(ch->chunks);
+		if (ch->file != NULL)
+		{
+			fclose(ch->file);
+		}
+
+		free(ch);
+		return NULL;
+	}
+
+	atomic_init(&ch->passed, 0);
+	atomic_init(&ch->released, 0);
+	atomic_init(&ch->state, CHANNEL_OPEN);
+
+	ch->written = 0;
+	ch->filled = 0;
+
+	ch->received = 0;
+	ch->size = 0;
+	ch->spilled = 0;
+
+	ch->cmts = cmts;
+	ch->text = NULL;
+	ch->is_mapped = false;
+	ch->is_lost = false;
+
+	pthread_mutex_init(&ch->mutex, NULL);
+	pthread_cond_init(&ch->cond, NULL);
+	return ch;
+#else
+	(void)cmts;
+	return NULL;
+#endif
+}
+
+
+int channel_write(channel *const ch, const char *const data, const size_t size)
+{
+#ifndef _WIN32
+	if (ch == NULL || data == NULL || is_finished(ch))
+	{
+		return -1;
+	}
+
+	size_t done = 0;
+	while (done < size)
+	{
+		if (ch->filled == 0)
+		{
+			channel_wait_for(ch, &has_free_chunk);
+		}
+
+		const size_t index = atomic_load_explicit(&ch->passed, memory_order_relaxed) % CHUNKS_NUM;
+		const size_t part = size - done < CHUNK_SIZE - ch->filled ? size - done : CHUNK_SIZE - ch->filled;
+		memcpy(&ch->chunks[index * CHUNK_SIZE + ch->filled], &data[done], part);
+
+		ch->filled += part;
+		done += part;
+
+		if (ch->filled == CHUNK_SIZE)
+		{
+			channel_pass(ch);
+		}
+	}
+
+	ch->written += size;
+	return 0;
+#else
+	(void)ch;
+	(void)data;
+	(void)size;
+	return -1;
+#endif
+}
+
+size_t channel_get_written(const channel *const ch)
+{
+#ifndef _WIN32
+	return ch != NULL ? ch->written : 0;
+#else
+	(void)ch;
+	return 0;
+#endif
+}
+
+int channel_close(channel *const ch, const bool is_correct)
+{
+#ifndef _WIN32
+	if (ch == NULL || is_finished(ch))
+	{
+		return -1;
+	}
+
+	if (ch->filled != 0)
+	{
+		channel_pass(ch);
+	}
+
+	atomic_store_explicit(&ch->state, is_correct ? CHANNEL_FINISHED : CHANNEL_FAILED, memory_order_release);
+	channel_wake(ch);
+	return 0;
+#else
+	(void)ch;
+	(void)is_correct;
+	return -1;
+#endif
+}
+
+
+size_t channel_await(channel *const ch, const size_t size)
+{
+#ifndef _WIN32
+	if (ch == NULL)
+	{
+		return 0;
+	}
+
+	return channel_receive(ch, size, size);
+#else
+	(void)ch;
+	(void)size;
+	return 0;
+#endif
+}
+
+size_t channel_read(channel *const ch, const size_t position, char *const buffer, const size_t size)
+{
+#ifndef _WIN32
+	if (ch == NULL || buffer == NULL)
+	{
+		return 0;
+	}
+
+	// Text before read position is not needed, while reader goes forward
+	channel_release(ch, position);
+	const size_t end = channel_receive(ch, position, position + size);
+
+	// Failed text ends early, so that reader does not process it further
+	if (position >= end || ch->is_lost || atomic_load_explicit(&ch->state, memory_order_acquire) == CHANNEL_FAILED)
+	{
+		return 0;
+	}
+
+	const size_t count = end - position < size ? end - position : size;
+	if (ch->text != NULL)
+	{
+		memcpy(buffer, &ch->text[position], count);
+		return count;
+	}
+
+	return channel_copy(ch, position, buffer, count);
+#else
+	(void)ch;
+	(void)position;
+	(void)buffer;
+	(void)size;
+	return 0;
+#endif
+}
+
+int channel_wait(channel *const ch)
+{
+#ifndef _WIN32
+	if (ch == NULL)
+	{
+		return -1;
+	}
+
+	channel_receive(ch, SIZE_MAX, SIZE_MAX);
+	channel_release(ch, SIZE_MAX);
+	return !ch->is_lost && atomic_load_explicit(&ch->state, memory_order_acquire) == CHANNEL_FINISHED ? 0 : -1;
+#else
+	(void)ch;
+	return -1;
+#endif
+}
+
+const char *channel_get_text(channel *const ch)
+{
+#ifndef _WIN32
+	if (channel_wait(ch))
+	{
+		return NULL;
+	}
+
+	if (ch->text == NULL)
+	{
+		ch->text = channel_load(ch);
+
+		// Intermediate records speed up line search for diagnostics
+		if (ch->text != NULL && ch->cmts != NULL)
+		{
+			cmt_map_complete(ch->cmts, ch->text);
+		}
+	}
+
+	return ch->text;
+#else
+	(void)ch;
+	return NULL;
+#endif
+}
+
+
+int channel_clear(channel *const ch)
+{
+	if (ch == NULL)
+	{
+		return -1;
+	}
+
+#ifndef _WIN32
+	if (ch->is_mapped)
+	{
+		munmap(ch->text, ch->size + 1);
+	}
+	else
+	{
+		free(ch->text);
+	}
+
+	fclose(ch->file);
+	free(ch->chunks);
+
+	pthread_mutex_destroy(&ch->mutex);
+	pthread_cond_destroy(&ch->cond);
+#endif
+
+	free(ch);
+	return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ *	Copyright 2026 Andrey Terekhov, Victor Y. Fadeev
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "commenter.h"
+#include "dll.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *	Text, which is written by one thread and read by another one
+ *	@note	Writer passes text to reader through bounded queue of fixed-size chunks
+ *			and waits, while the queue is full. Reader reads received chunks in place
+ *			and saves them to temporary file only on returning to writer,
+ *			so it can return to any received position
+ */
+typedef struct channel channel;
+
+
+/**
+ *	Create channel
+ *	@note	Channel is not available on Windows
+ *
+ *	@param	cmts		Comments of text, completed after loading whole text, may be @c NULL
+ *
+ *	@return	Channel, @c NULL on failure
+ */
+EXPORTED channel *channel_create(comment_map *const cmts);
+
+
+/**
+ *	Write bytes to channel, writer only
+ *	@note	Writer waits, while all chunks of queue are not received by reader
+ *
+ *	@param	ch			Channel
+ *	@param	data		Bytes to write
+ *	@param	size		Number of bytes
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int channel_write(channel *const ch, const char *const data, const size_t size);
+
+/**
+ *	Get size of written text, writer only
+ *
+ *	@param	ch			Channel
+ *
+ *	@return	Size of written text
+ */
+EXPORTED size_t channel_get_written(const channel *const ch);
+
+/**
+ *	Pass the last chunk to reader and finish text, writer only
+ *
+ *	@param	ch			Channel
+ *	@param	is_correct	Set, if text is finished successfully
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int channel_close(channel *const ch, const bool is_correct);
+
+
+/**
+ *	Receive text up to required size, reader only
+ *	@note	Reader waits until text has required size or is finished
+ *
+ *	@param	ch			Channel
+ *	@param	size		Required size of text
+ *
+ *	@return	Size of received text
+ */
+EXPORTED size_t channel_await(channel *const ch, const size_t size);
+
+/**
+ *	Read received text, reader only
+ *	@note	Text is received up to the end of read bytes
+ *
+ *	@param	ch			Channel
+ *	@param	position	Text position of first byte
+ *	@param	buffer		Destination buffer
+ *	@param	size		Number of bytes
+ *
+ *	@return	Number of read bytes, less than @p size only at the end of text, @c 0 if text is failed
+ */
+EXPORTED size_t channel_read(channel *const ch, const size_t position, char *const buffer, const size_t size);
+
+/**
+ *	Receive whole text, reader only
+ *
+ *	@param	ch			Channel
+ *
+ *	@return	@c 0 if text is finished successfully, @c -1 otherwise
+ */
+EXPORTED int channel_wait(channel *const ch);
+
+/**
+ *	Get whole text after receiving it, reader only
+ *	@note	Text is loaded from temporary file and its comments are completed on the first call
+ *
+ *	@param	ch			Channel
+ *
+ *	@return	Whole text, @c NULL if it is not finished successfully
+ */
+EXPORTED const char *channel_get_text(channel *const ch);
+
+
+/**
+ *	Free allocated memory
+ *
+ *	@param	ch			Channel
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int channel_clear(channel *const ch);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -17,6 +17,7 @@
 #include "commenter.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "utf8.h"
 
@@ -24,6 +25,10 @@
 static const char *const PREFIX = "// #";
 static const char SEPARATOR = ' ';
 
+static const size_t RECORD_SIZE = 3;
+static const size_t MAP_SIZE = 256;
+static const size_t MAX_LINES = 64;
+
 
 static inline void cmt_parse(comment *const cmt)
 {
@@ -98,6 +103,97 @@ static inline void cmt_reverse(comment *const cmt, const char *const code, const
 	}
 }
 
+static inline comment cmt_line_start(const char *const code, const size_t position)
+{
+	comment cmt;
+	cmt.path = NULL;
+	cmt.line = 1;
+	cmt.symbol = SIZE_MAX;
+	cmt.code = NULL;
+
+	if (code == NULL)
+	{
+		return cmt;
+	}
+
+	size_t i = position;
+	while (i != 0 && code[i - 1] != '\n')
+	{
+		i--;
+	}
+
+	cmt.code = &code[i];
+	cmt.symbol = position - i;
+	return cmt;
+}
+
+/** Get offset of path in map, path is added if it is absent */
+static size_t cmt_map_path(comment_map *const cmts, const char *const path)
+{
+	if (cmts->records_size != 0)
+	{
+		const size_t last = cmts->records[(cmts->records_size - 1) * RECORD_SIZE + 1];
+		if (strcmp(&cmts->paths[last], path) == 0)
+		{
+			return last;
+		}
+	}
+
+	for (size_t i = 0; i < cmts->paths_size; i += strlen(&cmts->paths[i]) + 1)
+	{
+		if (strcmp(&cmts->paths[i], path) == 0)
+		{
+			return i;
+		}
+	}
+
+	const size_t size = strlen(path) + 1;
+	if (cmts->paths_size + size > cmts->paths_alloc)
+	{
+		const size_t alloc = 2 * cmts->paths_alloc + size;
+		char *const paths = realloc(cmts->paths, alloc * sizeof(char));
+		if (paths == NULL)
+		{
+			return SIZE_MAX;
+		}
+
+		cmts->paths = paths;
+		cmts->paths_alloc = alloc;
+	}
+
+	const size_t offset = cmts->paths_size;
+	memcpy(&cmts->paths[offset], path, size);
+	cmts->paths_size += size;
+	return offset;
+}
+
+static inline int cmt_write_array(FILE *const file, const void *const data, const size_t size)
+{
+	const uint64_t value = size;
+	return fwrite(&value, sizeof(value), 1, file) == 1 && (size == 0 || fwrite(data, 1, size, file) == size) ? 0 : -1;
+}
+
+/** Read sized array to allocated memory */
+static void *cmt_read_array(FILE *const file, size_t *const size)
+{
+	uint64_t value;
+	if (fread(&value, sizeof(value), 1, file) != 1 || value >= SIZE_MAX)
+	{
+		return NULL;
+	}
+
+	// Empty array is allocated too, so that NULL means failure
+	void *const data = malloc(value != 0 ? (size_t)value : 1);
+	if (data == NULL || (value != 0 && fread(data, 1, (size_t)value, file) != (size_t)value))
+	{
+		free(data);
+		return NULL;
+	}
+
+	*size = (size_t)value;
+	return data;
+}
+
 
 /*
  *	 __     __   __     ______   ______     ______     ______   ______     ______     ______
@@ -152,30 +248,249 @@ size_t cmt_to_string(const comment *const cmt, char *const buffer)
 
 comment cmt_search(const char *const code, const size_t position)
 {
-	comment cmt;
-	cmt.path = NULL;
-	cmt.line = 1;
-	cmt.symbol = SIZE_MAX;
-	cmt.code = NULL;
+	comment cmt = cmt_line_start(code, position);
+	if (cmt.code != NULL)
+	{
+		cmt_reverse(&cmt, code, (size_t)(cmt.code - code));
+	}
 
-	if (code == NULL)
+	return cmt;
+}
+
+
+comment_map cmt_map_create(void)
+{
+	comment_map cmts;
+
+	cmts.paths = malloc(MAP_SIZE * sizeof(char));
+	cmts.paths_size = 0;
+	cmts.paths_alloc = cmts.paths != NULL ? MAP_SIZE : 0;
+
+	cmts.records = malloc(MAP_SIZE * RECORD_SIZE * sizeof(size_t));
+	cmts.records_size = 0;
+	cmts.records_alloc = cmts.records != NULL ? MAP_SIZE : 0;
+
+	return cmts;
+}
+
+int cmt_map_add(comment_map *const cmts, const size_t position, const comment *const cmt)
+{
+	if (cmts == NULL || !cmt_is_correct(cmt))
+	{
+		return -1;
+	}
+
+	const size_t path = cmt_map_path(cmts, cmt->path);
+	if (path == SIZE_MAX)
+	{
+		return -1;
+	}
+
+	// Новая запись для той же строки заменяет предыдущую
+	size_t index = cmts->records_size;
+	if (index != 0 && cmts->records[(index - 1) * RECORD_SIZE] == position)
+	{
+		index--;
+	}
+	else if (index == cmts->records_alloc)
+	{
+		const size_t alloc = 2 * cmts->records_alloc + 1;
+		size_t *const records = realloc(cmts->records, alloc * RECORD_SIZE * sizeof(size_t));
+		if (records == NULL)
+		{
+			return -1;
+		}
+
+		cmts->records = records;
+		cmts->records_alloc = alloc;
+	}
+
+	cmts->records[index * RECORD_SIZE] = position;
+	cmts->records[index * RECORD_SIZE + 1] = path;
+	cmts->records[index * RECORD_SIZE + 2] = cmt->line;
+	cmts->records_size = index + 1;
+	return 0;
+}
+
+int cmt_map_append(comment_map *const cmts, const comment_map *const other, const size_t offset)
+{
+	if (cmts == NULL || other == NULL)
+	{
+		return -1;
+	}
+
+	for (size_t i = 0; i < other->records_size; i++)
+	{
+		const size_t *const record = &other->records[i * RECORD_SIZE];
+		const comment cmt = cmt_create(&other->paths[record[1]], record[2]);
+		if (cmt_map_add(cmts, record[0] + offset, &cmt))
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int cmt_map_complete(comment_map *const cmts, const char *const code)
+{
+	if (cmts == NULL || code == NULL)
+	{
+		return -1;
+	}
+
+	const size_t end = strlen(code);
+	size_t alloc = cmts->records_size + end / MAX_LINES + 1;
+	size_t *const records = malloc(alloc * RECORD_SIZE * sizeof(size_t));
+	if (records == NULL)
+	{
+		return -1;
+	}
+
+	size_t size = 0;
+	for (size_t i = 0; i < cmts->records_size; i++)
+	{
+		const size_t *const record = &cmts->records[i * RECORD_SIZE];
+		const size_t next = i + 1 < cmts->records_size ? record[RECORD_SIZE] : end;
+
+		size_t position = record[0];
+		size_t line = record[2];
+		size_t lines = 0;
+		memcpy(&records[size++ * RECORD_SIZE], record, RECORD_SIZE * sizeof(size_t));
+
+		// Промежуточная запись через каждые MAX_LINES строк
+		for (const char *found = memchr(&code[position], '\n', next - position); found != NULL
+			; found = memchr(&code[position], '\n', next - position))
+		{
+			position = (size_t)(found - code) + 1;
+			line++;
+
+			if (++lines == MAX_LINES && position < next)
+			{
+				records[size * RECORD_SIZE] = position;
+				records[size * RECORD_SIZE + 1] = record[1];
+				records[size * RECORD_SIZE + 2] = line;
+				size++;
+				lines = 0;
+			}
+		}
+	}
+
+	free(cmts->records);
+	cmts->records = records;
+	cmts->records_size = size;
+	cmts->records_alloc = alloc;
+	return 0;
+}
+
+comment cmt_map_search(const comment_map *const cmts, const char *const code, const size_t position)
+{
+	comment cmt = cmt_line_start(code, position);
+	if (cmts == NULL || cmt.code == NULL)
 	{
 		return cmt;
 	}
 
-	size_t i = position;
-	while (i != 0 && code[i - 1] != '\n')
+	// Последняя запись не дальше начала строки
+	const size_t begin = (size_t)(cmt.code - code);
+	size_t left = 0;
+	size_t right = cmts->records_size;
+	while (left < right)
 	{
-		i--;
+		const size_t middle = left + (right - left) / 2;
+		if (cmts->records[middle * RECORD_SIZE] <= begin)
+		{
+			left = middle + 1;
+		}
+		else
+		{
+			right = middle;
+		}
 	}
 
-	cmt.code = &code[i];
-	cmt.symbol = position - i;
+	if (left == 0)
+	{
+		return cmt;
+	}
+
+	const size_t *const record = &cmts->records[(left - 1) * RECORD_SIZE];
+	cmt.path = &cmts->paths[record[1]];
+	cmt.line = record[2];
+
+	for (size_t i = record[0]; i < begin; i++)
+	{
+		cmt.line += code[i] == '\n';
+	}
 
-	cmt_reverse(&cmt, code, i);
 	return cmt;
 }
 
+int cmt_map_write(const comment_map *const cmts, FILE *const file)
+{
+	if (cmts == NULL || file == NULL)
+	{
+		return -1;
+	}
+
+	// Records are stored as is, so their format is checked on reading
+	const uint64_t format[] = { sizeof(size_t), RECORD_SIZE };
+	return fwrite(format, sizeof(format), 1, file) != 1
+		|| cmt_write_array(file, cmts->paths, cmts->paths_size)
+		|| cmt_write_array(file, cmts->records, cmts->records_size * RECORD_SIZE * sizeof(size_t)) ? -1 : 0;
+}
+
+int cmt_map_read(comment_map *const cmts, FILE *const file)
+{
+	uint64_t format[2];
+	if (cmts == NULL || file == NULL || fread(format, sizeof(format), 1, file) != 1
+		|| format[0] != sizeof(size_t) || format[1] != RECORD_SIZE)
+	{
+		return -1;
+	}
+
+	comment_map saved;
+	saved.paths = cmt_read_array(file, &saved.paths_size);
+	saved.paths_alloc = saved.paths_size;
+
+	size_t size = 0;
+	saved.records = saved.paths != NULL ? cmt_read_array(file, &size) : NULL;
+	saved.records_size = size / (RECORD_SIZE * sizeof(size_t));
+	saved.records_alloc = saved.records_size;
+
+	// Paths of records must be terminated strings of the map
+	int ret = saved.records == NULL || size % (RECORD_SIZE * sizeof(size_t)) != 0
+		|| (saved.paths_size != 0 && saved.paths[saved.paths_size - 1] != '\0');
+	for (size_t i = 0; !ret && i < saved.records_size; i++)
+	{
+		ret = saved.records[i * RECORD_SIZE + 1] >= saved.paths_size;
+	}
+
+	ret = ret || cmt_map_append(cmts, &saved, 0);
+	cmt_map_clear(&saved);
+	return ret ? -1 : 0;
+}
+
+
+int cmt_map_clear(comment_map *const cmts)
+{
+	if (cmts == NULL)
+	{
+		return -1;
+	}
+
+	free(cmts->paths);
+	cmts->paths = NULL;
+	cmts->paths_size = 0;
+	cmts->paths_alloc = 0;
+
+	free(cmts->records);
+	cmts->records = NULL;
+	cmts->records_size = 0;
+	cmts->records_alloc = 0;
+
+	return 0;
+}
+
 
 bool cmt_is_correct(const comment *const cmt)
 {
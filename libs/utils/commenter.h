@@ -18,6 +18,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdio.h>
 #include "dll.h"
 
 
@@ -35,6 +36,18 @@ typedef struct comment
 	const char *code;	/**< Current line in code */
 } comment;
 
+/** Structure for storing comments apart from code */
+typedef struct comment_map
+{
+	char *paths;			/**< File paths, each ends with zero */
+	size_t paths_size;		/**< Size of file paths */
+	size_t paths_alloc;		/**< Allocated size of file paths */
+
+	size_t *records;		/**< Records of code position, path offset and line number */
+	size_t records_size;	/**< Number of records */
+	size_t records_alloc;	/**< Allocated number of records */
+} comment_map;
+
 
 /**
  *	Create comment
@@ -80,6 +93,88 @@ EXPORTED size_t cmt_to_string(const comment *const cmt, char *const buffer);
 EXPORTED comment cmt_search(const char *const code, const size_t position);
 
 
+/**
+ *	Create comment map
+ *
+ *	@return	Comment map structure
+ */
+EXPORTED comment_map cmt_map_create(void);
+
+/**
+ *	Add comment to map instead of code
+ *	@note	Comment relates to code line, which starts from position
+ *
+ *	@param	cmts		Comment map
+ *	@param	position	Position of code line, not less than previous one
+ *	@param	cmt			Comment
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int cmt_map_add(comment_map *const cmts, const size_t position, const comment *const cmt);
+
+/**
+ *	Add comments of another map, which relates to code after existing one
+ *
+ *	@param	cmts		Comment map
+ *	@param	other		Added comment map
+ *	@param	offset		Position of added code
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int cmt_map_append(comment_map *const cmts, const comment_map *const other, const size_t offset);
+
+/**
+ *	Add intermediate comments to map, so that each code line is close to its comment
+ *
+ *	@param	cmts		Comment map
+ *	@param	code		Code without comments
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int cmt_map_complete(comment_map *const cmts, const char *const code);
+
+/**
+ *	Find comment for code position in map
+ *
+ *	@param	cmts		Comment map
+ *	@param	code		Code without comments
+ *	@param	position	Position in code
+ *
+ *	@return	Comment structure
+ */
+EXPORTED comment cmt_map_search(const comment_map *const cmts, const char *const code, const size_t position);
+
+/**
+ *	Write comment map to binary file
+ *	@note	Records are written as is, so they are read only by the same build
+ *
+ *	@param	cmts		Comment map
+ *	@param	file		Binary file
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int cmt_map_write(const comment_map *const cmts, FILE *const file);
+
+/**
+ *	Read comments from binary file and add them to map
+ *
+ *	@param	cmts		Comment map
+ *	@param	file		Binary file
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int cmt_map_read(comment_map *const cmts, FILE *const file);
+
+/**
+ *	Free allocated memory
+ *
+ *	@param	cmts		Comment map
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int cmt_map_clear(comment_map *const cmts);
+
+
 /**
  *	Check that comment is correct
  *
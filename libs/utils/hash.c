@@ -15,6 +15,23 @@
  */
 
 #include "hash.h"
+#include <stdlib.h>
+
+
+#define HASH_TABLE_SIZE	256
+
+#define HASH_EMPTY		SIZE_MAX
+#define HASH_REMOVED	(SIZE_MAX - 1)
+
+#define HASH_LOAD_NUMERATOR		3
+#define HASH_LOAD_DENOMINATOR	4
+
+
+struct hash_slot
+{
+	item_t key;			/**< Key */
+	size_t index;		/**< Record index */
+};
 
 
 extern item_t hash_get_key(const hash *const hs, const size_t index);
@@ -28,15 +45,107 @@ extern int hash_set_by_index(hash *const hs, const size_t index, const size_t nu
 extern size_t hash_set_double_by_index(hash *const hs, const size_t index, const size_t num, const double value);
 extern size_t hash_set_int64_by_index(hash *const hs, const size_t index, const size_t num, const int64_t value);
 
-extern int hash_remove_by_index(hash *const hs, const size_t index);
-
 extern bool hash_is_correct(const hash *const hs);
-extern int hash_clear(hash *const hs);
 
 
 static inline size_t get_hash(const item_t key)
 {
-	return (size_t)key % MAX_HASH;
+	// Finalizer of MurmurHash3, so that sequential keys are spread over table
+	uint64_t hash = (uint64_t)key;
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33;
+	return (size_t)hash;
+}
+
+static inline hash_slot *table_create(const size_t size)
+{
+	hash_slot *table = malloc(size * sizeof(hash_slot));
+	if (table == NULL)
+	{
+		return NULL;
+	}
+
+	for (size_t i = 0; i < size; i++)
+	{
+		table[i].index = HASH_EMPTY;
+	}
+
+	return table;
+}
+
+static size_t hash_find_slot(const hash *const hs, const item_t key)
+{
+	const size_t mask = hs->table_alloc - 1;
+
+	size_t slot = get_hash(key) & mask;
+	while (hs->table[slot].index != HASH_EMPTY)
+	{
+		if (hs->table[slot].key == key && hs->table[slot].index != HASH_REMOVED)
+		{
+			return slot;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+static int hash_rehash(hash *const hs)
+{
+	// Table grows only if there are many keys, otherwise removed slots are dropped
+	const size_t table_alloc = (hs->size + 1) * 2 > hs->table_alloc ? 2 * hs->table_alloc : hs->table_alloc;
+	hash_slot *table_new = table_create(table_alloc);
+	if (table_new == NULL)
+	{
+		return -1;
+	}
+
+	for (size_t i = 0; i < hs->table_alloc; i++)
+	{
+		if (hs->table[i].index != HASH_EMPTY && hs->table[i].index != HASH_REMOVED)
+		{
+			size_t slot = get_hash(hs->table[i].key) & (table_alloc - 1);
+			while (table_new[slot].index != HASH_EMPTY)
+			{
+				slot = (slot + 1) & (table_alloc - 1);
+			}
+			table_new[slot] = hs->table[i];
+		}
+	}
+
+	free(hs->table);
+	hs->table = table_new;
+	hs->table_alloc = table_alloc;
+	hs->table_used = hs->size;
+	return 0;
+}
+
+/**
+ *	Take removed record with the same values amount
+ *	@note	Key of removed record refers to the next one in the list, list indices are shifted by one
+ *
+ *	@param	hs			Hash table
+ *	@param	amount		Values amount
+ *
+ *	@return	Record index with values set by zero, @c SIZE_MAX if there is no such record
+ */
+static size_t hash_take_removed(hash *const hs, const size_t amount)
+{
+	const item_t head = amount < vector_size(&hs->removed) ? vector_get(&hs->removed, amount) : 0;
+	if (head == 0)
+	{
+		return SIZE_MAX;
+	}
+
+	const size_t index = (size_t)head - 1;
+	vector_set(&hs->removed, amount, vector_get(&hs->records, index));
+	for (size_t i = 0; i < amount; i++)
+	{
+		vector_set(&hs->records, index + 2 + i, 0);
+	}
+
+	return index;
 }
 
 
@@ -51,90 +160,74 @@ static inline size_t get_hash(const item_t key)
 
 hash hash_create(const size_t alloc)
 {
-	hash hs = vector_create(MAX_HASH + alloc * (3 + VALUE_SIZE));
-	vector_increase(&hs, MAX_HASH);	// All set by zero
+	hash hs;
+	hs.table_alloc = HASH_TABLE_SIZE;
+	while (hs.table_alloc * HASH_LOAD_NUMERATOR < alloc * HASH_LOAD_DENOMINATOR)
+	{
+		hs.table_alloc *= 2;
+	}
+
+	hs.table = table_create(hs.table_alloc);
+	hs.table_used = 0;
+	hs.size = 0;
+
+	hs.records = vector_create(alloc * (2 + VALUE_SIZE));
+	hs.removed = vector_create(VALUE_SIZE);
 	return hs;
 }
 
 
 size_t hash_add(hash *const hs, const item_t key, const size_t amount)
 {
-	if (!hash_is_correct(hs))
+	if (!hash_is_correct(hs) || hs->table[hash_find_slot(hs, key)].index != HASH_EMPTY)
 	{
 		return SIZE_MAX;
 	}
 
-	size_t prev = get_hash(key);
-	item_t index = vector_get(hs, prev);
-
-	if (index != 0)
+	if ((hs->table_used + 1) * HASH_LOAD_DENOMINATOR > hs->table_alloc * HASH_LOAD_NUMERATOR && hash_rehash(hs))
 	{
-		item_t record = ITEM_MAX;
-		while (index != ITEM_MAX && index != 0)
-		{
-			const item_t temp = vector_get(hs, (size_t)index + 1);
-			if (record == ITEM_MAX && temp == ITEM_MAX && (size_t)vector_get(hs, (size_t)index + 2) == amount)
-			{
-				record = index;
-			}
-			else if (temp == key)
-			{
-				return SIZE_MAX;
-			}
+		return SIZE_MAX;
+	}
 
-			prev = (size_t)index;
-			index = vector_get(hs, prev);
-		}
+	// New key takes the first removed or empty slot
+	const size_t mask = hs->table_alloc - 1;
+	size_t slot = get_hash(key) & mask;
+	while (hs->table[slot].index != HASH_EMPTY && hs->table[slot].index != HASH_REMOVED)
+	{
+		slot = (slot + 1) & mask;
+	}
 
-		if (record != ITEM_MAX)
-		{
-			index = record;
-			for (size_t i = 0; i < amount; i++)
-			{
-				vector_set(hs, (size_t)index + 3 + i, 0);
-			}
-		}
-		else if (index == ITEM_MAX)
+	size_t index = hash_take_removed(hs, amount);
+	if (index == SIZE_MAX)
+	{
+		index = vector_size(&hs->records);
+		if (vector_add(&hs->records, key) == SIZE_MAX || vector_add(&hs->records, (item_t)amount) == SIZE_MAX
+			|| vector_increase(&hs->records, amount))	// New elements set by zero
 		{
+			vector_resize(&hs->records, index);
 			return SIZE_MAX;
 		}
 	}
+	else
+	{
+		vector_set(&hs->records, index, key);
+	}
 
-	if (index == 0)
+	if (hs->table[slot].index == HASH_EMPTY)
 	{
-		index = (item_t)vector_size(hs);
-		vector_set(hs, prev, index);
-		vector_increase(hs, 3 + amount);	// New elements set by zero
-		vector_set(hs, (size_t)index + 2, (item_t)amount);
+		hs->table_used++;
 	}
 
-	vector_set(hs, (size_t)index + 1, key);
-	return (size_t)index;
+	hs->table[slot].key = key;
+	hs->table[slot].index = index;
+	hs->size++;
+	return index;
 }
 
 
 size_t hash_get_index(const hash *const hs, const item_t key)
 {
-	if (!hash_is_correct(hs))
-	{
-		return SIZE_MAX;
-	}
-
-	size_t prev = get_hash(key);
-	item_t index = vector_get(hs, prev);
-
-	while (index != ITEM_MAX && index != 0)
-	{
-		if (vector_get(hs, (size_t)index + 1) == key)
-		{
-			return (size_t)index;
-		}
-
-		prev = (size_t)index;
-		index = vector_get(hs, prev);
-	}
-
-	return SIZE_MAX;
+	return hash_is_correct(hs) ? hs->table[hash_find_slot(hs, key)].index : SIZE_MAX;
 }
 
 size_t hash_get_amount(const hash *const hs, const item_t key)
@@ -162,19 +255,19 @@ int64_t hash_get_int64(const hash *const hs, const item_t key, const size_t num)
 size_t hash_set(hash *const hs, const item_t key, const size_t num, const item_t value)
 {
 	const size_t index = hash_get_index(hs, key);
-	return hash_set_by_index(hs, hash_get_index(hs, key), num, value) == 0 ? index : SIZE_MAX;
+	return hash_set_by_index(hs, index, num, value) == 0 ? index : SIZE_MAX;
 }
 
 size_t hash_set_double(hash *const hs, const item_t key, const size_t num, const double value)
 {
 	const size_t index = hash_get_index(hs, key);
-	return hash_set_double_by_index(hs, hash_get_index(hs, key), num, value) != DBL_MAX ? index : SIZE_MAX;
+	return hash_set_double_by_index(hs, index, num, value) != DBL_MAX ? index : SIZE_MAX;
 }
 
 size_t hash_set_int64(hash *const hs, const item_t key, const size_t num, const int64_t value)
 {
 	const size_t index = hash_get_index(hs, key);
-	return hash_set_int64_by_index(hs, hash_get_index(hs, key), num, value) != LLONG_MAX ? index : SIZE_MAX;
+	return hash_set_int64_by_index(hs, index, num, value) != LLONG_MAX ? index : SIZE_MAX;
 }
 
 
@@ -182,3 +275,63 @@ int hash_remove(hash *const hs, const item_t key)
 {
 	return hash_remove_by_index(hs, hash_get_index(hs, key));
 }
+
+int hash_remove_by_index(hash *const hs, const size_t index)
+{
+	if (!hash_is_correct(hs) || index == SIZE_MAX)
+	{
+		return -1;
+	}
+
+	const size_t slot = hash_find_slot(hs, hash_get_key(hs, index));
+	if (hs->table[slot].index != index)
+	{
+		return -1;
+	}
+
+	// Removed record is put to the list of records with the same values amount
+	const size_t amount = hash_get_amount_by_index(hs, index);
+	if (amount >= vector_size(&hs->removed) && vector_increase(&hs->removed, amount + 1 - vector_size(&hs->removed)))
+	{
+		return -1;
+	}
+
+	hs->table[slot].index = HASH_REMOVED;
+	hs->size--;
+
+	vector_set(&hs->records, index, vector_get(&hs->removed, amount));
+	return vector_set(&hs->removed, amount, (item_t)index + 1);
+}
+
+int hash_reset(hash *const hs)
+{
+	if (!hash_is_correct(hs))
+	{
+		return -1;
+	}
+
+	for (size_t i = 0; i < hs->table_alloc; i++)
+	{
+		hs->table[i].index = HASH_EMPTY;
+	}
+
+	hs->table_used = 0;
+	hs->size = 0;
+
+	return vector_resize(&hs->records, 0) || vector_resize(&hs->removed, 0) ? -1 : 0;
+}
+
+
+int hash_clear(hash *const hs)
+{
+	if (!hash_is_correct(hs))
+	{
+		return -1;
+	}
+
+	free(hs->table);
+	hs->table = NULL;
+
+	vector_clear(&hs->removed);
+	return vector_clear(&hs->records);
+}
@@ -21,13 +21,68 @@
 #include "utf8.h"
 
 
+#define FNV_OFFSET_BASIS	14695981039346656037ULL
+#define FNV_PRIME			1099511628211ULL
+
+#define MAP_LOAD_NUMERATOR		3
+#define MAP_LOAD_DENOMINATOR	4
+
+
 struct map_hash
 {
-	size_t next;
-	size_t ref;
-	item_t value;
+	size_t ref;			/**< Key reference in keys storage */
+	size_t hash;		/**< Cached hash of key */
+	item_t value;		/**< Value */
 };
 
+/** Probe key, which is hashed and compared in place */
+typedef struct map_key
+{
+	const char *string;			/**< Key as UTF-8 bytes */
+	const char32_t *chars;		/**< Key as characters, used when string is not set */
+	size_t size;				/**< Size of key in bytes */
+	size_t hash;				/**< Hash of key, @c SIZE_MAX on failure */
+} map_key;
+
+
+static inline uint64_t map_hash_bytes(uint64_t hash, const char *const bytes, const size_t size)
+{
+	// FNV-1a over UTF-8 bytes
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= (unsigned char)bytes[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+static inline size_t map_hash_finish(const uint64_t hash)
+{
+	// SIZE_MAX is reserved for failure
+	return (size_t)hash & (SIZE_MAX >> 1);
+}
+
+static inline map_key map_key_broken(void)
+{
+	map_key key;
+	key.string = NULL;
+	key.chars = NULL;
+	key.size = 0;
+	key.hash = SIZE_MAX;
+	return key;
+}
+
+static inline map_key map_key_by_slice(const char *const string, const size_t size)
+{
+	map_key key;
+	key.string = string;
+	key.chars = NULL;
+	key.size = size;
+	key.hash = map_hash_finish(map_hash_bytes(FNV_OFFSET_BASIS, string, size));
+	return key;
+}
+
 
 static int map_add_key_symbol(map *const as, const char32_t ch)
 {
@@ -48,153 +103,325 @@ static int map_add_key_symbol(map *const as, const char32_t ch)
 	return map_add_key_symbol(as, ch);
 }
 
-static size_t map_get_hash(map *const as, const char *const key)
+static map_key map_get_key(map *const as, const char *const key)
 {
 	if (!map_is_correct(as) || key == NULL || key[0] == '\0')
 	{
-		return SIZE_MAX;
+		return map_key_broken();
 	}
 
 	as->keys_next = as->keys_size;
+	return map_key_by_slice(key, strlen(key));
+}
 
-	char32_t ch = utf8_convert(key);
-	if (map_add_key_symbol(as, ch))
+static map_key map_get_key_by_utf8(map *const as, const char32_t *const key)
+{
+	if (!map_is_correct(as) || key == NULL || key[0] == '\0')
 	{
-		return SIZE_MAX;
+		return map_key_broken();
 	}
 
-	size_t hash = ch;
-	while (key[as->keys_next - as->keys_size] != '\0')
+	as->keys_next = as->keys_size;
+
+	map_key result = map_key_broken();
+	result.chars = key;
+
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for (size_t i = 0; key[i] != '\0'; i++)
 	{
-		ch = utf8_convert(&key[as->keys_next - as->keys_size]);
-		if (map_add_key_symbol(as, ch))
-		{
-			return SIZE_MAX;
-		}
+		char buffer[MAX_SYMBOL_SIZE];
+		const size_t size = utf8_to_string(buffer, key[i]);
 
-		hash += ch;
+		hash = map_hash_bytes(hash, buffer, size);
+		result.size += size;
 	}
 
-	return hash % MAP_HASH_MAX;
+	result.hash = map_hash_finish(hash);
+	return result;
 }
 
-static size_t map_get_hash_by_utf8(map *const as, const char32_t *const key)
+static map_key map_read_key_by_io(map *const as, universal_io *const io, char32_t *const last)
 {
-	if (!map_is_correct(as) || key == NULL || key[0] == '\0')
+	*last = uni_scan_char(io);
+	if (!utf8_is_letter(*last) && *last != '#')
 	{
-		return SIZE_MAX;
+		return map_key_broken();
 	}
 
-	as->keys_next = as->keys_size;
+	if (map_add_key_symbol(as, *last))
+	{
+		return map_key_broken();
+	}
 
-	size_t hash = 0;
-	for (size_t i = 0; key[i] != '\0'; i++)
+	*last = uni_scan_char(io);
+	while (utf8_is_letter(*last) || utf8_is_digit(*last))
 	{
-		if (map_add_key_symbol(as, key[i]))
+		if (map_add_key_symbol(as, *last))
 		{
-			return SIZE_MAX;
+			return map_key_broken();
 		}
 
-		hash += key[i];
+		*last = uni_scan_char(io);
 	}
 
-	return hash % MAP_HASH_MAX;
+	return map_key_by_slice(&as->keys[as->keys_size], as->keys_next - as->keys_size);
 }
 
-static size_t map_get_hash_by_io(map *const as, universal_io *const io, char32_t *const last)
+/**
+ *	Get size of key at the beginning of loaded bytes
+ *	@note	ASCII bytes are classified directly, only other characters are decoded
+ *
+ *	@param	bytes		Loaded bytes
+ *	@param	available	Number of loaded bytes
+ *
+ *	@return	Size of key in bytes, @c available if key may continue after loaded bytes
+ */
+static size_t map_scan_word(const char *const bytes, const size_t available)
 {
-	if (!map_is_correct(as) || !in_is_correct(io) || last == NULL)
+	size_t size = 0;
+	while (size < available)
 	{
-		return SIZE_MAX;
+		const char byte = bytes[size];
+		if ((byte & 0x80) == 0)
+		{
+			if (!((byte >= 'a' && byte <= 'z') || (byte >= 'A' && byte <= 'Z') || byte == '_'
+				|| (size == 0 ? byte == '#' : byte >= '0' && byte <= '9')))
+			{
+				return size;
+			}
+
+			size++;
+			continue;
+		}
+
+		const size_t symbol_size = utf8_symbol_size(byte);
+		if (size + symbol_size > available)
+		{
+			return available;
+		}
+
+		if (!utf8_is_letter(utf8_convert(&bytes[size])))
+		{
+			return size;
+		}
+
+		size += symbol_size;
 	}
 
-	as->keys_next = as->keys_size;
+	return available;
+}
 
-	*last = uni_scan_char(io);
-	if (!utf8_is_letter(*last) && *last != '#')
+static map_key map_get_key_by_io(map *const as, universal_io *const io, char32_t *const last)
+{
+	if (!map_is_correct(as) || !in_is_correct(io) || last == NULL)
 	{
-		return SIZE_MAX;
+		return map_key_broken();
 	}
 
-	if (map_add_key_symbol(as, *last))
+	as->keys_next = as->keys_size;
+	if (in_is_func(io))
 	{
-		return SIZE_MAX;
+		return map_read_key_by_io(as, io, last);
 	}
 
-	size_t hash = *last;
-	*last = uni_scan_char(io);
-	while (utf8_is_letter(*last) || utf8_is_digit(*last))
+	const size_t begin = in_get_position(io);
+	size_t available = 0;
+	const char *const cursor = in_get_cursor(io, &available);
+
+	size_t end = begin + map_scan_word(cursor, available);
+	if (end != begin && end != begin + available)
 	{
-		if (map_add_key_symbol(as, *last))
+		in_skip(io, end - begin);
+		*last = uni_scan_char(io);
+	}
+	else
+	{
+		// Key is not loaded entirely, so it is scanned by characters
+		*last = uni_scan_char(io);
+		if (!utf8_is_letter(*last) && *last != '#')
 		{
-			return SIZE_MAX;
+			return map_key_broken();
 		}
 
-		hash += *last;
+		end = in_get_position(io);
 		*last = uni_scan_char(io);
+		while (utf8_is_letter(*last) || utf8_is_digit(*last))
+		{
+			end = in_get_position(io);
+			*last = uni_scan_char(io);
+		}
 	}
 
-	return hash % MAP_HASH_MAX;
+	const char *const slice = in_get_slice(io, begin, end - begin);
+	if (slice == NULL)
+	{
+		// Key is not in memory entirely, so it is read again into keys storage
+		in_set_position(io, begin);
+		return map_read_key_by_io(as, io, last);
+	}
+
+	return map_key_by_slice(slice, end - begin);
 }
 
 
-static inline int map_cmp_key(const map *const as, const size_t index)
+static inline bool map_cmp_key(const map *const as, const size_t index, const map_key *const key)
 {
-	return strcmp(&as->keys[as->values[index].ref], &as->keys[as->keys_size]);
+	if (as->values[index].hash != key->hash)
+	{
+		return false;
+	}
+
+	const char *const stored = &as->keys[as->values[index].ref];
+	if (key->string != NULL)
+	{
+		return strncmp(stored, key->string, key->size) == 0 && stored[key->size] == '\0';
+	}
+
+	size_t position = 0;
+	for (size_t i = 0; key->chars[i] != '\0'; i++)
+	{
+		char buffer[MAX_SYMBOL_SIZE];
+		const size_t size = utf8_to_string(buffer, key->chars[i]);
+		if (strncmp(&stored[position], buffer, size) != 0)
+		{
+			return false;
+		}
+
+		position += size;
+	}
+
+	return stored[position] == '\0';
 }
 
-static inline size_t map_get_index_by_hash(const map *const as, const size_t hash)
+/** Copy key with terminating zero after stored keys */
+static int map_copy_key(map *const as, const map_key *const key)
 {
-	if (hash == SIZE_MAX)
+	// Key read from io by characters is already in keys storage
+	if (key->string == &as->keys[as->keys_size])
 	{
-		return SIZE_MAX;
+		return 0;
+	}
+
+	size_t keys_alloc = as->keys_alloc;
+	while (keys_alloc < as->keys_size + key->size + MAX_SYMBOL_SIZE)
+	{
+		keys_alloc *= 2;
 	}
 
-	size_t index = hash;
-	while (as->values[index].next != SIZE_MAX)
+	if (keys_alloc != as->keys_alloc)
 	{
-		if (map_cmp_key(as, index) == 0)
+		char *keys_new = realloc(as->keys, keys_alloc * sizeof(char));
+		if (keys_new == NULL)
 		{
-			return index;
+			return -1;
 		}
-		index = as->values[index].next;
+
+		as->keys_alloc = keys_alloc;
+		as->keys = keys_new;
 	}
 
-	if (as->values[index].ref == SIZE_MAX || map_cmp_key(as, index) != 0)
+	if (key->string != NULL)
 	{
-		return SIZE_MAX;
+		memcpy(&as->keys[as->keys_size], key->string, key->size);
+	}
+	else
+	{
+		size_t position = as->keys_size;
+		for (size_t i = 0; key->chars[i] != '\0'; i++)
+		{
+			position += utf8_to_string(&as->keys[position], key->chars[i]);
+		}
 	}
 
-	return index;
+	as->keys[as->keys_size + key->size] = '\0';
+	return 0;
 }
 
-static size_t map_add_by_hash(map *const as, const size_t hash, const item_t value)
+static int map_store_key(map *const as, const map_key *const key)
 {
-	if (hash == SIZE_MAX)
+	if (map_copy_key(as, key))
 	{
-		return SIZE_MAX;
+		return -1;
+	}
+
+	as->keys_size += key->size + 1;
+	as->keys_next = as->keys_size;
+	return 0;
+}
+
+/** Remember key of lookup, it is copied to keys storage only by map_last_read */
+static inline void map_remember_key(map *const as, const map_key *const key)
+{
+	as->probe = key->string;
+	as->chars = key->chars;
+	as->probe_size = key->size;
+}
+
+
+static inline size_t map_find_slot(const map *const as, const map_key *const key)
+{
+	const size_t mask = as->table_alloc - 1;
+
+	size_t slot = key->hash & mask;
+	while (as->table[slot] != SIZE_MAX && !map_cmp_key(as, as->table[slot], key))
+	{
+		slot = (slot + 1) & mask;
 	}
 
-	size_t index = hash;
-	while (as->values[index].next != SIZE_MAX)
+	return slot;
+}
+
+static int map_rehash(map *const as)
+{
+	const size_t table_alloc = 2 * as->table_alloc;
+	size_t *table_new = malloc(table_alloc * sizeof(size_t));
+	if (table_new == NULL)
 	{
-		if (map_cmp_key(as, index) == 0)
+		return -1;
+	}
+
+	for (size_t i = 0; i < table_alloc; i++)
+	{
+		table_new[i] = SIZE_MAX;
+	}
+
+	for (size_t index = 0; index < as->values_size; index++)
+	{
+		size_t slot = as->values[index].hash & (table_alloc - 1);
+		while (table_new[slot] != SIZE_MAX)
 		{
-			return value == ITEM_MAX ? index : SIZE_MAX;
+			slot = (slot + 1) & (table_alloc - 1);
 		}
-		index = as->values[index].next;
+		table_new[slot] = index;
 	}
 
-	if (as->values[index].ref == SIZE_MAX)
+	free(as->table);
+	as->table = table_new;
+	as->table_alloc = table_alloc;
+	return 0;
+}
+
+static inline size_t map_get_index_by_key(map *const as, const map_key key)
+{
+	map_remember_key(as, &key);
+	as->last = key.hash == SIZE_MAX ? SIZE_MAX : as->table[map_find_slot(as, &key)];
+	return as->last;
+}
+
+static size_t map_add_by_key(map *const as, const map_key key, const item_t value)
+{
+	map_remember_key(as, &key);
+	as->last = SIZE_MAX;
+	if (key.hash == SIZE_MAX)
 	{
-		as->values[index].ref = as->keys_size;
-		as->keys_size = as->keys_next + 1;
-		as->values[index].value = value;
-		return index;
+		return SIZE_MAX;
 	}
-	else if (map_cmp_key(as, index) == 0)
+
+	size_t slot = map_find_slot(as, &key);
+	if (as->table[slot] != SIZE_MAX)
 	{
-		return value == ITEM_MAX ? index : SIZE_MAX;
+		as->last = as->table[slot];
+		return value == ITEM_MAX ? as->table[slot] : SIZE_MAX;
 	}
 
 	if (as->values_size == as->values_alloc)
@@ -209,19 +436,35 @@ static size_t map_add_by_hash(map *const as, const size_t hash, const item_t val
 		as->values = values_new;
 	}
 
-	as->values[index].next = as->values_size;
-	index = as->values_size++;
+	if ((as->values_size + 1) * MAP_LOAD_DENOMINATOR > as->table_alloc * MAP_LOAD_NUMERATOR)
+	{
+		if (map_rehash(as))
+		{
+			return SIZE_MAX;
+		}
 
-	as->values[index].next = SIZE_MAX;
-	as->values[index].ref = as->keys_size;
-	as->keys_size = as->keys_next + 1;
+		slot = map_find_slot(as, &key);
+	}
+
+	const size_t ref = as->keys_size;
+	if (map_store_key(as, &key))
+	{
+		return SIZE_MAX;
+	}
+
+	const size_t index = as->values_size++;
+	as->table[slot] = index;
+	as->last = index;
+
+	as->values[index].ref = ref;
+	as->values[index].hash = key.hash;
 	as->values[index].value = value;
 	return index;
 }
 
-static size_t map_set_by_hash(map *const as, const size_t hash, const item_t value)
+static size_t map_set_by_key(map *const as, const map_key key, const item_t value)
 {
-	const size_t index = map_get_index_by_hash(as, hash);
+	const size_t index = map_get_index_by_key(as, key);
 	if (index == SIZE_MAX)
 	{
 		return SIZE_MAX;
@@ -231,9 +474,9 @@ static size_t map_set_by_hash(map *const as, const size_t hash, const item_t val
 	return index;
 }
 
-static item_t map_get_by_hash(const map *const as, const size_t hash)
+static item_t map_get_by_key(map *const as, const map_key key)
 {
-	const size_t index = map_get_index_by_hash(as, hash);
+	const size_t index = map_get_index_by_key(as, key);
 	if (index == SIZE_MAX)
 	{
 		return ITEM_MAX;
@@ -248,6 +491,7 @@ static inline map map_broken()
 	map as;
 	as.values = NULL;
 	as.keys = NULL;
+	as.table = NULL;
 	return as;
 }
 
@@ -265,8 +509,12 @@ map map_create(const size_t alloc)
 {
 	map as;
 
-	as.values_size = MAP_HASH_MAX;
-	as.values_alloc = as.values_size + alloc;
+	as.last = SIZE_MAX;
+	as.probe = NULL;
+	as.chars = NULL;
+	as.probe_size = 0;
+	as.values_size = 0;
+	as.values_alloc = alloc != 0 ? alloc : 1;
 
 	as.values = malloc(as.values_alloc * sizeof(map_hash));
 	if (as.values == NULL)
@@ -274,19 +522,33 @@ map map_create(const size_t alloc)
 		return map_broken();
 	}
 
-	for (size_t i = 0; i < as.values_size; i++)
+	as.table_alloc = MAP_TABLE_SIZE;
+	while (as.table_alloc * MAP_LOAD_NUMERATOR < as.values_alloc * MAP_LOAD_DENOMINATOR)
 	{
-		as.values[i].next = SIZE_MAX;
-		as.values[i].ref = SIZE_MAX;
+		as.table_alloc *= 2;
+	}
+
+	as.table = malloc(as.table_alloc * sizeof(size_t));
+	if (as.table == NULL)
+	{
+		free(as.values);
+		return map_broken();
+	}
+
+	for (size_t i = 0; i < as.table_alloc; i++)
+	{
+		as.table[i] = SIZE_MAX;
 	}
 
 	as.keys_size = 0;
+	as.keys_next = 0;
 	as.keys_alloc = as.values_alloc * MAP_KEY_SIZE;
 
 	as.keys = malloc(as.keys_alloc * sizeof(char));
 	if (as.keys == NULL)
 	{
 		free(as.values);
+		free(as.table);
 		return map_broken();
 	}
 
@@ -296,54 +558,54 @@ map map_create(const size_t alloc)
 
 size_t map_reserve(map *const as, const char *const key)
 {
-	return map_add_by_hash(as, map_get_hash(as, key), ITEM_MAX);
+	return map_add_by_key(as, map_get_key(as, key), ITEM_MAX);
 }
 
 size_t map_reserve_by_utf8(map *const as, const char32_t *const key)
 {
-	return map_add_by_hash(as, map_get_hash_by_utf8(as, key), ITEM_MAX);
+	return map_add_by_key(as, map_get_key_by_utf8(as, key), ITEM_MAX);
 }
 
 size_t map_reserve_by_io(map *const as, universal_io *const io, char32_t *const last)
 {
-	return map_add_by_hash(as, map_get_hash_by_io(as, io, last), ITEM_MAX);
+	return map_add_by_key(as, map_get_key_by_io(as, io, last), ITEM_MAX);
 }
 
 
 size_t map_add(map *const as, const char *const key, const item_t value)
 {
-	return map_add_by_hash(as, map_get_hash(as, key), value);
+	return map_add_by_key(as, map_get_key(as, key), value);
 }
 
 size_t map_add_by_utf8(map *const as, const char32_t *const key, const item_t value)
 {
-	return map_add_by_hash(as, map_get_hash_by_utf8(as, key), value);
+	return map_add_by_key(as, map_get_key_by_utf8(as, key), value);
 }
 
 size_t map_add_by_io(map *const as, universal_io *const io, const item_t value, char32_t *const last)
 {
-	return map_add_by_hash(as, map_get_hash_by_io(as, io, last), value);
+	return map_add_by_key(as, map_get_key_by_io(as, io, last), value);
 }
 
 
 size_t map_set(map *const as, const char *const key, const item_t value)
 {
-	return map_set_by_hash(as, map_get_hash(as, key), value);
+	return map_set_by_key(as, map_get_key(as, key), value);
 }
 
 size_t map_set_by_utf8(map *const as, const char32_t *const key, const item_t value)
 {
-	return map_set_by_hash(as, map_get_hash_by_utf8(as, key), value);
+	return map_set_by_key(as, map_get_key_by_utf8(as, key), value);
 }
 
 size_t map_set_by_io(map *const as, universal_io *const io, const item_t value, char32_t *const last)
 {
-	return map_set_by_hash(as, map_get_hash_by_io(as, io, last), value);
+	return map_set_by_key(as, map_get_key_by_io(as, io, last), value);
 }
 
 int map_set_by_index(map *const as, const size_t index, const item_t value)
 {
-	if (!map_is_correct(as) || index >= as->values_size || as->values[index].ref == SIZE_MAX)
+	if (!map_is_correct(as) || index >= as->values_size)
 	{
 		return -1;
 	}
@@ -355,38 +617,38 @@ int map_set_by_index(map *const as, const size_t index, const item_t value)
 
 size_t map_get_index(map *const as, const char *const key)
 {
-	return map_get_index_by_hash(as, map_get_hash(as, key));
+	return map_get_index_by_key(as, map_get_key(as, key));
 }
 
 size_t map_get_index_by_utf8(map *const as, const char32_t *const key)
 {
-	return map_get_index_by_hash(as, map_get_hash_by_utf8(as, key));
+	return map_get_index_by_key(as, map_get_key_by_utf8(as, key));
 }
 
 size_t map_get_index_by_io(map *const as, universal_io *const io, char32_t *const last)
 {
-	return map_get_index_by_hash(as, map_get_hash_by_io(as, io, last));
+	return map_get_index_by_key(as, map_get_key_by_io(as, io, last));
 }
 
 
 item_t map_get(map *const as, const char *const key)
 {
-	return map_get_by_hash(as, map_get_hash(as, key));
+	return map_get_by_key(as, map_get_key(as, key));
 }
 
 item_t map_get_by_utf8(map *const as, const char32_t *const key)
 {
-	return map_get_by_hash(as, map_get_hash_by_utf8(as, key));
+	return map_get_by_key(as, map_get_key_by_utf8(as, key));
 }
 
 item_t map_get_by_io(map *const as, universal_io *const io, char32_t *const last)
 {
-	return map_get_by_hash(as, map_get_hash_by_io(as, io, last));
+	return map_get_by_key(as, map_get_key_by_io(as, io, last));
 }
 
 item_t map_get_by_index(const map *const as, const size_t index)
 {
-	return map_is_correct(as) && index < as->values_size && as->values[index].ref != SIZE_MAX
+	return map_is_correct(as) && index < as->values_size
 		? as->values[index].value
 		: ITEM_MAX;
 }
@@ -394,19 +656,39 @@ item_t map_get_by_index(const map *const as, const size_t index)
 
 const char *map_to_string(const map *const as, const size_t index)
 {
-	return map_is_correct(as) && index < as->values_size && as->values[index].ref != SIZE_MAX
+	return map_is_correct(as) && index < as->values_size
 		? &as->keys[as->values[index].ref]
 		: NULL;
 }
 
-const char *map_last_read(const map *const as)
+const char *map_last_read(map *const as)
 {
-	return map_is_correct(as) && as->keys_size < as->keys_next ? &as->keys[as->keys_size] : NULL;
+	if (!map_is_correct(as))
+	{
+		return NULL;
+	}
+
+	if (as->last != SIZE_MAX)
+	{
+		return &as->keys[as->values[as->last].ref];
+	}
+
+	if (as->probe == NULL && as->chars == NULL)
+	{
+		return NULL;
+	}
+
+	// Missed key is copied after the last stored key, so that it is terminated by zero
+	map_key key = map_key_broken();
+	key.string = as->probe;
+	key.chars = as->chars;
+	key.size = as->probe_size;
+	return map_copy_key(as, &key) ? NULL : &as->keys[as->keys_size];
 }
 
 bool map_is_correct(const map *const as)
 {
-	return as != NULL && as->values != NULL && as->keys != NULL;
+	return as != NULL && as->values != NULL && as->keys != NULL && as->table != NULL;
 }
 
 
@@ -423,5 +705,8 @@ int map_clear(map *const as)
 	free(as->keys);
 	as->keys = NULL;
 
+	free(as->table);
+	as->table = NULL;
+
 	return 0;
 }
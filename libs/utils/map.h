@@ -25,11 +25,11 @@
 extern "C" {
 #endif
 
-static const size_t MAP_HASH_MAX = 256;
+static const size_t MAP_TABLE_SIZE = 256;
 static const size_t MAP_KEY_SIZE = 8;
 
 
-/** Hash table */
+/** Record of hash table */
 typedef struct map_hash map_hash;
 
 /** Associative array (Dictionary) */
@@ -43,6 +43,14 @@ typedef struct map
 	map_hash *values;			/**< Values storage */
 	size_t values_size;			/**< Size of values storage */
 	size_t values_alloc;		/**< Allocated size of values storage */
+
+	size_t *table;				/**< Open addressing table of value indices */
+	size_t table_alloc;			/**< Allocated size of table, power of two */
+
+	size_t last;				/**< Index of the last found record */
+	const char *probe;			/**< Key of the last lookup as UTF-8 bytes */
+	const char32_t *chars;		/**< Key of the last lookup as characters, used when probe is not set */
+	size_t probe_size;			/**< Size of key of the last lookup in bytes */
 } map;
 
 
@@ -255,12 +263,14 @@ EXPORTED const char *map_to_string(const map *const as, const size_t index);
 
 /**
  *	Return the last read key
+ *	@note	Key of the found record is returned as is. Missed key is copied after stored keys on call,
+ *			so key read from io must be taken before the next reading of io.
  *
  *	@param	as				Map structure
  *
  *	@return	Key, @c NULL on failure
  */
-EXPORTED const char *map_last_read(const map *const as);
+EXPORTED const char *map_last_read(map *const as);
 
 /**
  *	Check that map is correct
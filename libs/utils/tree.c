@@ -17,20 +17,7 @@
 #include "tree.h"
 
 
-static inline bool is_negative(const item_t value)
-{
-	return value >> (8 * sizeof(item_t) - 1);
-}
-
-static inline item_t to_negative(const size_t value)
-{
-	return ~(item_t)value + 1;
-}
-
-static inline size_t from_negative(const item_t value)
-{
-	return (size_t)(~value + 1);
-}
+#define CHILDREN_SIZE 2
 
 
 static inline void vector_swap(vector *const vec, size_t fst, size_t snd)
@@ -41,7 +28,12 @@ static inline void vector_swap(vector *const vec, size_t fst, size_t snd)
 }
 
 
-static inline size_t ref_get_next(const node *const nd)
+static inline size_t ref_get_parent(const node *const nd)
+{
+	return nd->index - 3;
+}
+
+static inline size_t ref_get_number(const node *const nd)
 {
 	return nd->index - 2;
 }
@@ -62,9 +54,14 @@ static inline size_t ref_get_argc(const node *const nd)
 }
 
 
-static inline int ref_set_next(const node *const nd, const item_t value)
+static inline int ref_set_parent(const node *const nd, const item_t value)
 {
-	return vector_set(nd->tree, ref_get_next(nd), value);
+	return vector_set(nd->tree, ref_get_parent(nd), value);
+}
+
+static inline int ref_set_number(const node *const nd, const item_t value)
+{
+	return vector_set(nd->tree, ref_get_number(nd), value);
 }
 
 static inline int ref_set_amount(const node *const nd, const item_t value)
@@ -83,6 +80,62 @@ static inline int ref_set_argc(const node *const nd, const item_t value)
 }
 
 
+static inline size_t table_get_capacity(const node *const nd)
+{
+	const size_t table = (size_t)vector_get(nd->tree, ref_get_children(nd));
+	return table != 0 ? (size_t)vector_get(nd->tree, table) : 0;
+}
+
+static inline size_t table_get(const node *const nd, const size_t number)
+{
+	return (size_t)vector_get(nd->tree, (size_t)vector_get(nd->tree, ref_get_children(nd)) + 1 + number);
+}
+
+static inline int table_set(const node *const nd, const size_t number, const size_t index)
+{
+	return vector_set(nd->tree, (size_t)vector_get(nd->tree, ref_get_children(nd)) + 1 + number, (item_t)index);
+}
+
+/**
+ *	Reserve place for children references of node
+ *	@note	Children table is reallocated at the end of tree with double capacity, old one is left unused
+ *
+ *	@param	nd			Parent node
+ *	@param	size		Required amount of children
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+static int table_reserve(const node *const nd, const size_t size)
+{
+	const size_t capacity = table_get_capacity(nd);
+	if (size <= capacity)
+	{
+		return 0;
+	}
+
+	size_t capacity_new = capacity != 0 ? 2 * capacity : CHILDREN_SIZE;
+	while (capacity_new < size)
+	{
+		capacity_new *= 2;
+	}
+
+	const size_t amount = node_get_amount(nd);
+	const size_t table = vector_add(nd->tree, (item_t)capacity_new);
+	if (table == SIZE_MAX)
+	{
+		return -1;
+	}
+
+	for (size_t i = 0; i < amount; i++)
+	{
+		vector_add(nd->tree, (item_t)table_get(nd, i));
+	}
+
+	vector_increase(nd->tree, capacity_new - amount);
+	return ref_set_children(nd, (item_t)table);
+}
+
+
 static inline node node_broken()
 {
 	node nd = { NULL, SIZE_MAX };
@@ -97,20 +150,12 @@ static node node_search_parent(const node *const nd, size_t *const number)
 		return node_broken();
 	}
 
-	size_t child_number = 1;
-	item_t index = vector_get(nd->tree, ref_get_next(nd));
-	while (!is_negative(index) && index != 0)
-	{
-		index = vector_get(nd->tree, (size_t)index - 2);
-		child_number++;
-	}
-
-	node parent = { nd->tree, from_negative(index) };
 	if (number != NULL)
 	{
-		*number = node_get_amount(&parent) - child_number;
+		*number = (size_t)vector_get(nd->tree, ref_get_number(nd));
 	}
 
+	node parent = { nd->tree, (size_t)vector_get(nd->tree, ref_get_parent(nd)) };
 	return parent;
 }
 
@@ -147,13 +192,7 @@ node node_get_child(const node *const nd, const size_t index)
 		return node_broken();
 	}
 
-	size_t child_index = (size_t)vector_get(nd->tree, ref_get_children(nd));
-	for (size_t i = 0; i < index; i++)
-	{
-		child_index = (size_t)vector_get(nd->tree, child_index - 2);
-	}
-
-	node child = { nd->tree, child_index };
+	node child = { nd->tree, table_get(nd, index) };
 	return child;
 }
 
@@ -201,21 +240,26 @@ node node_get_next(const node *const nd)
 		return node_broken();
 	}
 
-	node next = { nd->tree, (size_t)vector_get(nd->tree, ref_get_children(nd)) };
+	if (node_get_amount(nd) != 0)
+	{
+		return node_get_child(nd, 0);
+	}
 
-	if (node_get_amount(nd) == 0)
+	node current = *nd;
+	while (current.index != 0)
 	{
-		item_t index = vector_get(nd->tree, ref_get_next(nd));
-		while (is_negative(index))
+		// Get next sibling of the nearest ancestor which has it
+		size_t number = 0;
+		const node parent = node_search_parent(&current, &number);
+		if (number + 1 < node_get_amount(&parent))
 		{
-			// Get next reference from parent
-			index = vector_get(nd->tree, from_negative(index) - 2);
+			return node_get_child(&parent, number + 1);
 		}
 
-		next.index = (size_t)index;
+		current = parent;
 	}
 
-	return next.index != 0 ? next : node_broken();
+	return node_broken();
 }
 
 int node_set_next(node *const nd)
@@ -238,24 +282,20 @@ node node_add_child(const node *const nd, const item_t type)
 		return node_broken();
 	}
 
-	vector_add(nd->tree, to_negative(nd->index));
+	const size_t amount = node_get_amount(nd);
+	if (table_reserve(nd, amount + 1))
+	{
+		return node_broken();
+	}
+
+	vector_add(nd->tree, (item_t)nd->index);
+	vector_add(nd->tree, (item_t)amount);
 	vector_add(nd->tree, type);
 	node child = { nd->tree, vector_add(nd->tree, 0) };
 	vector_increase(nd->tree, 2);
 
-	const size_t amount = node_get_amount(nd);
+	table_set(nd, amount, child.index);
 	ref_set_amount(nd, (item_t)(amount + 1));
-
-	if (amount == 0)
-	{
-		ref_set_children(nd, (item_t)child.index);
-	}
-	else
-	{
-		node prev = node_get_child(nd, amount - 1);
-		ref_set_next(&prev, (item_t)child.index);
-	}
-
 	return child;
 }
 
@@ -390,33 +430,32 @@ node node_load(vector *const tree, const size_t index)
 
 node node_insert(const node *const nd, const item_t type, const size_t argc)
 {
-	size_t index;
-	node parent = node_search_parent(nd, &index);
+	size_t number;
+	node parent = node_search_parent(nd, &number);
 	if (!node_is_correct(&parent))
 	{
 		return node_broken();
 	}
 
-	size_t reference;
-	if (index == 0)
-	{
-		reference = ref_get_children(&parent);
-	}
-	else
-	{
-		const node prev = node_get_child(&parent, index - 1);
-		reference = ref_get_next(&prev);
-	}
-
-	vector_add(nd->tree, vector_get(nd->tree, ref_get_next(nd)));
+	vector_add(nd->tree, (item_t)parent.index);
+	vector_add(nd->tree, (item_t)number);
 	vector_add(nd->tree, type);
-	node child = { nd->tree, vector_add(nd->tree, 1) };
-	vector_add(nd->tree, (item_t)nd->index);
+	node child = { nd->tree, vector_add(nd->tree, 0) };
+	vector_add(nd->tree, 0);
 	vector_add(nd->tree, (item_t)argc);
 	vector_increase(nd->tree, argc);
 
-	vector_set(nd->tree, reference, (item_t)child.index);
-	ref_set_next(nd, to_negative(child.index));
+	if (table_reserve(&child, 1))
+	{
+		return node_broken();
+	}
+
+	table_set(&child, 0, nd->index);
+	ref_set_amount(&child, 1);
+
+	table_set(&parent, number, child.index);
+	ref_set_parent(nd, (item_t)child.index);
+	ref_set_number(nd, 0);
 	return child;
 }
 
@@ -431,17 +470,17 @@ int node_order(const node *const fst, const node *const snd)
 	vector_swap(fst->tree, ref_get_children(fst), ref_get_children(snd));
 
 	const size_t fst_amount = node_get_amount(fst);
-	if (fst_amount != 0)
+	for (size_t i = 0; i < fst_amount; i++)
 	{
-		const node child = node_get_child(fst, fst_amount - 1);
-		ref_set_next(&child, to_negative(fst->index));
+		const node child = node_get_child(fst, i);
+		ref_set_parent(&child, (item_t)fst->index);
 	}
 
 	const size_t snd_amount = node_get_amount(snd);
-	if (snd_amount != 0)
+	for (size_t i = 0; i < snd_amount; i++)
 	{
-		const node child = node_get_child(snd, snd_amount - 1);
-		ref_set_next(&child, to_negative(snd->index));
+		const node child = node_get_child(snd, i);
+		ref_set_parent(&child, (item_t)snd->index);
 	}
 
 	return 0;
@@ -449,74 +488,47 @@ int node_order(const node *const fst, const node *const snd)
 
 int node_swap(const node *const fst, const node *const snd)
 {
-	size_t fst_index = 0;
-	const node fst_parent = node_search_parent(fst, &fst_index);
+	size_t fst_number = 0;
+	const node fst_parent = node_search_parent(fst, &fst_number);
 
-	size_t snd_index = 0;
-	const node snd_parent = node_search_parent(snd, &snd_index);
+	size_t snd_number = 0;
+	const node snd_parent = node_search_parent(snd, &snd_number);
 
 	if (!node_is_correct(&fst_parent) || !node_is_correct(&snd_parent) || fst->tree != snd->tree)
 	{
 		return -1;
 	}
 
-	vector *const tree = fst->tree;
-	if (fst_index == 0 && snd_index == 0)
-	{
-		vector_swap(tree, ref_get_children(&fst_parent), ref_get_children(&snd_parent));
-	}
-	else if (fst_index == 0)	// && snd_index != 0
-	{
-		const node snd_prev = node_get_child(&snd_parent, snd_index - 1);
-		vector_swap(tree, ref_get_children(&fst_parent), ref_get_next(&snd_prev));
-	}
-	else if (snd_index == 0)	// && fst_index != 0
-	{
-		const node fst_prev = node_get_child(&fst_parent, fst_index - 1);
-		vector_swap(tree, ref_get_next(&fst_prev), ref_get_children(&snd_parent));
-	}
-	else						// fst_index != 0 && snd_index != 0
-	{
-		const node fst_prev = node_get_child(&fst_parent, fst_index - 1);
-		const node snd_prev = node_get_child(&snd_parent, snd_index - 1);
-		vector_swap(tree, ref_get_next(&fst_prev), ref_get_next(&snd_prev));
-	}
+	table_set(&fst_parent, fst_number, snd->index);
+	table_set(&snd_parent, snd_number, fst->index);
 
-	vector_swap(tree, ref_get_next(fst), ref_get_next(snd));
+	vector_swap(fst->tree, ref_get_parent(fst), ref_get_parent(snd));
+	vector_swap(fst->tree, ref_get_number(fst), ref_get_number(snd));
 	return 0;
 }
 
 int node_remove(node *const nd)
 {
-	size_t index;
-	node parent = node_search_parent(nd, &index);
+	size_t number;
+	node parent = node_search_parent(nd, &number);
 	if (!node_is_correct(&parent))
 	{
 		return -1;
 	}
 
-	if (index == 0)
+	const size_t amount = node_get_amount(&parent);
+	for (size_t i = number + 1; i < amount; i++)
 	{
-		ref_set_amount(&parent, (item_t)node_get_amount(&parent) - 1);
-
-		if (node_get_amount(&parent) != 0)
-		{
-			ref_set_children(&parent, vector_get(nd->tree, ref_get_next(nd)));
-		}
+		const node child = node_get_child(&parent, i);
+		table_set(&parent, i - 1, child.index);
+		ref_set_number(&child, (item_t)(i - 1));
 	}
-	else
-	{
-		*nd = node_get_child(&parent, index - 1);
-		const size_t reference = (size_t)vector_get(nd->tree, ref_get_next(nd));
-		ref_set_next(nd, vector_get(nd->tree, reference - 2));
 
-		nd->index = reference;
-		ref_set_amount(&parent, (item_t)node_get_amount(&parent) - 1);
-	}
+	ref_set_amount(&parent, (item_t)(amount - 1));
 
 	if (node_get_amount(nd) == 0 && (ref_get_argc(nd) + node_get_argc(nd)) == vector_size(nd->tree) - 1)
 	{
-		vector_resize(nd->tree, ref_get_next(nd));
+		vector_resize(nd->tree, ref_get_parent(nd));
 	}
 
 	*nd = node_broken();
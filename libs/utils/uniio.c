@@ -26,13 +26,22 @@
 	extern intptr_t _get_osfhandle(int fd);
 #elif __APPLE__
 	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
 #else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
 	#include <unistd.h>
 
 	#define MAX_LINK_SIZE 20
 #endif
 
 #define MAX_FORMAT_SIZE 128
+#define MAX_CHAR_SIZE 4
+
+#define IN_BLOCK_SIZE 65536
+#define IN_BLOCK_LOOKBEHIND 4096
+#define OUT_BLOCK_SIZE 65536
 
 
 static inline bool is_specifier(const char ch)
@@ -139,6 +148,12 @@ static inline int in_func_position(universal_io *const io, const char *const for
 
 static int in_func_file(universal_io *const io, const char *const format, va_list args)
 {
+	if (io->in_block != NULL)
+	{
+		// Reading from block buffer does not move file position
+		fseek(io->in_file, (long)io->in_position, SEEK_SET);
+	}
+
 	return in_func_position(io, format, args, &scan_file_arg);
 }
 
@@ -147,6 +162,14 @@ static int in_func_buffer(universal_io *const io, const char *const format, va_l
 	return in_func_position(io, format, args, &scan_buffer_arg);
 }
 
+static int in_func_channel(universal_io *const io, const char *const format, va_list args)
+{
+	(void)io;
+	(void)format;
+	(void)args;
+	return 0;
+}
+
 static int in_func_user(universal_io *const io, const char *const format, va_list args)
 {
 	return io->in_user_func(format, args);
@@ -155,6 +178,31 @@ static int in_func_user(universal_io *const io, const char *const format, va_lis
 
 static int out_func_file(universal_io *const io, const char *const format, va_list args)
 {
+	va_list local;
+	va_copy(local, args);
+
+	const size_t free_size = OUT_BLOCK_SIZE - io->out_block_size;
+	const int ret = vsnprintf(&io->out_block[io->out_block_size], free_size, format, local);
+	va_end(local);
+
+	if (ret < 0 || (size_t)ret < free_size)
+	{
+		io->out_block_size += ret > 0 ? (size_t)ret : 0;
+		return ret;
+	}
+
+	// Fragment does not fit into rest of block buffer
+	if (out_flush(io))
+	{
+		return -1;
+	}
+
+	if ((size_t)ret < OUT_BLOCK_SIZE)
+	{
+		io->out_block_size = (size_t)vsnprintf(io->out_block, OUT_BLOCK_SIZE, format, args);
+		return ret;
+	}
+
 	return vfprintf(io->out_file, format, args);
 }
 
@@ -184,12 +232,195 @@ static int out_func_buffer(universal_io *const io, const char *const format, va_
 	return out_func_buffer(io, format, args);
 }
 
+static int out_func_channel(universal_io *const io, const char *const format, va_list args)
+{
+	va_list local;
+	va_copy(local, args);
+
+	char buffer[MAX_FORMAT_SIZE];
+	const int ret = vsnprintf(buffer, MAX_FORMAT_SIZE, format, local);
+	va_end(local);
+
+	if (ret < 0)
+	{
+		return ret;
+	}
+
+	if ((size_t)ret < MAX_FORMAT_SIZE)
+	{
+		return channel_write(io->out_channel, buffer, (size_t)ret) ? -1 : ret;
+	}
+
+	// Fragment does not fit into local buffer
+	char *const fragment = malloc(((size_t)ret + 1) * sizeof(char));
+	if (fragment == NULL)
+	{
+		return -1;
+	}
+
+	vsnprintf(fragment, (size_t)ret + 1, format, args);
+	const int ret_write = channel_write(io->out_channel, fragment, (size_t)ret);
+	free(fragment);
+	return ret_write ? -1 : ret;
+}
+
 static int out_func_user(universal_io *const io, const char *const format, va_list args)
 {
 	return io->out_user_func(format, args);
 }
 
 
+static int out_write_buffer(universal_io *const io, const char *const data, const size_t size)
+{
+	if (io->out_position + size >= io->out_size)
+	{
+		const size_t size_new = io->out_position + size + 1 > 2 * io->out_size
+			? io->out_position + size + 1
+			: 2 * io->out_size;
+
+		char *buffer_new = realloc(io->out_buffer, size_new * sizeof(char));
+		if (buffer_new == NULL)
+		{
+			return -1;
+		}
+
+		io->out_size = size_new;
+		io->out_buffer = buffer_new;
+	}
+
+	memcpy(&io->out_buffer[io->out_position], data, size);
+	io->out_position += size;
+	io->out_buffer[io->out_position] = '\0';
+	return 0;
+}
+
+static int out_write_file(universal_io *const io, const char *const data, const size_t size)
+{
+	if (io->out_block_size + size > OUT_BLOCK_SIZE && out_flush(io))
+	{
+		return -1;
+	}
+
+	if (size >= OUT_BLOCK_SIZE)
+	{
+		return fwrite(data, sizeof(char), size, io->out_file) == size ? 0 : -1;
+	}
+
+	memcpy(&io->out_block[io->out_block_size], data, size);
+	io->out_block_size += size;
+	return 0;
+}
+
+
+static int in_fill_block(universal_io *const io)
+{
+	if (io->in_block == NULL)
+	{
+		io->in_block = malloc(IN_BLOCK_SIZE * sizeof(char));
+		if (io->in_block == NULL)
+		{
+			return -1;
+		}
+	}
+
+	io->in_block_begin = io->in_position;
+	io->in_block_size = 0;
+
+	if (in_is_channel(io))
+	{
+		// Recent text is kept in block, so that it is not read again for slices and returns
+		io->in_block_begin -= io->in_position > IN_BLOCK_LOOKBEHIND ? IN_BLOCK_LOOKBEHIND : io->in_position;
+		io->in_block_size = channel_read(io->in_channel, io->in_block_begin, io->in_block, IN_BLOCK_SIZE);
+		if (io->in_block_begin + io->in_block_size < io->in_position)
+		{
+			// Failed channel is read as ended at current position
+			io->in_block_begin = io->in_position;
+			io->in_block_size = 0;
+		}
+
+		return 0;
+	}
+
+	if (fseek(io->in_file, (long)io->in_position, SEEK_SET))
+	{
+		return -1;
+	}
+
+	io->in_block_size = fread(io->in_block, sizeof(char), IN_BLOCK_SIZE, io->in_file);
+	return 0;
+}
+
+static void in_map_file(universal_io *const io)
+{
+#ifndef _WIN32
+	struct stat stat_buf;
+	if (fstat(fileno(io->in_file), &stat_buf) || stat_buf.st_size <= 0)
+	{
+		return;
+	}
+
+	void *const map = mmap(NULL, (size_t)stat_buf.st_size, PROT_READ, MAP_PRIVATE, fileno(io->in_file), 0);
+	if (map == MAP_FAILED)
+	{
+		return;
+	}
+
+	io->in_block = map;
+	io->in_block_begin = 0;
+	io->in_block_size = (size_t)stat_buf.st_size;
+	io->in_block_mapped = true;
+#else
+	(void)io;
+#endif
+}
+
+static void in_free_block(universal_io *const io)
+{
+#ifndef _WIN32
+	if (io->in_block_mapped)
+	{
+		munmap(io->in_block, io->in_block_size);
+	}
+	else
+#endif
+	{
+		free(io->in_block);
+	}
+
+	io->in_block = NULL;
+	io->in_block_begin = 0;
+	io->in_block_size = 0;
+	io->in_block_mapped = false;
+}
+
+static char32_t in_decode_char(universal_io *const io, size_t *const size)
+{
+	size_t available = 0;
+	const char *const cursor = in_get_cursor(io, &available);
+
+	*size = 0;
+	if (cursor == NULL || available == 0)
+	{
+		return (char32_t)EOF;
+	}
+
+	if ((cursor[0] & 0x80) == 0)
+	{
+		*size = 1;
+		return (char32_t)cursor[0];
+	}
+
+	*size = utf8_symbol_size(cursor[0]);
+	if (*size > available)
+	{
+		*size = available;
+		return (char32_t)EOF;
+	}
+
+	return utf8_convert(cursor);
+}
+
+
 static inline size_t io_get_path(FILE *const file, char *const buffer)
 {
 #ifdef _WIN32
@@ -238,19 +469,29 @@ universal_io io_create(void)
 
 	io.in_file = NULL;
 	io.in_buffer = NULL;
+	io.in_channel = NULL;
 
 	io.in_size = 0;
 	io.in_position = 0;
 
+	io.in_block = NULL;
+	io.in_block_begin = 0;
+	io.in_block_size = 0;
+	io.in_block_mapped = false;
+
 	io.in_user_func = NULL;
 	io.in_func = NULL;
 
 	io.out_file = NULL;
 	io.out_buffer = NULL;
+	io.out_channel = NULL;
 
 	io.out_size = 0;
 	io.out_position = 0;
 
+	io.out_block = NULL;
+	io.out_block_size = 0;
+
 	io.out_user_func = NULL;
 	io.out_func = NULL;
 
@@ -272,6 +513,7 @@ int in_set_file(universal_io *const io, const char *const path)
 	}
 
 	io->in_position = 0;
+	in_map_file(io);
 
 	io->in_func = &in_func_file;
 
@@ -295,6 +537,21 @@ int in_set_buffer(universal_io *const io, const char *const buffer)
 	return 0;
 }
 
+int in_set_channel(universal_io *const io, channel *const ch)
+{
+	if (ch == NULL || in_clear(io))
+	{
+		return -1;
+	}
+
+	io->in_channel = ch;
+	io->in_position = 0;
+
+	io->in_func = &in_func_channel;
+
+	return 0;
+}
+
 int in_set_func(universal_io *const io, const io_user_func func)
 {
 	if (in_clear(io))
@@ -312,7 +569,7 @@ int in_set_position(universal_io *const io, const size_t position)
 {
 	if (in_is_buffer(io))
 	{
-		if (position < io->in_size)
+		if (position <= io->in_size)
 		{
 			io->in_position = position;
 			return 0;
@@ -323,6 +580,13 @@ int in_set_position(universal_io *const io, const size_t position)
 
 	if (in_is_file(io))
 	{
+		if (io->in_block != NULL && position >= io->in_block_begin
+			&& position <= io->in_block_begin + io->in_block_size)
+		{
+			io->in_position = position;
+			return 0;
+		}
+
 		if ((position == 0 && fseek(io->in_file, 0, SEEK_SET) == 0)
 			|| (fseek(io->in_file, (long)(position - 1), SEEK_SET) == 0 && fgetc(io->in_file) != EOF))
 		{
@@ -334,13 +598,25 @@ int in_set_position(universal_io *const io, const size_t position)
 		return -1;
 	}
 
+	if (in_is_channel(io))
+	{
+		if ((io->in_block != NULL && position <= io->in_block_begin + io->in_block_size)
+			|| position <= channel_await(io->in_channel, position))
+		{
+			io->in_position = position;
+			return 0;
+		}
+
+		return -1;
+	}
+
 	return -1;
 }
 
 
 bool in_is_correct(const universal_io *const io)
 {
-	return io != NULL && (in_is_file(io) || in_is_buffer(io) || in_is_func(io));
+	return io != NULL && (in_is_file(io) || in_is_buffer(io) || in_is_func(io) || in_is_channel(io));
 }
 
 bool in_is_file(const universal_io *const io)
@@ -358,6 +634,11 @@ bool in_is_func(const universal_io *const io)
 	return io != NULL && io->in_user_func != NULL;
 }
 
+bool in_is_channel(const universal_io *const io)
+{
+	return io != NULL && io->in_channel != NULL;
+}
+
 
 io_func in_get_func(const universal_io *const io)
 {
@@ -371,12 +652,94 @@ size_t in_get_path(const universal_io *const io, char *const buffer)
 
 const char *in_get_buffer(const universal_io *const io)
 {
+	if (in_is_channel(io))
+	{
+		return channel_get_text(io->in_channel);
+	}
+
 	return in_is_buffer(io) ? io->in_buffer : NULL;
 }
 
 size_t in_get_position(const universal_io *const io)
 {
-	return in_is_buffer(io) || in_is_file(io) ? io->in_position : 0;
+	return in_is_buffer(io) || in_is_file(io) || in_is_channel(io) ? io->in_position : 0;
+}
+
+
+char32_t in_get_char(universal_io *const io)
+{
+	size_t size = 0;
+	const char32_t character = in_decode_char(io, &size);
+
+	if (size != 0)
+	{
+		io->in_position += size;
+	}
+
+	return character;
+}
+
+char32_t in_peek_char(universal_io *const io)
+{
+	size_t size = 0;
+	return in_decode_char(io, &size);
+}
+
+const char *in_get_cursor(universal_io *const io, size_t *const available)
+{
+	if (in_is_buffer(io))
+	{
+		*available = io->in_size - io->in_position;
+		return &io->in_buffer[io->in_position];
+	}
+
+	*available = 0;
+	if (!in_is_file(io) && !in_is_channel(io))
+	{
+		return NULL;
+	}
+
+	// Refill block if current character may not fit in it
+	const size_t block_end = io->in_block_begin + io->in_block_size;
+	if (!io->in_block_mapped && (io->in_block == NULL || io->in_position < io->in_block_begin || io->in_position > block_end
+		|| (io->in_position + MAX_CHAR_SIZE > block_end && io->in_block_size == IN_BLOCK_SIZE)))
+	{
+		if (in_fill_block(io))
+		{
+			return NULL;
+		}
+	}
+
+	*available = io->in_block_begin + io->in_block_size - io->in_position;
+	return &io->in_block[io->in_position - io->in_block_begin];
+}
+
+int in_skip(universal_io *const io, const size_t size)
+{
+	size_t available = 0;
+	if (in_get_cursor(io, &available) == NULL || size > available)
+	{
+		return -1;
+	}
+
+	io->in_position += size;
+	return 0;
+}
+
+const char *in_get_slice(const universal_io *const io, const size_t position, const size_t size)
+{
+	if (in_is_buffer(io))
+	{
+		return position + size <= io->in_size ? &io->in_buffer[position] : NULL;
+	}
+
+	if ((in_is_file(io) || in_is_channel(io)) && io->in_block != NULL && position >= io->in_block_begin
+		&& position + size <= io->in_block_begin + io->in_block_size)
+	{
+		return &io->in_block[position - io->in_block_begin];
+	}
+
+	return NULL;
 }
 
 
@@ -390,6 +753,7 @@ int in_close_file(universal_io *const io)
 	int ret = fclose(io->in_file);
 	io->in_file = NULL;
 
+	in_free_block(io);
 	io->in_position = 0;
 
 	return ret;
@@ -413,6 +777,12 @@ int in_clear(universal_io *const io)
 		io->in_size = 0;
 		io->in_position = 0;
 	}
+	else if (in_is_channel(io))
+	{
+		io->in_channel = NULL;
+		in_free_block(io);
+		io->in_position = 0;
+	}
 	else
 	{
 		io->in_user_func = NULL;
@@ -436,6 +806,16 @@ int out_set_file(universal_io *const io, const char *const path)
 		return -1;
 	}
 
+	io->out_block = malloc(OUT_BLOCK_SIZE * sizeof(char));
+	if (io->out_block == NULL)
+	{
+		fclose(io->out_file);
+		io->out_file = NULL;
+		return -1;
+	}
+
+	io->out_block_size = 0;
+
 	io->out_func = &out_func_file;
 
 	return 0;
@@ -465,6 +845,20 @@ int out_set_buffer(universal_io *const io, const size_t size)
 	return 0;
 }
 
+int out_set_channel(universal_io *const io, channel *const ch)
+{
+	if (ch == NULL || out_clear(io))
+	{
+		return -1;
+	}
+
+	io->out_channel = ch;
+
+	io->out_func = &out_func_channel;
+
+	return 0;
+}
+
 int out_set_func(universal_io *const io, const io_user_func func)
 {
 	if (out_clear(io))
@@ -481,7 +875,7 @@ int out_set_func(universal_io *const io, const io_user_func func)
 
 bool out_is_correct(const universal_io *const io)
 {
-	return io != NULL && (out_is_file(io) || out_is_buffer(io) || out_is_func(io));;
+	return io != NULL && (out_is_file(io) || out_is_buffer(io) || out_is_func(io) || out_is_channel(io));
 }
 
 bool out_is_file(const universal_io *const io)
@@ -499,6 +893,11 @@ bool out_is_func(const universal_io *const io)
 	return io != NULL && io->out_user_func != NULL;
 }
 
+bool out_is_channel(const universal_io *const io)
+{
+	return io != NULL && io->out_channel != NULL;
+}
+
 
 io_func out_get_func(const universal_io *const io)
 {
@@ -515,6 +914,55 @@ size_t out_get_path(const universal_io *const io, char *const buffer)
 	return io_get_path(io->out_file, buffer);
 }
 
+size_t out_get_position(const universal_io *const io)
+{
+	if (out_is_channel(io))
+	{
+		return channel_get_written(io->out_channel);
+	}
+
+	return out_is_buffer(io) ? io->out_position : 0;
+}
+
+
+int out_write(universal_io *const io, const char *const data, const size_t size)
+{
+	if (data == NULL)
+	{
+		return -1;
+	}
+
+	if (out_is_file(io))
+	{
+		return out_write_file(io, data, size);
+	}
+
+	if (out_is_buffer(io))
+	{
+		return out_write_buffer(io, data, size);
+	}
+
+	if (out_is_channel(io))
+	{
+		return channel_write(io->out_channel, data, size);
+	}
+
+	return -1;
+}
+
+int out_flush(universal_io *const io)
+{
+	if (!out_is_file(io))
+	{
+		return -1;
+	}
+
+	const size_t size = io->out_block_size;
+	io->out_block_size = 0;
+
+	return fwrite(io->out_block, sizeof(char), size, io->out_file) == size ? 0 : -1;
+}
+
 
 char *out_extract_buffer(universal_io *const io)
 {
@@ -540,10 +988,14 @@ int out_close_file(universal_io *const io)
 		return -1;
 	}
 
-	int ret = fclose(io->out_file);
+	const int ret = out_flush(io);
+	const int ret_close = fclose(io->out_file);
 	io->out_file = NULL;
 
-	return ret;
+	free(io->out_block);
+	io->out_block = NULL;
+
+	return ret || ret_close ? -1 : 0;
 }
 
 int out_clear(universal_io *const io)
@@ -561,6 +1013,10 @@ int out_clear(universal_io *const io)
 	{
 		free(out_extract_buffer(io));
 	}
+	else if (out_is_channel(io))
+	{
+		io->out_channel = NULL;
+	}
 	else
 	{
 		io->out_user_func = NULL;
@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
+#include "channel.h"
 #include "dll.h"
 #include "utf8.h"
 
@@ -58,19 +59,29 @@ struct universal_io
 {
 	FILE *in_file;				/**< Input file */
 	const char *in_buffer;		/**< Input buffer */
+	channel *in_channel;		/**< Input channel */
 
 	size_t in_size;				/**< Size of input buffer */
 	size_t in_position;			/**< Current position of input buffer */
 
+	char *in_block;				/**< Block buffer for file and channel input */
+	size_t in_block_begin;		/**< Input position of block buffer */
+	size_t in_block_size;		/**< Number of bytes in block buffer */
+	bool in_block_mapped;		/**< Set, if block buffer is the whole memory-mapped file */
+
 	io_user_func in_user_func;	/**< Input user function */
 	io_func in_func;			/**< Current input function */
 
 	FILE *out_file;				/**< Output file */
 	char *out_buffer;			/**< Output buffer */
+	channel *out_channel;		/**< Output channel */
 
 	size_t out_size;			/**< Size of output buffer */
 	size_t out_position;		/**< Current position of output buffer */
 
+	char *out_block;			/**< Block buffer for file output */
+	size_t out_block_size;		/**< Number of bytes in block buffer */
+
 	io_user_func out_user_func;	/**< Output user function */
 	io_func out_func;			/**< Current output function */
 };
@@ -86,6 +97,7 @@ EXPORTED universal_io io_create(void);
 
 /**
  *	Set input file
+ *	@note	File is memory-mapped when possible, otherwise it is read by blocks
  *
  *	@param	io			Universal io structure
  *	@param	path		Input file path
@@ -104,6 +116,17 @@ EXPORTED int in_set_file(universal_io *const io, const char *const path);
  */
 EXPORTED int in_set_buffer(universal_io *const io, const char *const buffer);
 
+/**
+ *	Set input channel
+ *	@note	Channel is read by blocks, formatted input is not available
+ *
+ *	@param	io			Universal io structure
+ *	@param	ch			Input channel
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int in_set_channel(universal_io *const io, channel *const ch);
+
 /**
  *	Set input function
  *
@@ -161,6 +184,15 @@ EXPORTED bool in_is_buffer(const universal_io *const io);
  */
 EXPORTED bool in_is_func(const universal_io *const io);
 
+/**
+ *	Check that current input option is channel
+ *
+ *	@param	io			Universal io structure
+ *
+ *	@return	@c 1 on true, @c 0 on false
+ */
+EXPORTED bool in_is_channel(const universal_io *const io);
+
 
 /**
  *	Get input func from universal io structure
@@ -183,10 +215,11 @@ EXPORTED size_t in_get_path(const universal_io *const io, char *const buffer);
 
 /**
  *	Get input buffer from universal io structure
+ *	@note	Whole text of input channel is waited for
  *
  *	@param	io			Universal io structure
  *
- *	@return	Input buffer
+ *	@return	Input buffer, @c NULL if input channel is failed
  */
 EXPORTED const char *in_get_buffer(const universal_io *const io);
 
@@ -200,6 +233,60 @@ EXPORTED const char *in_get_buffer(const universal_io *const io);
 EXPORTED size_t in_get_position(const universal_io *const io);
 
 
+/**
+ *	Read next UTF-8 character and move input position after it
+ *	@note	Works directly with file and buffer input without format parsing
+ *
+ *	@param	io			Universal io structure
+ *
+ *	@return	UTF-8 character, @c EOF on end of input or on function input
+ */
+EXPORTED char32_t in_get_char(universal_io *const io);
+
+/**
+ *	Read next UTF-8 character without moving input position
+ *	@note	Works directly with file and buffer input without format parsing
+ *
+ *	@param	io			Universal io structure
+ *
+ *	@return	UTF-8 character, @c EOF on end of input or on function input
+ */
+EXPORTED char32_t in_peek_char(universal_io *const io);
+
+/**
+ *	Get loaded input bytes from current position without copying
+ *	@note	Block of file input is refilled, if current position is not in it
+ *
+ *	@param	io			Universal io structure
+ *	@param	available	Number of loaded bytes from current position
+ *
+ *	@return	Pointer to current input byte, @c NULL on function input
+ */
+EXPORTED const char *in_get_cursor(universal_io *const io, size_t *const available);
+
+/**
+ *	Move input position over loaded bytes
+ *
+ *	@param	io			Universal io structure
+ *	@param	size		Number of bytes
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int in_skip(universal_io *const io, const size_t size);
+
+/**
+ *	Get already loaded input bytes without copying
+ *	@note	Available for buffer input and for file and channel input within current block
+ *
+ *	@param	io			Universal io structure
+ *	@param	position	Input position of first byte
+ *	@param	size		Number of bytes
+ *
+ *	@return	Pointer to input bytes, @c NULL if they are not in memory
+ */
+EXPORTED const char *in_get_slice(const universal_io *const io, const size_t position, const size_t size);
+
+
 /**
  *	Close input file
  *
@@ -221,6 +308,7 @@ EXPORTED int in_clear(universal_io *const io);
 
 /**
  *	Set output file
+ *	@note	Output is collected in block buffer, which is flushed on closing file
  *
  *	@param	io			Universal io structure
  *	@param	path		Output file path
@@ -239,6 +327,16 @@ EXPORTED int out_set_file(universal_io *const io, const char *const path);
  */
 EXPORTED int out_set_buffer(universal_io *const io, const size_t size);
 
+/**
+ *	Set output channel
+ *
+ *	@param	io			Universal io structure
+ *	@param	ch			Output channel
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int out_set_channel(universal_io *const io, channel *const ch);
+
 /**
  *	Set output function
  *
@@ -286,6 +384,15 @@ EXPORTED bool out_is_buffer(const universal_io *const io);
  */
 EXPORTED bool out_is_func(const universal_io *const io);
 
+/**
+ *	Check that current output option is channel
+ *
+ *	@param	io			Universal io structure
+ *
+ *	@return	@c 1 on true, @c 0 on false
+ */
+EXPORTED bool out_is_channel(const universal_io *const io);
+
 
 /**
  *	Get output function from universal io structure
@@ -307,6 +414,38 @@ EXPORTED io_func out_get_func(const universal_io *const io);
 EXPORTED size_t out_get_path(const universal_io *const io, char *const buffer);
 
 
+/**
+ *	Get output position from universal io structure
+ *
+ *	@param	io			Universal io structure
+ *
+ *	@return	Number of bytes in output buffer or channel, @c 0 on other output
+ */
+EXPORTED size_t out_get_position(const universal_io *const io);
+
+
+/**
+ *	Write bytes to output without formatting
+ *	@note	Works directly with file, buffer and channel output
+ *
+ *	@param	io			Universal io structure
+ *	@param	data		Bytes to write
+ *	@param	size		Number of bytes
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int out_write(universal_io *const io, const char *const data, const size_t size);
+
+/**
+ *	Write block buffer to output file
+ *
+ *	@param	io			Universal io structure
+ *
+ *	@return	@c 0 on success, @c -1 on failure
+ */
+EXPORTED int out_flush(universal_io *const io);
+
+
 /**
  *	Extract output buffer from universal io structure
  *
@@ -16,9 +16,36 @@
 
 #include "uniprinter.h"
 #include <stdarg.h>
+#include <string.h>
 #include "utf8.h"
 
 
+#define MAX_NUMBER_SIZE 24
+
+
+static inline int uni_print_bytes(universal_io *const io, const char *const data, const size_t size)
+{
+	if (out_is_func(io))
+	{
+		return uni_printf(io, "%.*s", (int)size, data);
+	}
+
+	return out_write(io, data, size) ? -1 : (int)size;
+}
+
+static inline size_t digits_to_string(char *const buffer, uint64_t value)
+{
+	size_t i = MAX_NUMBER_SIZE;
+	do
+	{
+		buffer[--i] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	return i;
+}
+
+
 int uni_printf(universal_io *const io, const char *const format, ...)
 {
 	if (!out_is_correct(io))
@@ -45,5 +72,30 @@ int uni_print_char(universal_io *const io, const char32_t wchar)
 		return 0;
 	}
 
-	return uni_printf(io, "%s", buffer);
+	return uni_print_bytes(io, buffer, utf8_size(wchar));
+}
+
+int uni_print_string(universal_io *const io, const char *const str)
+{
+	return str != NULL ? uni_print_bytes(io, str, strlen(str)) : -1;
+}
+
+int uni_print_int(universal_io *const io, const int64_t value)
+{
+	char buffer[MAX_NUMBER_SIZE];
+	size_t first = digits_to_string(buffer, value < 0 ? ~(uint64_t)value + 1 : (uint64_t)value);
+
+	if (value < 0)
+	{
+		buffer[--first] = '-';
+	}
+
+	return uni_print_bytes(io, &buffer[first], MAX_NUMBER_SIZE - first);
+}
+
+int uni_print_uint(universal_io *const io, const uint64_t value)
+{
+	char buffer[MAX_NUMBER_SIZE];
+	const size_t first = digits_to_string(buffer, value);
+	return uni_print_bytes(io, &buffer[first], MAX_NUMBER_SIZE - first);
 }
@@ -38,6 +38,11 @@ int uni_scanf(universal_io *const io, const char *const format, ...)
 
 char32_t uni_scan_char(universal_io *const io)
 {
+	if (in_is_buffer(io) || in_is_file(io) || in_is_channel(io))
+	{
+		return in_get_char(io);
+	}
+
 	char buffer[MAX_SYMBOL_SIZE];
 	if (!uni_scanf(io, "%c", &buffer[0]))
 	{
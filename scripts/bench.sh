@@ -0,0 +1,410 @@
+#!/bin/bash
+
+init()
+{
+	dir_build=build
+	dir_bench=bench
+
+	benchmarks=
+
+	while ! [[ -z $1 ]]
+	do
+		case $1 in
+			-h|--help)
+				echo -e "Usage: ./${0##*/} [KEY] ... [BENCHMARK] ..."
+				echo -e "Description:"
+				echo -e "\tThis script builds Release version and runs performance benchmarks."
+				echo -e "\tGenerated inputs are placed in \"$dir_build/$dir_bench\" directory."
+				echo -e "Benchmarks:"
+				echo -e "\thash\t\tLookup cost of integer-keyed hash table from 1k to 1M keys."
+				echo -e "\ttree\t\tCompiling of 1M-statement block and 1M-element initializer."
+				echo -e "\tlexer\t\tLexing speed in tokens per second with lookahead and for whole input."
+				echo -e "\tfloat\t\tCompiling of 1M-literal double initializer."
+				echo -e "\tmacro\t\tPreprocessing of 20k macro definitions with 100k lines using them,\n\t\t\tof 1M macro-free lines without and with a definition, of 20k disabled conditional blocks,\n\t\t\tof 20k iterations of nested #while loops\n\t\t\tand of 100 headers including each other through 4 directories."
+				echo -e "\tcompile\t\tCompiling of 8 independent files with sequential and parallel preprocessing,\n\t\t\tof 4k functions using 20k macros with cold and warm preprocessing cache\n\t\t\tand with preprocessing concurrent to parsing."
+				echo -e "Keys:"
+				echo -e "\t-h, --help\tTo output help info."
+				echo -e "\t-r, --remove\tRemove build folder before benchmarking."
+				exit 0
+				;;
+			-r|--remove)
+				remove=$1
+				;;
+			*)
+				benchmarks="$benchmarks $1"
+				;;
+		esac
+		shift
+	done
+
+	if [[ -z $benchmarks ]] ; then
+		benchmarks="hash tree lexer float macro compile"
+	fi
+}
+
+build()
+{
+	cd `dirname $0`/..
+
+	if ! [[ -z $remove ]] ; then
+		rm -rf $dir_build
+	fi
+	mkdir -p $dir_build && cd $dir_build
+
+	cmake .. -DCMAKE_BUILD_TYPE=Release > /dev/null
+	if ! cmake --build . --config Release > /dev/null ; then
+		exit 1
+	fi
+
+	mkdir -p $dir_bench
+}
+
+bench_hash()
+{
+	cat > $dir_bench/hash.c << EOF
+#include <stdio.h>
+#include <time.h>
+#include "hash.h"
+
+int main(void)
+{
+	const size_t lookups = 10000000;
+	for (size_t keys = 1000; keys <= 1000000; keys *= 10)
+	{
+		hash hs = hash_create(0);
+
+		clock_t begin = clock();
+		for (size_t i = 0; i < keys; i++)
+		{
+			hash_set_by_index(&hs, hash_add(&hs, (item_t)(i * 7), 1), 0, (item_t)i);
+		}
+		const double insert = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+		size_t found = 0;
+		begin = clock();
+		for (size_t i = 0; i < lookups; i++)
+		{
+			found += hash_get(&hs, (item_t)((i * 2654435761u) % keys * 7), 0) != ITEM_MAX;
+		}
+		const double lookup = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+		printf("%8zu keys: insert %6.1f ns/key, lookup %6.1f ns/key, found %zu\n"
+			, keys, insert * 1e9 / keys, lookup * 1e9 / lookups, found);
+		hash_clear(&hs);
+	}
+
+	return 0;
+}
+EOF
+
+	if ! cc -O2 -I../libs/utils $dir_bench/hash.c -L. -lutils -Wl,-rpath,`pwd` -o $dir_bench/hash ; then
+		exit 1
+	fi
+
+	$dir_bench/hash
+}
+
+measure()
+{
+	local begin=`date +%s%N`
+	if ! ./ruc $@ > /dev/null ; then
+		echo "Failed: ruc $@"
+		exit 1
+	fi
+	local end=`date +%s%N`
+
+	local elapsed=$(( (end - begin) / 1000000 ))
+	printf "%s: %d.%03d s\n" "${1##*/}" $(( elapsed / 1000 )) $(( elapsed % 1000 ))
+}
+
+bench_tree()
+{
+	local size=1000000
+
+	echo "int main()" > $dir_bench/block.c
+	echo "{" >> $dir_bench/block.c
+	echo "	int a = 0;" >> $dir_bench/block.c
+	for (( i = 0; i < size; i++ ))
+	do
+		echo "	a = a + 1;"
+	done >> $dir_bench/block.c
+	echo "	return a;" >> $dir_bench/block.c
+	echo "}" >> $dir_bench/block.c
+
+	echo "int main()" > $dir_bench/initializer.c
+	echo "{" >> $dir_bench/initializer.c
+	echo "	int array[$size] = { `seq -s ', ' 1 $size` };" >> $dir_bench/initializer.c
+	echo "	return array[0];" >> $dir_bench/initializer.c
+	echo "}" >> $dir_bench/initializer.c
+
+	measure $dir_bench/block.c -o $dir_bench/block.ruc -VM
+	measure $dir_bench/initializer.c -o $dir_bench/initializer.ruc -VM
+}
+
+bench_lexer()
+{
+	local size=200000
+
+	for (( i = 0; i < size; i++ ))
+	do
+		echo "	value_$i = $i + 3.5 * (array[$i] - 'c'); print(\"line $i\\n\"); // comment"
+	done > $dir_bench/lexer.c
+
+	cat > $dir_bench/lexer_main.c << EOF
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "lexer.h"
+
+static double run(const char *const path, const size_t lookahead, size_t *const tokens)
+{
+	universal_io io = io_create();
+	in_set_file(&io, path);
+
+	workspace ws = ws_create();
+	syntax sx = sx_create(&ws, &io, NULL);
+	lexer lxr = lexer_create(&sx);
+
+	*tokens = 0;
+	const clock_t begin = clock();
+	if (lookahead == SIZE_MAX)
+	{
+		lexer_tokenize(&lxr);
+		*tokens = lxr.stream.size - 1;
+	}
+	else
+	{
+		for (token tk = lex(&lxr); token_get_kind(&tk) != TK_EOF; tk = lex(&lxr))
+		{
+			for (size_t n = 1; n <= lookahead; n++)
+			{
+				peek_nth(&lxr, n);
+			}
+			(*tokens)++;
+		}
+	}
+	const double elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	lexer_clear(&lxr);
+	sx_clear(&sx);
+	ws_clear(&ws);
+	io_erase(&io);
+	return elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+	for (size_t lookahead = 0; lookahead <= LEXER_LOOKAHEAD; lookahead += 2)
+	{
+		size_t tokens;
+		const double elapsed = run(argv[argc - 1], lookahead, &tokens);
+		printf("peek %zu ahead: %zu tokens, %6.2f Mtokens/s\n", lookahead, tokens, tokens / elapsed / 1e6);
+	}
+
+	size_t tokens;
+	const double elapsed = run(argv[argc - 1], SIZE_MAX, &tokens);
+	printf("whole input: %zu tokens, %6.2f Mtokens/s\n", tokens, tokens / elapsed / 1e6);
+
+	return 0;
+}
+EOF
+
+	if ! cc -O2 -I../libs/utils -I../libs/compiler $dir_bench/lexer_main.c -L. -lcompiler -lutils -Wl,-rpath,`pwd` \
+		-o $dir_bench/lexer ; then
+		exit 1
+	fi
+
+	$dir_bench/lexer $dir_bench/lexer.c
+}
+
+bench_float()
+{
+	local size=1000000
+
+	echo "int main()" > $dir_bench/float.c
+	echo "{" >> $dir_bench/float.c
+	echo "	double array[$size] = {" >> $dir_bench/float.c
+	awk -v size=$size 'BEGIN { for (i = 1; i <= size; i++) printf "%s\t\t%.17g", (i > 1 ? ",\n" : ""), i * 1.2345678901234567 / 7 }' \
+		>> $dir_bench/float.c
+	echo -e "\n\t};" >> $dir_bench/float.c
+	echo "	return 0;" >> $dir_bench/float.c
+	echo "}" >> $dir_bench/float.c
+
+	measure $dir_bench/float.c -o $dir_bench/float.ruc -VM
+}
+
+bench_macro()
+{
+	local size=20000
+	local lines=100000
+
+	for (( i = 0; i < size; i++ ))
+	do
+		echo "#define MACRO_$i $i"
+	done > $dir_bench/macro.c
+	for (( i = 0; i < lines; i++ ))
+	do
+		echo "	a = MACRO_$(( i % size )) + MACRO_$(( i * 7 % size )) - value_$(( i % 13 ));"
+	done >> $dir_bench/macro.c
+
+	for (( i = 0; i < lines * 10; i++ ))
+	do
+		echo "	value_$(( i % 13 )) = array[$i] * 3 - (value_$(( i % 7 )) + 0x$i);"
+	done > $dir_bench/text.c
+	echo "#define UNUSED 0" | cat - $dir_bench/text.c > $dir_bench/defined.c
+
+	for (( i = 0; i < size; i++ ))
+	do
+		echo "#ifdef CONFIG_$i"
+		for (( j = 0; j < 8; j++ ))
+		do
+			echo "	int config_${i}_$j = $j; /* $i */ // comment"
+		done
+		echo "#endif"
+	done > $dir_bench/config.c
+
+	cat > $dir_bench/loop.c << EOF
+#define i 0
+#define j 0
+#while i < $size
+	int value_#eval(i) = offset + base * 3; /* element of table */
+#set j 0
+#while j < 10
+	array[index + 7] = value + step * 3 - table[index + 1]; // row
+#set j #eval(j + 1)
+#endw
+#set i #eval(i + 1)
+#endw
+EOF
+
+	local headers=100
+
+	mkdir -p $dir_bench/include/first $dir_bench/include/second $dir_bench/include/third $dir_bench/include/headers
+	for (( i = 0; i < headers; i++ ))
+	do
+		for (( j = 0; j < i; j++ ))
+		do
+			echo "#include \"header_$j.h\""
+			echo
+		done > $dir_bench/include/headers/header_$i.h
+		echo "int header_$i;" >> $dir_bench/include/headers/header_$i.h
+
+		echo "#include \"header_$i.h\""
+		echo
+	done > $dir_bench/include.c
+	echo "int main() { return 0; }" >> $dir_bench/include.c
+
+	cat > $dir_bench/macro_main.c << EOF
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "preprocessor.h"
+
+int main(int argc, char *argv[])
+{
+	const clock_t begin = clock();
+	char *const output = auto_macro(argc, (const char *const *)argv);
+	const double elapsed = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	if (output == NULL)
+	{
+		return 1;
+	}
+
+	printf("%s: %.3f s\n", argv[argc - 1], elapsed);
+	free(output);
+	return 0;
+}
+EOF
+
+	if ! cc -O2 -I../libs/utils -I../libs/preprocessor $dir_bench/macro_main.c -L. -lpreprocessor -lutils -lm \
+		-Wl,-rpath,`pwd` -o $dir_bench/macro ; then
+		exit 1
+	fi
+
+	$dir_bench/macro $dir_bench/macro.c
+	$dir_bench/macro $dir_bench/text.c
+	$dir_bench/macro $dir_bench/defined.c
+	$dir_bench/macro $dir_bench/config.c
+	$dir_bench/macro $dir_bench/loop.c
+	$dir_bench/macro -I$dir_bench/include/first -I$dir_bench/include/second -I$dir_bench/include/third \
+		-I$dir_bench/include/headers $dir_bench/include.c
+}
+
+bench_compile()
+{
+	local size=20000
+	local functions=4000
+	local lines=50
+
+	for (( i = 0; i < size; i++ ))
+	do
+		echo "#define MACRO_$i $i"
+	done > $dir_bench/compile.c
+	for (( i = 0; i < functions; i++ ))
+	do
+		echo "int function_$i(int a)"
+		echo "{"
+		for (( j = 0; j < lines; j++ ))
+		do
+			local k=$(( i * lines + j ))
+			echo "	a = MACRO_$(( k % size )) + MACRO_$(( k * 7 % size )) - $(( k % 13 )); // comment"
+		done
+		echo "	return a;"
+		echo "}"
+	done >> $dir_bench/compile.c
+	echo "int main() { return 0; }" >> $dir_bench/compile.c
+
+	local files=8
+
+	mkdir -p $dir_bench/units
+	for (( i = 0; i < files; i++ ))
+	do
+		for (( j = 0; j < size / files; j++ ))
+		do
+			echo "#define UNIT_${i}_$j $j"
+		done > $dir_bench/units/unit_$i.c
+		for (( j = 0; j < functions / files; j++ ))
+		do
+			echo "int unit_${i}_$j(int a)"
+			echo "{"
+			for (( k = 0; k < lines; k++ ))
+			do
+				echo "	a = UNIT_${i}_$(( (j * lines + k) % (size / files) )) + a * $k; // comment"
+			done
+			echo "	return a;"
+			echo "}"
+		done >> $dir_bench/units/unit_$i.c
+	done
+	echo "int main() { return 0; }" >> $dir_bench/units/unit_0.c
+
+	echo -n "sequential "
+	measure $dir_bench/units/unit_*.c -o $dir_bench/units.ruc -VM
+	echo -n "parallel "
+	measure $dir_bench/units/unit_*.c -o $dir_bench/units.ruc -VM --parallel-macro
+
+	rm -rf $dir_bench/cache
+	echo -n "cold cache "
+	measure $dir_bench/compile.c -o $dir_bench/compile.ruc -VM --macro-cache=$dir_bench/cache
+	echo -n "warm cache "
+	measure $dir_bench/compile.c -o $dir_bench/compile.ruc -VM --macro-cache=$dir_bench/cache
+
+	echo -n "sequential "
+	measure $dir_bench/compile.c -o $dir_bench/compile.ruc -VM
+	echo -n "concurrent "
+	measure $dir_bench/compile.c -o $dir_bench/compile.ruc -VM -pipe
+}
+
+main()
+{
+	init $@
+	build
+
+	for benchmark in $benchmarks
+	do
+		echo "== $benchmark"
+		bench_$benchmark
+	done
+}
+
+main $@
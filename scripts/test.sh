@@ -18,6 +18,10 @@ init()
 	dir_multiple_errors=../tests/multiple_errors
 	dir_unsorted=../tests/unsorted
 	dir_exec=../tests/codegen/executable
+	dir_cache=cache
+
+	# Кэш проверяется дважды: первый запуск создает запись, второй ее читает
+	modes="--parallel-macro -pipe --pretokenize --macro-cache=$dir_cache --macro-cache=$dir_cache"
 
 	subdir_error=errors
 	subdir_warning=warnings
@@ -39,7 +43,8 @@ init()
 				echo -e "\tExecutable tests should be in \"$dir_exec\" directory."
 				echo -e "\tTo ignore invalid tests output, use \"*/$subdir_warning/*\" subdirectory."
 				echo -e "\tFor tests with expected runtime error, use \"*/$subdir_error/*\" subdirectory."
-				echo -e "\tFor multi-file tests, use \"*/$subdir_include/*\" subdirectory."
+				echo -e "\tFor multi-file tests, use \"*/$subdir_include/*\" subdirectory, files are passed in sorted order."
+				echo -e "\tEach test is also compiled with \"$modes\" keys and compared with default mode."
 				echo -e "\tFailed tests for debug build only will be marked with \"(Debug)\"."
 				echo -e "Keys:"
 				echo -e "\t-h, --help\tTo output help info."
@@ -97,6 +102,8 @@ init()
 
 	log=tmp
 	buf=buf
+	mode_exec=mode.txt
+	mode_log=mode
 }
 
 build_folder()
@@ -446,6 +453,33 @@ compiling()
 	fi
 }
 
+compare_modes()
+{
+	$runner $compiler $sources -o $vm_exec -VM &>$log
+	expected=$?
+
+	for mode in $modes
+	do
+		action="compiling $mode"
+		rm -f $mode_exec
+
+		$runner $compiler $sources $mode -o $mode_exec -VM &>$mode_log
+		if [[ $? == $expected ]] && cmp -s $log $mode_log && ( ! [[ -f $vm_exec ]] || cmp -s $vm_exec $mode_exec ) ; then
+			message_success
+			let success++
+		else
+			message_failure
+			let failure++
+
+			if ! [[ -z $debug ]] ; then
+				diff $log $mode_log
+			fi
+		fi
+	done
+
+	rm -f $vm_exec $mode_exec $mode_log
+}
+
 test()
 {
 	# Do not use names with spaces!
@@ -455,6 +489,7 @@ test()
 
 		if [[ $path != */$subdir_include/* ]] ; then
 			compiling
+			compare_modes
 		fi
 	done
 
@@ -462,7 +497,7 @@ test()
 	do
 		for path in `ls -d $include/*`
 		do
-			sources=`find $path -name *.c`
+			sources=`find $path -name *.c | sort`
 
 			for subdir in `find $path -name *.h`
 			do
@@ -471,6 +506,7 @@ test()
 			done
 
 			compiling
+			compare_modes
 		done
 	done
 
@@ -481,6 +517,7 @@ test()
 	echo -e "\x1B[1;39m success = $success, warning = $warning, failure = $failure, timeout = $timeout"
 	rm -f $log
 	rm -f $buf
+	rm -rf $dir_cache
 }
 
 main()
@@ -0,0 +1,45 @@
+int main()
+{
+	double min_subnormal = 1.0;
+	double epsilon = 1.0;
+	int i;
+
+	for (i = 0; i < 1074; i++)
+	{
+		min_subnormal = min_subnormal / 2;
+	}
+
+	for (i = 0; i < 52; i++)
+	{
+		epsilon = epsilon / 2;
+	}
+
+	// Halfway cases round to even
+	assert(9007199254740993.0 == 9007199254740992.0, "2^53 + 1 must round to 2^53");
+	assert(9007199254740995.0 == 9007199254740996.0, "2^53 + 3 must round to 2^53 + 4");
+	assert(1.00000000000000011102230246251565404236316680908203125 == 1.0
+		, "1 + 2^-53 must round to 1");
+	assert(1.00000000000000011102230246251565404236316680908203126 == 1.0 + epsilon
+		, "value above 1 + 2^-53 must round to 1 + 2^-52");
+
+	// Mantissas with 17 and more digits
+	assert(0.1 == 1.0 / 10.0, "0.1 must be the nearest double");
+	assert(0.30000000000000000000000000001 == 3.0 / 10.0, "long 0.3 must be the nearest double");
+	assert(1e23 == 1e22 * 10.0, "1e23 must be the nearest double");
+	assert(8.98846567431157953864652595394512366e307 == 8.98846567431158e307, "2^1023 must be exact");
+	assert(1.23456789012345678901234567890e29 == 1.2345678901234568e29, "long mantissa must round");
+	assert(1234567890123456789.0 == 1234567890123456768.0, "19-digit mantissa must round");
+	assert(1.7976931348623158e308 == 1.7976931348623157e308, "must round to max double");
+	assert(9007199254740993.000000000001 == 9007199254740994.0, "value above 2^53 + 1 must round up");
+
+	// Subnormal numbers
+	assert(4.9406564584124654e-324 == min_subnormal, "min subnormal must be exact");
+	assert(5e-324 == min_subnormal, "5e-324 must round to min subnormal");
+	assert(2.4703282292062328e-324 == min_subnormal, "value above half must round to min subnormal");
+	assert(2.4703282292062327e-324 == 0.0, "value below half must round to zero");
+	assert(2.2250738585072011e-308 == 2.2250738585072014e-308 - min_subnormal
+		, "must round to max subnormal");
+	assert(2.2250738585072012e-308 == 2.2250738585072014e-308, "must round to min normal");
+
+	return 0;
+}
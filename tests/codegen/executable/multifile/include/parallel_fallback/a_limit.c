@@ -0,0 +1,9 @@
+// Macro of the first file is used by the second one, so parallel preprocessing falls back to sequential one
+
+#define LIMIT 10
+
+
+int limit()
+{
+	return LIMIT;
+}
@@ -0,0 +1,7 @@
+void main()
+{
+	int values[LIMIT];
+	values[LIMIT - 1] = limit();
+
+	assert(values[LIMIT - 1] == 10, "macro of previous file must be visible");
+}
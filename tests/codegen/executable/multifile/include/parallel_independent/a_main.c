@@ -0,0 +1,11 @@
+// Files share neither headers nor macros, so they are preprocessed in parallel
+
+int first(int);
+int second(int);
+
+
+void main()
+{
+	assert(first(3) == 7, "first(3) must be 7");
+	assert(second(3) == 30, "second(3) must be 30");
+}
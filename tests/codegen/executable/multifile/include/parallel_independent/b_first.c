@@ -0,0 +1,7 @@
+#include "first.h"
+
+
+int first(int value)
+{
+	return value * FIRST_SCALE + FIRST_SHIFT;
+}
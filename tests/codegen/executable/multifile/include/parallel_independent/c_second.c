@@ -0,0 +1,7 @@
+#define SECOND_SCALE 10
+
+
+int second(int value)
+{
+	return value * SECOND_SCALE;
+}
@@ -0,0 +1,2 @@
+#define FIRST_SCALE 2
+#define FIRST_SHIFT 1
@@ -0,0 +1,10 @@
+#if 3000000000 > 2147483647 && 4294967296 >= 4294967295
+	#define OVER_INT #eval(3000000000 - 2999999999)
+#else
+	#define OVER_INT 0
+#endif
+
+void main()
+{
+	assert(OVER_INT == 1, "fail1");
+}
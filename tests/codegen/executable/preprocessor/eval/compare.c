@@ -0,0 +1,19 @@
+#define A 5
+
+#if A <= 5 && A >= 5 && 4 <= A && 6 >= A
+	#define BOTH 1
+#else
+	#define BOTH 0
+#endif
+
+#if A <= 4 || A >= 6
+	#define NONE 1
+#else
+	#define NONE 0
+#endif
+
+void main()
+{
+	assert(BOTH == 1, "fail1");
+	assert(NONE == 0, "fail2");
+}
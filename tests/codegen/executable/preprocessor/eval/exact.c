@@ -0,0 +1,12 @@
+#define BIG 9007199254740993
+
+#define DIFFERENCE #eval(BIG - 9007199254740990)
+#define QUOTIENT #eval(BIG / 3)
+#define REMAINDER #eval(BIG % 1000)
+
+void main()
+{
+	assert(DIFFERENCE == 3, "fail1");
+	assert(QUOTIENT - 3002399751580000 == 331, "fail2");
+	assert(REMAINDER == 993, "fail3");
+}
@@ -0,0 +1,7 @@
+#define ZERO 0
+#define s #eval(1 / ZERO)
+
+int main()
+{
+	return s;
+}
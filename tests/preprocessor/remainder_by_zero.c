@@ -0,0 +1,6 @@
+#define s #eval(10 % (2 - 2))
+
+int main()
+{
+	return s;
+}